@@ -0,0 +1,656 @@
+//! \file eggs/variant/algorithm.hpp
+// Eggs.Variant
+//
+// Copyright Agustin K-ballo Berge, Fusion Fenix 2014-2018
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef EGGS_VARIANT_ALGORITHM_HPP
+#define EGGS_VARIANT_ALGORITHM_HPP
+
+#include "detail/pack.hpp"
+#include "detail/utility.hpp"
+
+#include "variant.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+#include "detail/config/prefix.hpp"
+
+namespace eggs { namespace variants
+{
+    namespace detail
+    {
+        ///////////////////////////////////////////////////////////////////////
+        template <typename Iterator>
+        struct iterator_variant
+          : std::remove_reference<
+                typename std::iterator_traits<Iterator>::reference>
+        {};
+
+        template <typename Iterator>
+        struct iterator_variant_size
+          : variant_size<typename std::remove_cv<
+                typename iterator_variant<Iterator>::type>::type>
+        {};
+
+        template <typename Iterator>
+        struct is_random_access_iterator
+          : std::is_base_of<
+                std::random_access_iterator_tag
+              , typename std::iterator_traits<Iterator>::iterator_category
+            >
+        {};
+
+        // the internal discriminator of the element, `0` for no active member
+        template <typename Iterator>
+        EGGS_CXX11_CONSTEXPR std::size_t which_of(Iterator const& it)
+        {
+            return detail::access::storage(*it).which();
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        inline int countr_zero(std::uint64_t mask) noexcept
+        {
+#if defined(__GNUC__)
+            return __builtin_ctzll(mask);
+#else
+            int n = 0;
+            for (; (mask & 1u) == 0; mask >>= 1)
+                ++n;
+            return n;
+#endif
+        }
+
+        template <
+            std::size_t Which, typename Iterator
+          , bool RandomAccess = is_random_access_iterator<Iterator>::value
+        >
+        struct filter_cursor;
+
+        template <std::size_t Which, typename Iterator>
+        struct filter_cursor<Which, Iterator, false>
+        {
+            filter_cursor(Iterator first, Iterator last)
+              : _it(first), _last(last)
+            {
+                _satisfy();
+            }
+
+            Iterator const& base() const noexcept
+            {
+                return _it;
+            }
+
+            void next()
+            {
+                ++_it;
+                _satisfy();
+            }
+
+        private:
+            void _satisfy()
+            {
+                while (_it != _last && detail::which_of(_it) != Which)
+                    ++_it;
+            }
+
+            Iterator _it;
+            Iterator _last;
+        };
+
+        // Discriminators are compared a block at a time into a bit mask, so
+        // that the scan itself is free of data-dependent branches and only
+        // the positions of matching elements are visited.
+        template <std::size_t Which, typename Iterator>
+        struct filter_cursor<Which, Iterator, true>
+        {
+            using difference_type =
+                typename std::iterator_traits<Iterator>::difference_type;
+
+            EGGS_CXX11_STATIC_CONSTEXPR difference_type block_size = 64;
+
+            filter_cursor(Iterator first, Iterator last)
+              : _it(first), _block(first), _last(last), _mask(0)
+            {
+                _scan();
+            }
+
+            Iterator const& base() const noexcept
+            {
+                return _it;
+            }
+
+            void next()
+            {
+                _mask &= _mask - 1u;
+                if (_mask != 0)
+                {
+                    _it = _block + detail::countr_zero(_mask);
+                } else {
+                    _block += _block_length();
+                    _scan();
+                }
+            }
+
+        private:
+            difference_type _block_length() const
+            {
+                return _last - _block < block_size
+                  ? _last - _block : block_size;
+            }
+
+            void _scan()
+            {
+                for (; _block != _last; _block += _block_length())
+                {
+                    difference_type const n = _block_length();
+                    std::uint64_t mask = 0;
+                    for (difference_type i = 0; i < n; ++i)
+                    {
+                        mask |= std::uint64_t(
+                            detail::which_of(_block + i) == Which) << i;
+                    }
+
+                    if (mask != 0)
+                    {
+                        _mask = mask;
+                        _it = _block + detail::countr_zero(_mask);
+                        return;
+                    }
+                }
+                _mask = 0;
+                _it = _last;
+            }
+
+            Iterator _it;
+            Iterator _block;
+            Iterator _last;
+            std::uint64_t _mask;
+        };
+
+        template <std::size_t Which, typename Iterator>
+        typename filter_cursor<Which, Iterator, true>::difference_type const
+            filter_cursor<Which, Iterator, true>::block_size;
+
+        ///////////////////////////////////////////////////////////////////////
+        template <std::size_t N, typename Iterator>
+        std::array<std::size_t, N + 1> which_histogram(
+            Iterator first, Iterator last
+          , /*is_random_access_iterator=*/std::false_type)
+        {
+            std::array<std::size_t, N + 1> counts = {};
+            for (; first != last; ++first)
+                ++counts[detail::which_of(first)];
+            return counts;
+        }
+
+        // Spreading the increments over several partial histograms breaks the
+        // dependency chain between consecutive elements of the same kind.
+        template <std::size_t N, typename Iterator>
+        std::array<std::size_t, N + 1> which_histogram(
+            Iterator first, Iterator last
+          , /*is_random_access_iterator=*/std::true_type)
+        {
+            using difference_type =
+                typename std::iterator_traits<Iterator>::difference_type;
+
+            std::array<std::size_t, N + 1> partial[4] = {};
+            difference_type const n = last - first;
+            difference_type i = 0;
+            for (; i + 4 <= n; i += 4)
+            {
+                ++partial[0][detail::which_of(first + i)];
+                ++partial[1][detail::which_of(first + (i + 1))];
+                ++partial[2][detail::which_of(first + (i + 2))];
+                ++partial[3][detail::which_of(first + (i + 3))];
+            }
+            for (; i < n; ++i)
+                ++partial[0][detail::which_of(first + i)];
+
+            for (std::size_t b = 0; b < N + 1; ++b)
+                partial[0][b] += partial[1][b] + partial[2][b] + partial[3][b];
+            return partial[0];
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // alternatives are looked up by the type they are accessed as, so
+        // that `boxed<T>` is found as `T`
+        template <typename T, typename V>
+        struct _filter_index;
+
+        template <typename T, typename ...Ts>
+        struct _filter_index<T, variant<Ts...>>
+          : checked_index_of<T, unboxed_pack<Ts...>>
+        {};
+
+        template <typename T, typename ...Ts>
+        struct _filter_index<T, variant<Ts...> const>
+          : checked_index_of<T, unboxed_pack<Ts...>>
+        {};
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    //! template <class Iterator>
+    //! class subrange;
+    //!
+    //! A `subrange` denotes the range of elements `[begin(), end())`.
+    template <typename Iterator>
+    class subrange
+    {
+    public:
+        //! using iterator = Iterator;
+        using iterator = Iterator;
+
+    public:
+        //! subrange(Iterator first, Iterator last);
+        //!
+        //! \effects Initializes the subrange to denote `[first, last)`.
+        subrange(Iterator first, Iterator last)
+          : _first(first), _last(last)
+        {}
+
+        //! Iterator begin() const;
+        Iterator begin() const
+        {
+            return _first;
+        }
+
+        //! Iterator end() const;
+        Iterator end() const
+        {
+            return _last;
+        }
+
+        //! bool empty() const;
+        //!
+        //! \returns `begin() == end()`.
+        bool empty() const
+        {
+            return _first == _last;
+        }
+
+        //! std::size_t size() const;
+        //!
+        //! \returns `std::distance(begin(), end())`.
+        std::size_t size() const
+        {
+            return static_cast<std::size_t>(std::distance(_first, _last));
+        }
+
+    private:
+        Iterator _first;
+        Iterator _last;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    //! template <class Iterator, std::size_t N>
+    //! class which_partition;
+    //!
+    //! A `which_partition` holds the boundaries of a range of variants that
+    //! has been grouped by the index of their active member, as computed by
+    //! `partition_by_which`.
+    template <typename Iterator, std::size_t N>
+    class which_partition
+    {
+    public:
+        //! which_partition(std::array<Iterator, N + 2> const& bounds);
+        //!
+        //! \requires `bounds[0]` is the start of the elements with no active
+        //!  member, and `bounds[I + 1]` is the start of the elements with an
+        //!  active member at index `I`; `bounds[N + 1]` is the end of the
+        //!  partitioned range.
+        explicit which_partition(std::array<Iterator, N + 2> const& bounds)
+          : _bounds(bounds)
+        {}
+
+        //! subrange<Iterator> operator[](std::size_t which) const;
+        //!
+        //! \requires `which < N || which == variant_npos`.
+        //!
+        //! \returns The subrange of elements `v` for which `v.which() ==
+        //!  which`.
+        subrange<Iterator> operator[](std::size_t which) const
+        {
+            // `variant_npos + 1` wraps to the bucket of empty elements
+            return subrange<Iterator>(
+                _bounds[which + 1], _bounds[which + 2]);
+        }
+
+        //! Iterator begin() const;
+        //!
+        //! \returns An iterator to the start of the partitioned range.
+        Iterator begin() const
+        {
+            return _bounds[0];
+        }
+
+        //! Iterator end() const;
+        //!
+        //! \returns An iterator to the end of the partitioned range.
+        Iterator end() const
+        {
+            return _bounds[N + 1];
+        }
+
+    private:
+        std::array<Iterator, N + 2> _bounds;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    //! template <class ForwardIt>
+    //! which_partition<ForwardIt, N> partition_by_which(ForwardIt first, ForwardIt last);
+    //!
+    //! Let `N` be `variant_size_v<V>`, where `V` is the cv-unqualified value
+    //!  type of `ForwardIt`.
+    //!
+    //! \requires `V` shall be a specialization of `variant`. `ForwardIt`
+    //!  shall satisfy the requirements of `ValueSwappable`.
+    //!
+    //! \effects Reorders the elements in `[first, last)` so that all the
+    //!  elements with no active member precede all the elements with an
+    //!  active member, which in turn are ordered by the index of their
+    //!  active member. The relative order of the elements within each
+    //!  group is not preserved.
+    //!
+    //! \returns A `which_partition` denoting the resulting groups.
+    //!
+    //! \complexity At most `last - first` swaps, and `2 * (last - first)`
+    //!  calls to `which()` plus one per swap, thus at most `3 * (last -
+    //!  first)`.
+    template <
+        typename ForwardIt
+      , std::size_t N = detail::iterator_variant_size<ForwardIt>::value
+    >
+    which_partition<ForwardIt, N> partition_by_which(
+        ForwardIt first, ForwardIt last)
+    {
+        std::array<std::size_t, N + 1> counts = {};
+        for (ForwardIt it = first; it != last; ++it)
+            ++counts[detail::which_of(it)];
+
+        std::array<ForwardIt, N + 2> bounds;
+        bounds[0] = first;
+        for (std::size_t b = 0; b < N + 1; ++b)
+        {
+            bounds[b + 1] = std::next(bounds[b],
+                static_cast<typename std::iterator_traits<
+                    ForwardIt>::difference_type>(counts[b]));
+        }
+
+        // every element visited is either in place or swapped into the next
+        // free slot of its own group, whose previous occupant is visited next
+        std::array<ForwardIt, N + 1> heads;
+        for (std::size_t b = 0; b < N + 1; ++b)
+            heads[b] = bounds[b];
+        for (std::size_t b = 0; b < N + 1; ++b)
+        {
+            ForwardIt& it = heads[b];
+            while (it != bounds[b + 1])
+            {
+                std::size_t const w = detail::which_of(it);
+                if (w == b)
+                {
+                    ++it;
+                } else {
+                    using std::swap;
+                    swap(*it, *heads[w]);
+                    ++heads[w];
+                }
+            }
+        }
+
+        return which_partition<ForwardIt, N>(bounds);
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    //! template <class T, class Iterator>
+    //! class filter_type_view;
+    //!
+    //! A `filter_type_view` is a lazy view of the active members of type `T`
+    //! of the variants in a range, in the order in which they occur.
+    template <typename T, typename Iterator>
+    class filter_type_view
+    {
+        using _variant = typename detail::iterator_variant<Iterator>::type;
+
+        EGGS_CXX11_STATIC_CONSTEXPR std::size_t _index =
+            detail::_filter_index<T, _variant>::value;
+
+        using _cursor = detail::filter_cursor<_index + 1, Iterator>;
+
+    public:
+        //! class iterator;
+        //!
+        //! A `ForwardIterator` whose `reference` is `T&`, or `T const&` if
+        //!  the variants in the range are `const`.
+        class iterator
+        {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = T;
+            using difference_type =
+                typename std::iterator_traits<Iterator>::difference_type;
+            using reference = typename std::conditional<
+                std::is_const<_variant>::value, T const&, T&>::type;
+            using pointer = typename std::remove_reference<reference>::type*;
+
+        public:
+            explicit iterator(_cursor const& cursor)
+              : _cursor_(cursor)
+            {}
+
+            //! Iterator const& base() const noexcept;
+            //!
+            //! \returns An iterator to the variant holding the current
+            //!  element.
+            Iterator const& base() const noexcept
+            {
+                return _cursor_.base();
+            }
+
+            reference operator*() const
+            {
+                return detail::access::get(
+                    *_cursor_.base(), detail::index<_index>{});
+            }
+
+            pointer operator->() const
+            {
+                return detail::addressof(**this);
+            }
+
+            iterator& operator++()
+            {
+                _cursor_.next();
+                return *this;
+            }
+
+            iterator operator++(int)
+            {
+                iterator tmp(*this);
+                _cursor_.next();
+                return tmp;
+            }
+
+            friend bool operator==(iterator const& lhs, iterator const& rhs)
+            {
+                return lhs.base() == rhs.base();
+            }
+
+            friend bool operator!=(iterator const& lhs, iterator const& rhs)
+            {
+                return lhs.base() != rhs.base();
+            }
+
+        private:
+            _cursor _cursor_;
+        };
+
+    public:
+        //! filter_type_view(Iterator first, Iterator last);
+        //!
+        //! \effects Initializes the view over the range `[first, last)`.
+        filter_type_view(Iterator first, Iterator last)
+          : _first(first), _last(last)
+        {}
+
+        //! iterator begin() const;
+        //!
+        //! \returns An iterator to the first active member of type `T`.
+        //!
+        //! \complexity Linear in the distance to the first active member
+        //!  of type `T`.
+        iterator begin() const
+        {
+            return iterator(_cursor(_first, _last));
+        }
+
+        //! iterator end() const;
+        iterator end() const
+        {
+            return iterator(_cursor(_last, _last));
+        }
+
+    private:
+        Iterator _first;
+        Iterator _last;
+    };
+
+    //! template <class T, class Range>
+    //! filter_type_view<T, I> filter_type(Range& range);
+    //!
+    //! Let `I` be the type of `std::begin(range)`.
+    //!
+    //! \requires The cv-unqualified value type of `I` shall be a
+    //!  specialization of `variant` in whose alternatives `T` occurs exactly
+    //!  once, where an alternative of type `boxed<T>` or `recursive<T>`
+    //!  counts as `T`.
+    //!
+    //! \returns `filter_type_view<T, I>(std::begin(range), std::end(range))`.
+    template <
+        typename T, typename Range
+      , typename Iterator = decltype(std::begin(std::declval<Range&>()))
+    >
+    filter_type_view<T, Iterator> filter_type(Range& range)
+    {
+        return filter_type_view<T, Iterator>(
+            std::begin(range), std::end(range));
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    //! template <class T, class Range>
+    //! std::size_t count_by_type(Range const& range);
+    //!
+    //! \requires The cv-unqualified value type of `range` shall be a
+    //!  specialization of `variant` in whose alternatives `T` occurs exactly
+    //!  once, where an alternative of type `boxed<T>` or `recursive<T>`
+    //!  counts as `T`.
+    //!
+    //! \returns The number of elements in `range` that have an active member
+    //!  of type `T`.
+    //!
+    //! \remarks The discriminators are accumulated without branching, which
+    //!  allows the loop to be vectorized using strided loads for contiguous
+    //!  ranges.
+    template <
+        typename T, typename Range
+      , typename Iterator = decltype(std::begin(std::declval<Range const&>()))
+      , std::size_t I = detail::_filter_index<
+            T, typename detail::iterator_variant<Iterator>::type>::value
+    >
+    std::size_t count_by_type(Range const& range)
+    {
+        std::size_t count = 0;
+        for (Iterator it = std::begin(range), last = std::end(range);
+                it != last; ++it)
+        {
+            count += std::size_t(detail::which_of(it) == I + 1);
+        }
+        return count;
+    }
+
+    //! template <class Range>
+    //! std::array<std::size_t, N> which_histogram(Range const& range);
+    //!
+    //! Let `N` be `variant_size_v<V>`, where `V` is the cv-unqualified value
+    //!  type of `range`.
+    //!
+    //! \requires `V` shall be a specialization of `variant`.
+    //!
+    //! \returns An array `counts` such that `counts[I]` is the number of
+    //!  elements in `range` that have an active member at index `I`.
+    //!  Elements with no active member are not counted.
+    template <
+        typename Range
+      , typename Iterator = decltype(std::begin(std::declval<Range const&>()))
+      , std::size_t N = detail::iterator_variant_size<Iterator>::value
+    >
+    std::array<std::size_t, N> which_histogram(Range const& range)
+    {
+        std::array<std::size_t, N + 1> const counts =
+            detail::which_histogram<N>(std::begin(range), std::end(range),
+                detail::is_random_access_iterator<Iterator>{});
+
+        std::array<std::size_t, N> result;
+        for (std::size_t i = 0; i < N; ++i)
+            result[i] = counts[i + 1];
+        return result;
+    }
+
+    //! template <std::size_t N, class T>
+    //! std::array<std::size_t, N> which_histogram(T const* first, T const* last);
+    //!
+    //! Histogram over discriminators stored contiguously, separate from the
+    //!  values they describe.
+    //!
+    //! \requires `T` shall be an integral type.
+    //!
+    //! \returns An array `counts` such that `counts[I]` is the number of
+    //!  elements in `[first, last)` equal to `I`. Elements that are not less
+    //!  than `N`, such as a marker for no active member, are not counted.
+    //!
+    //! \remarks For a small `N`, each count is computed by a separate pass of
+    //!  comparisons, which allows the loop to be vectorized.
+    template <
+        std::size_t N, typename T
+      , typename Enable = typename std::enable_if<
+            std::is_integral<T>::value>::type
+    >
+    std::array<std::size_t, N> which_histogram(T const* first, T const* last)
+    {
+        std::size_t const n = static_cast<std::size_t>(last - first);
+        std::array<std::size_t, N> result = {};
+        if (N <= 16)
+        {
+            for (std::size_t i = 0; i < N; ++i)
+            {
+                T const tag = static_cast<T>(i);
+                std::size_t count = 0;
+                for (std::size_t j = 0; j < n; ++j)
+                    count += std::size_t(first[j] == tag);
+                result[i] = count;
+            }
+        } else {
+            std::array<std::size_t, N + 1> counts = {};
+            for (std::size_t j = 0; j < n; ++j)
+            {
+                std::size_t const tag = static_cast<std::size_t>(first[j]);
+                ++counts[tag < N ? tag : N];
+            }
+            for (std::size_t i = 0; i < N; ++i)
+                result[i] = counts[i];
+        }
+        return result;
+    }
+}}
+
+#include "detail/config/suffix.hpp"
+
+#endif /*EGGS_VARIANT_ALGORITHM_HPP*/
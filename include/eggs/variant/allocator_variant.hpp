@@ -0,0 +1,441 @@
+//! \file eggs/variant/allocator_variant.hpp
+// Eggs.Variant
+//
+// Copyright Agustin K-ballo Berge, Fusion Fenix 2014-2018
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef EGGS_VARIANT_ALLOCATOR_VARIANT_HPP
+#define EGGS_VARIANT_ALLOCATOR_VARIANT_HPP
+
+#include "detail/pack.hpp"
+#include "detail/utility.hpp"
+#include "detail/visitor.hpp"
+
+#include "in_place.hpp"
+#include "variant.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include "detail/config/prefix.hpp"
+
+namespace eggs { namespace variants
+{
+    namespace detail
+    {
+        ///////////////////////////////////////////////////////////////////////
+        // the uses-allocator construction protocol: `0` for construction
+        // without the allocator, `1` for leading `allocator_arg_t`, and `2`
+        // for a trailing allocator
+        template <typename T, typename Alloc, typename ...Args>
+        struct uses_allocator_form
+          : std::integral_constant<int
+              , !std::uses_allocator<T, Alloc>::value ? 0
+              : std::is_constructible<
+                    T, std::allocator_arg_t, Alloc const&, Args...>::value ? 1
+              : 2
+            >
+        {};
+
+        template <std::size_t I, typename T, typename V, typename Alloc, typename ...Args>
+        void _uses_allocator_emplace(
+            std::integral_constant<int, 0>, V& v, Alloc const& /*alloc*/,
+            Args&&... args)
+        {
+            v.template emplace<I>(detail::forward<Args>(args)...);
+        }
+
+        template <std::size_t I, typename T, typename V, typename Alloc, typename ...Args>
+        void _uses_allocator_emplace(
+            std::integral_constant<int, 1>, V& v, Alloc const& alloc,
+            Args&&... args)
+        {
+            v.template emplace<I>(
+                std::allocator_arg, alloc, detail::forward<Args>(args)...);
+        }
+
+        template <std::size_t I, typename T, typename V, typename Alloc, typename ...Args>
+        void _uses_allocator_emplace(
+            std::integral_constant<int, 2>, V& v, Alloc const& alloc,
+            Args&&... args)
+        {
+            static_assert(
+                std::is_constructible<T, Args..., Alloc const&>::value
+              , "type uses the allocator but cannot be constructed with it");
+            v.template emplace<I>(detail::forward<Args>(args)..., alloc);
+        }
+
+        template <std::size_t I, typename V, typename Alloc, typename ...Args>
+        void uses_allocator_emplace(V& v, Alloc const& alloc, Args&&... args)
+        {
+            using T = typename variant_element<I, V>::type;
+            detail::_uses_allocator_emplace<I, T>(
+                uses_allocator_form<T, Alloc, Args...>{}
+              , v, alloc, detail::forward<Args>(args)...);
+        }
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    //! template <class Allocator, class ...Ts>
+    //! class allocator_variant;
+    //!
+    //! An `allocator_variant` holds a `variant<Ts...>` together with an
+    //! allocator of type `Allocator`. Whenever an active member is
+    //! constructed, whether by `emplace`, by copy, or by move, it is
+    //! constructed by uses-allocator construction with that allocator: if
+    //! `std::uses_allocator_v<T, Allocator>` is `true`, the allocator is
+    //! passed after a leading `std::allocator_arg` or, failing that, as a
+    //! trailing argument.
+    //!
+    //! The allocator is fixed at construction; it is kept across changes of
+    //! the active member and is not propagated on assignment, so that every
+    //! member held over the lifetime of an `allocator_variant` uses the same
+    //! memory resource. An `allocator_variant` is itself constructible by
+    //! uses-allocator construction, so it propagates the allocator of a
+    //! container that holds it.
+    template <typename Allocator, typename ...Ts>
+    class allocator_variant
+    {
+        using _variant = variant<Ts...>;
+
+        struct _copy
+          : detail::visitor<_copy, void(allocator_variant&, void const*)>
+        {
+            template <typename I>
+            static void call(allocator_variant& self, void const* ptr)
+            {
+                using T = typename detail::at_index<
+                    I::value, detail::pack<Ts...>>::type;
+                T const& member = *static_cast<T const*>(ptr);
+                if (T* target = self._variant_.template target<T>())
+                {
+                    *target = member;
+                } else {
+                    detail::uses_allocator_emplace<I::value>(
+                        self._variant_, self._allocator, member);
+                }
+            }
+        };
+
+        struct _move
+          : detail::visitor<_move, void(allocator_variant&, void*)>
+        {
+            template <typename I>
+            static void call(allocator_variant& self, void* ptr)
+            {
+                using T = typename detail::at_index<
+                    I::value, detail::pack<Ts...>>::type;
+                T& member = *static_cast<T*>(ptr);
+                if (T* target = self._variant_.template target<T>())
+                {
+                    *target = detail::move(member);
+                } else {
+                    detail::uses_allocator_emplace<I::value>(
+                        self._variant_, self._allocator, detail::move(member));
+                }
+            }
+        };
+
+    public:
+        using allocator_type = Allocator;
+        using value_type = _variant;
+
+        //! static constexpr std::size_t npos = std::size_t(-1);
+        EGGS_CXX11_STATIC_CONSTEXPR std::size_t npos = std::size_t(-1);
+
+    public:
+        //! allocator_variant();
+        //!
+        //! \effects Initializes the allocator with `Allocator()`.
+        //!
+        //! \postconditions `*this` has no active member.
+        allocator_variant()
+          : _variant_(), _allocator()
+        {}
+
+        //! allocator_variant(std::allocator_arg_t, Allocator const& alloc) noexcept;
+        //!
+        //! \effects Initializes the allocator with `alloc`.
+        //!
+        //! \postconditions `*this` has no active member.
+        allocator_variant(
+            std::allocator_arg_t, Allocator const& alloc) noexcept
+          : _variant_(), _allocator(alloc)
+        {}
+
+        //! template <std::size_t I, class ...Args>
+        //! allocator_variant(std::allocator_arg_t, Allocator const& alloc, in_place_index_t<I>, Args&&... args);
+        //!
+        //! \effects Initializes the allocator with `alloc`, then the `I`th
+        //!  member by uses-allocator construction with `std::forward<Args>(
+        //!  args)...`.
+        template <std::size_t I, typename ...Args>
+        allocator_variant(std::allocator_arg_t, Allocator const& alloc,
+            in_place_index_t<I>, Args&&... args)
+          : _variant_(), _allocator(alloc)
+        {
+            emplace<I>(detail::forward<Args>(args)...);
+        }
+
+        //! template <class T, class ...Args>
+        //! allocator_variant(std::allocator_arg_t, Allocator const& alloc, in_place_type_t<T>, Args&&... args);
+        //!
+        //! \effects Equivalent to `allocator_variant(std::allocator_arg,
+        //!  alloc, in_place<I>, std::forward<Args>(args)...)` where `I` is the
+        //!  zero-based index of `T` in `Ts...`.
+        template <typename T, typename ...Args>
+        allocator_variant(std::allocator_arg_t, Allocator const& alloc,
+            in_place_type_t<T>, Args&&... args)
+          : _variant_(), _allocator(alloc)
+        {
+            emplace<T>(detail::forward<Args>(args)...);
+        }
+
+        //! allocator_variant(allocator_variant const& rhs);
+        //!
+        //! \effects Initializes the allocator with `std::allocator_traits<
+        //!  Allocator>::select_on_container_copy_construction(
+        //!  rhs.get_allocator())`, then, if `rhs` has an active member,
+        //!  initializes the corresponding member by uses-allocator
+        //!  construction with a copy of it.
+        allocator_variant(allocator_variant const& rhs)
+          : _variant_()
+          , _allocator(std::allocator_traits<Allocator>::
+                select_on_container_copy_construction(rhs._allocator))
+        {
+            _assign(rhs);
+        }
+
+        //! allocator_variant(std::allocator_arg_t, Allocator const& alloc, allocator_variant const& rhs);
+        //!
+        //! \effects Initializes the allocator with `alloc`, then, if `rhs`
+        //!  has an active member, initializes the corresponding member by
+        //!  uses-allocator construction with a copy of it.
+        allocator_variant(std::allocator_arg_t, Allocator const& alloc,
+            allocator_variant const& rhs)
+          : _variant_(), _allocator(alloc)
+        {
+            _assign(rhs);
+        }
+
+        //! allocator_variant(allocator_variant&& rhs);
+        //!
+        //! \effects Initializes the allocator with `std::move(
+        //!  rhs.get_allocator())`, then, if `rhs` has an active member,
+        //!  initializes the corresponding member by uses-allocator
+        //!  construction with it moved.
+        allocator_variant(allocator_variant&& rhs)
+          : _variant_(), _allocator(detail::move(rhs._allocator))
+        {
+            _assign(detail::move(rhs));
+        }
+
+        //! allocator_variant(std::allocator_arg_t, Allocator const& alloc, allocator_variant&& rhs);
+        //!
+        //! \effects Initializes the allocator with `alloc`, then, if `rhs`
+        //!  has an active member, initializes the corresponding member by
+        //!  uses-allocator construction with it moved.
+        allocator_variant(std::allocator_arg_t, Allocator const& alloc,
+            allocator_variant&& rhs)
+          : _variant_(), _allocator(alloc)
+        {
+            _assign(detail::move(rhs));
+        }
+
+        //! allocator_variant& operator=(allocator_variant const& rhs);
+        //!
+        //! \effects If `rhs` has no active member, destroys the active
+        //!  member of `*this`, if any. Otherwise, if `*this` has an active
+        //!  member of the same alternative, copy assigns it from that of
+        //!  `rhs`; else, destroys the active member of `*this`, if any, and
+        //!  initializes the corresponding member by uses-allocator
+        //!  construction with a copy of that of `rhs`. The allocator is not
+        //!  changed.
+        //!
+        //! \returns `*this`.
+        allocator_variant& operator=(allocator_variant const& rhs)
+        {
+            if (this != &rhs)
+                _assign(rhs);
+            return *this;
+        }
+
+        //! allocator_variant& operator=(allocator_variant&& rhs);
+        //!
+        //! \effects As above, but moving from the active member of `rhs`.
+        //!
+        //! \returns `*this`.
+        allocator_variant& operator=(allocator_variant&& rhs)
+        {
+            if (this != &rhs)
+                _assign(detail::move(rhs));
+            return *this;
+        }
+
+        //! template <std::size_t I, class ...Args>
+        //! T& emplace(Args&&... args);
+        //!
+        //! Let `T` be the `I`th element in `Ts...`.
+        //!
+        //! \effects Destroys the active member, if any, then initializes the
+        //!  `I`th member by uses-allocator construction with `std::forward<
+        //!  Args>(args)...`.
+        //!
+        //! \returns A reference to the new active member.
+        //!
+        //! \remarks If an exception is thrown during the construction of the
+        //!  member, `*this` has no active member.
+        template <
+            std::size_t I, typename ...Args
+          , typename T = typename detail::checked_at_index<
+                I, detail::pack<Ts...>>::type
+        >
+        T& emplace(Args&&... args)
+        {
+            detail::uses_allocator_emplace<I>(
+                _variant_, _allocator, detail::forward<Args>(args)...);
+            return *_variant_.template target<T>();
+        }
+
+        //! template <class T, class ...Args>
+        //! T& emplace(Args&&... args);
+        //!
+        //! \effects Equivalent to `return emplace<I>(std::forward<Args>(
+        //!  args)...);` where `I` is the zero-based index of `T` in `Ts...`.
+        template <
+            typename T, typename ...Args
+          , std::size_t I = detail::checked_index_of<
+                T, detail::pack<Ts...>>::value
+        >
+        T& emplace(Args&&... args)
+        {
+            return emplace<I>(detail::forward<Args>(args)...);
+        }
+
+        //! allocator_type get_allocator() const noexcept;
+        allocator_type get_allocator() const noexcept
+        {
+            return _allocator;
+        }
+
+        //! explicit operator bool() const noexcept;
+        //!
+        //! \returns `true` if `*this` has an active member; otherwise,
+        //!  `false`.
+        explicit operator bool() const noexcept
+        {
+            return bool(_variant_);
+        }
+
+        //! std::size_t which() const noexcept;
+        //!
+        //! \returns The zero-based index of the active member, or `npos` if
+        //!  `*this` has no active member.
+        std::size_t which() const noexcept
+        {
+            return _variant_.which();
+        }
+
+        //! template <class T>
+        //! T* target() noexcept;
+        //!
+        //! \returns If `*this` has an active member of type `T`, a pointer
+        //!  to it; otherwise, a null pointer.
+        template <typename T>
+        T* target() noexcept
+        {
+            return _variant_.template target<T>();
+        }
+
+        //! template <class T>
+        //! T const* target() const noexcept;
+        //!
+        //! \returns If `*this` has an active member of type `T`, a pointer
+        //!  to it; otherwise, a null pointer.
+        template <typename T>
+        T const* target() const noexcept
+        {
+            return _variant_.template target<T>();
+        }
+
+        //! variant<Ts...> const& value() const noexcept;
+        //!
+        //! \returns The `variant<Ts...>` that holds the active member.
+        value_type const& value() const noexcept
+        {
+            return _variant_;
+        }
+
+        //! template <class R, class F>
+        //! R apply(F&& f);
+        //!
+        //! \effects Equivalent to `return variants::apply<R>(std::forward<F>(
+        //!  f), v);`, where `v` is an lvalue that designates the
+        //!  `variant<Ts...>` that holds the active member.
+        template <typename R, typename F>
+        R apply(F&& f)
+        {
+            return variants::apply<R>(detail::forward<F>(f), _variant_);
+        }
+
+        //! template <class R, class F>
+        //! R apply(F&& f) const;
+        //!
+        //! \effects Equivalent to `return variants::apply<R>(std::forward<F>(
+        //!  f), value());`.
+        template <typename R, typename F>
+        R apply(F&& f) const
+        {
+            return variants::apply<R>(detail::forward<F>(f), _variant_);
+        }
+
+    private:
+        void _assign(allocator_variant const& rhs)
+        {
+            std::size_t const which = rhs._variant_.which();
+            if (which == npos)
+            {
+                detail::access::storage(_variant_).emplace(detail::index<0>{});
+                return;
+            }
+            _copy{}(detail::typed_index_pack<detail::pack<Ts...>>{}, which
+              , *this, rhs._variant_.target());
+        }
+
+        void _assign(allocator_variant&& rhs)
+        {
+            std::size_t const which = rhs._variant_.which();
+            if (which == npos)
+            {
+                detail::access::storage(_variant_).emplace(detail::index<0>{});
+                return;
+            }
+            _move{}(detail::typed_index_pack<detail::pack<Ts...>>{}, which
+              , *this, rhs._variant_.target());
+        }
+
+    private:
+        _variant _variant_;
+        Allocator _allocator;
+    };
+
+    template <typename Allocator, typename ...Ts>
+    std::size_t const allocator_variant<Allocator, Ts...>::npos;
+}}
+
+namespace std
+{
+    template <typename Allocator, typename ...Ts, typename Alloc>
+    struct uses_allocator<
+        ::eggs::variants::allocator_variant<Allocator, Ts...>, Alloc
+    > : is_convertible<Alloc, Allocator>
+    {};
+}
+
+#include "detail/config/suffix.hpp"
+
+#endif /*EGGS_VARIANT_ALLOCATOR_VARIANT_HPP*/
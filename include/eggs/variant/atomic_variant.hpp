@@ -0,0 +1,223 @@
+//! \file eggs/variant/atomic_variant.hpp
+// Eggs.Variant
+//
+// Copyright Agustin K-ballo Berge, Fusion Fenix 2014-2018
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef EGGS_VARIANT_ATOMIC_VARIANT_HPP
+#define EGGS_VARIANT_ATOMIC_VARIANT_HPP
+
+#include "detail/pack.hpp"
+#include "detail/storage.hpp"
+#include "detail/utility.hpp"
+
+#include "variant.hpp"
+
+#include <atomic>
+#include <cstring>
+#include <new>
+#include <type_traits>
+
+#include "detail/config/prefix.hpp"
+
+namespace eggs { namespace variants
+{
+    ///////////////////////////////////////////////////////////////////////////
+    //! template <class ...Ts>
+    //! class atomic_variant;
+    //!
+    //! An `atomic_variant` holds a `variant<Ts...>` that can be loaded,
+    //! stored, exchanged and compared-and-exchanged atomically as a whole,
+    //! active member and discriminator together.
+    //!
+    //! Values are kept in a normalized representation, in which every byte
+    //! not occupied by the active member is zero, so that two values with
+    //! the same active member compare equal by representation whenever the
+    //! active members themselves do. Padding bytes within an active member
+    //! are not normalized, so `compare_exchange_strong` may fail for values
+    //! that compare equal when `T` has padding, after which `expected` holds
+    //! the normalized representation and a retry succeeds.
+    //!
+    //! All `T` in `Ts...` shall be trivially copyable.
+    //!
+    //! \remarks Operations are lock-free if and only if `std::atomic<
+    //!  variant<Ts...>>` is; otherwise, they fall back to the lock-based
+    //!  implementation of `std::atomic`, which may require linking with the
+    //!  platform's atomic support library.
+    template <typename ...Ts>
+    class atomic_variant
+    {
+        static_assert(
+            sizeof...(Ts) > 0
+          , "atomic_variant shall have at least one alternative");
+
+        static_assert(
+            detail::all_of<detail::pack<
+                detail::is_trivially_copyable<Ts>...>>::value
+          , "atomic_variant alternatives shall be trivially copyable");
+
+        using _variant = variant<Ts...>;
+
+        static _variant _normalize(_variant const& v) noexcept
+        {
+            typename std::aligned_storage<
+                sizeof(_variant), std::alignment_of<_variant>::value
+            >::type buffer;
+            std::memset(&buffer, 0, sizeof(buffer));
+
+            _variant* ptr = ::new (&buffer) _variant();
+            _variant tmp(v);
+            detail::access::storage(*ptr)._move(detail::access::storage(tmp));
+            return *ptr;
+        }
+
+    public:
+        using value_type = _variant;
+
+    public:
+        //! atomic_variant() noexcept;
+        //!
+        //! \effects Initializes the stored value with a `variant<Ts...>`
+        //!  that has no active member.
+        atomic_variant() noexcept
+          : _value(_normalize(_variant()))
+        {}
+
+        //! atomic_variant(variant<Ts...> const& v) noexcept;
+        //!
+        //! \effects Initializes the stored value with `v`. This
+        //!  initialization is not atomic.
+        atomic_variant(_variant const& v) noexcept
+          : _value(_normalize(v))
+        {}
+
+        atomic_variant(atomic_variant const&) = delete;
+        atomic_variant& operator=(atomic_variant const&) = delete;
+
+        //! atomic_variant& operator=(variant<Ts...> const& v) noexcept;
+        //!
+        //! \effects Equivalent to `store(v)`.
+        //!
+        //! \returns `*this`.
+        atomic_variant& operator=(_variant const& v) noexcept
+        {
+            store(v);
+            return *this;
+        }
+
+        //! bool is_lock_free() const noexcept;
+        //!
+        //! \returns `true` if the operations on this object are lock-free;
+        //!  otherwise, `false`.
+        bool is_lock_free() const noexcept
+        {
+            return _value.is_lock_free();
+        }
+
+        //! void store(variant<Ts...> const& v, std::memory_order order = std::memory_order_seq_cst) noexcept;
+        //!
+        //! \effects Atomically replaces the stored value with `v`.
+        void store(
+            _variant const& v,
+            std::memory_order order = std::memory_order_seq_cst) noexcept
+        {
+            _value.store(_normalize(v), order);
+        }
+
+        //! variant<Ts...> load(std::memory_order order = std::memory_order_seq_cst) const noexcept;
+        //!
+        //! \returns Atomically, the stored value.
+        _variant load(
+            std::memory_order order = std::memory_order_seq_cst) const noexcept
+        {
+            return _value.load(order);
+        }
+
+        //! operator variant<Ts...>() const noexcept;
+        //!
+        //! \effects Equivalent to `return load();`.
+        operator _variant() const noexcept
+        {
+            return load();
+        }
+
+        //! variant<Ts...> exchange(variant<Ts...> const& v, std::memory_order order = std::memory_order_seq_cst) noexcept;
+        //!
+        //! \effects Atomically replaces the stored value with `v`.
+        //!
+        //! \returns The stored value immediately before the effects.
+        _variant exchange(
+            _variant const& v,
+            std::memory_order order = std::memory_order_seq_cst) noexcept
+        {
+            return _value.exchange(_normalize(v), order);
+        }
+
+        //! bool compare_exchange_weak(variant<Ts...>& expected, variant<Ts...> const& desired, std::memory_order success, std::memory_order failure) noexcept;
+        //!
+        //! \effects Atomically compares the representation of the stored
+        //!  value with that of `expected` and, if equal, replaces the stored
+        //!  value with `desired`; otherwise, loads the stored value into
+        //!  `expected`. May fail spuriously.
+        //!
+        //! \returns The result of the comparison.
+        bool compare_exchange_weak(
+            _variant& expected, _variant const& desired,
+            std::memory_order success, std::memory_order failure) noexcept
+        {
+            expected = _normalize(expected);
+            return _value.compare_exchange_weak(
+                expected, _normalize(desired), success, failure);
+        }
+
+        //! bool compare_exchange_weak(variant<Ts...>& expected, variant<Ts...> const& desired, std::memory_order order = std::memory_order_seq_cst) noexcept;
+        //!
+        //! \effects Equivalent to `compare_exchange_weak(expected, desired,
+        //!  order, failure)`, where `failure` is `order` without its release
+        //!  semantics.
+        bool compare_exchange_weak(
+            _variant& expected, _variant const& desired,
+            std::memory_order order = std::memory_order_seq_cst) noexcept
+        {
+            expected = _normalize(expected);
+            return _value.compare_exchange_weak(
+                expected, _normalize(desired), order);
+        }
+
+        //! bool compare_exchange_strong(variant<Ts...>& expected, variant<Ts...> const& desired, std::memory_order success, std::memory_order failure) noexcept;
+        //!
+        //! \effects Equivalent to `compare_exchange_weak(expected, desired,
+        //!  success, failure)`, except that it does not fail spuriously.
+        bool compare_exchange_strong(
+            _variant& expected, _variant const& desired,
+            std::memory_order success, std::memory_order failure) noexcept
+        {
+            expected = _normalize(expected);
+            return _value.compare_exchange_strong(
+                expected, _normalize(desired), success, failure);
+        }
+
+        //! bool compare_exchange_strong(variant<Ts...>& expected, variant<Ts...> const& desired, std::memory_order order = std::memory_order_seq_cst) noexcept;
+        //!
+        //! \effects Equivalent to `compare_exchange_strong(expected, desired,
+        //!  order, failure)`, where `failure` is `order` without its release
+        //!  semantics.
+        bool compare_exchange_strong(
+            _variant& expected, _variant const& desired,
+            std::memory_order order = std::memory_order_seq_cst) noexcept
+        {
+            expected = _normalize(expected);
+            return _value.compare_exchange_strong(
+                expected, _normalize(desired), order);
+        }
+
+    private:
+        std::atomic<_variant> _value;
+    };
+}}
+
+#include "detail/config/suffix.hpp"
+
+#endif /*EGGS_VARIANT_ATOMIC_VARIANT_HPP*/
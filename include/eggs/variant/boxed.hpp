@@ -0,0 +1,535 @@
+//! \file eggs/variant/boxed.hpp
+// Eggs.Variant
+//
+// Copyright Agustin K-ballo Berge, Fusion Fenix 2014-2018
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef EGGS_VARIANT_BOXED_HPP
+#define EGGS_VARIANT_BOXED_HPP
+
+#include "detail/storage.hpp"
+#include "detail/utility.hpp"
+
+#include "variant.hpp"
+
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <new>
+#include <type_traits>
+
+#include "detail/config/prefix.hpp"
+
+namespace eggs { namespace variants
+{
+    ///////////////////////////////////////////////////////////////////////////
+    //! template <class T>
+    //! class box_pool;
+    //!
+    //! A `box_pool` provides the out of line storage for objects of type `T`
+    //! held by `boxed<T>`. Each thread keeps a free list of up to
+    //! `max_cached` blocks that it has deallocated, from which it serves its
+    //! next allocations; the blocks still cached when a thread exits are
+    //! released, and storage deallocated by a thread after that is
+    //! released directly.
+    template <typename T>
+    class box_pool
+    {
+        static_assert(
+            alignof(T) <= alignof(std::max_align_t),
+            "over-aligned types cannot be boxed");
+
+        union _block
+        {
+            _block* next;
+            typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+        };
+
+    public:
+        //! struct statistics;
+        //!
+        //! The number of blocks allocated from and released to the global
+        //! allocation functions, of allocations served from the free list,
+        //! and of blocks currently in the free list, by the calling thread.
+        struct statistics
+        {
+            std::size_t allocated;
+            std::size_t reused;
+            std::size_t released;
+            std::size_t cached;
+        };
+
+        //! static constexpr std::size_t max_cached = see below;
+        //!
+        //! The maximum number of blocks in the free list of a thread; at
+        //! least 1, and at most 64 or as many as fit in 64KB.
+        EGGS_CXX11_STATIC_CONSTEXPR std::size_t max_cached =
+            sizeof(_block) * 64 <= 65536 ? 64
+          : sizeof(_block) <= 65536 ? 65536 / sizeof(_block) : 1;
+
+    private:
+        // trivially destructible, so that it can still be used by objects
+        // destroyed after the thread local objects of a thread
+        struct _free_list
+        {
+            _block* head;
+            statistics stats;
+            bool closed;
+        };
+
+        struct _closer
+        {
+            ~_closer()
+            {
+                _free_list& free_list = _free_list_of_this_thread();
+                free_list.closed = true;
+                _release(free_list);
+            }
+        };
+
+        static _free_list& _free_list_of_this_thread() noexcept
+        {
+            static thread_local _free_list free_list =
+                {nullptr, {0, 0, 0, 0}, false};
+            return free_list;
+        }
+
+        static _free_list& _this_thread() noexcept
+        {
+            static thread_local _closer closer;
+            (void)closer;
+            return _free_list_of_this_thread();
+        }
+
+        static void _release(_free_list& free_list) noexcept
+        {
+            while (_block* block = free_list.head)
+            {
+                free_list.head = block->next;
+                ::operator delete(block);
+                --free_list.stats.cached;
+                ++free_list.stats.released;
+            }
+        }
+
+    public:
+        //! static void* allocate();
+        //!
+        //! \returns A pointer to storage suitable for an object of type `T`,
+        //!  taken from the free list of the calling thread if it is not empty.
+        //!
+        //! \throws `std::bad_alloc` if the storage cannot be obtained.
+        static void* allocate()
+        {
+            _free_list& free_list = _this_thread();
+            if (_block* block = free_list.head)
+            {
+                free_list.head = block->next;
+                --free_list.stats.cached;
+                ++free_list.stats.reused;
+                return block;
+            }
+
+            void* ptr = ::operator new(sizeof(_block));
+            ++free_list.stats.allocated;
+            return ptr;
+        }
+
+        //! static void deallocate(void* ptr) noexcept;
+        //!
+        //! \requires `ptr` shall have been returned by `allocate()`, on this
+        //!  or any other thread, and not have been deallocated since.
+        //!
+        //! \effects Adds the storage pointed to by `ptr` to the free list of
+        //!  the calling thread, or releases it if the list holds `max_cached`
+        //!  blocks already or was released on thread exit.
+        static void deallocate(void* ptr) noexcept
+        {
+            _free_list& free_list = _this_thread();
+            if (free_list.closed || free_list.stats.cached == max_cached)
+            {
+                ::operator delete(ptr);
+                ++free_list.stats.released;
+                return;
+            }
+
+            _block* block = ::new (ptr) _block;
+            block->next = free_list.head;
+            free_list.head = block;
+            ++free_list.stats.cached;
+        }
+
+        //! static void release() noexcept;
+        //!
+        //! \effects Releases every block in the free list of the calling
+        //!  thread.
+        static void release() noexcept
+        {
+            _release(_this_thread());
+        }
+
+        //! static statistics stats() noexcept;
+        //!
+        //! \returns The statistics of the calling thread.
+        static statistics stats() noexcept
+        {
+            return _this_thread().stats;
+        }
+    };
+
+    template <typename T>
+    std::size_t const box_pool<T>::max_cached;
+
+    ///////////////////////////////////////////////////////////////////////////
+    //! template <class T>
+    //! class boxed;
+    //!
+    //! A `boxed<T>` holds an object of type `T` out of line, in storage
+    //! obtained from `box_pool<T>`, so that it occupies a single pointer as
+    //! an alternative of a `variant`. A `variant` alternative of type
+    //! `boxed<T>` is accessed as `T`: `get`, `get_if`, `target`, `apply` and
+    //! the relational operators yield a reference or pointer to the boxed
+    //! object, and `get<T>`, `get_if<T>`, `emplace<T>` and `in_place<T>`
+    //! look it up by `T`.
+    //!
+    //! Moving a `boxed<T>` transfers ownership of the boxed object, and
+    //! move assignment swaps it; neither moves the object itself. A
+    //! moved-from `boxed<T>` holds no object; it can be destroyed, assigned
+    //! to, copied, compared and hashed, where it behaves as a value that
+    //! equals only another `boxed<T>` that holds no object and orders
+    //! before every object.
+    template <typename T>
+    class boxed
+    {
+        static_assert(
+            !std::is_reference<T>::value && !std::is_const<T>::value,
+            "boxed requires a non-const object type");
+
+        struct _guard
+        {
+            void* ptr;
+
+            ~_guard()
+            {
+                if (ptr != nullptr)
+                    box_pool<T>::deallocate(ptr);
+            }
+        };
+
+    public:
+        using element_type = T;
+
+    public:
+        //! template <class U>
+        //! boxed(U&& value);
+        //!
+        //! \effects Initializes the boxed object with `std::forward<U>(value)`.
+        //!
+        //! \remarks This constructor shall not participate in overload
+        //!  resolution unless `std::decay_t<U>` is not `boxed` and
+        //!  `std::is_convertible_v<U&&, T>` is `true`.
+        template <
+            typename U
+          , typename Enable = typename std::enable_if<
+                !std::is_same<typename std::decay<U>::type, boxed>::value
+             && std::is_convertible<U&&, T>::value>::type
+        >
+        boxed(U&& value)
+          : _ptr(_make(detail::forward<U>(value)))
+        {}
+
+        //! template <class ...Args>
+        //! explicit boxed(Args&&... args);
+        //!
+        //! \effects Initializes the boxed object as if direct-non-list-
+        //!  initializing an object of type `T` with
+        //!  `std::forward<Args>(args)...`.
+        //!
+        //! \remarks This constructor shall not participate in overload
+        //!  resolution unless `std::is_constructible_v<T, Args&&...>` is
+        //!  `true`.
+        template <
+            typename ...Args
+          , typename Enable = typename std::enable_if<
+                std::is_constructible<T, Args&&...>::value>::type
+        >
+        explicit boxed(Args&&... args)
+          : _ptr(_make(detail::forward<Args>(args)...))
+        {}
+
+        //! boxed(boxed const& rhs);
+        //!
+        //! \effects If `rhs` holds an object, initializes the boxed object
+        //!  with `*rhs`; otherwise, `*this` holds no object.
+        boxed(boxed const& rhs)
+          : _ptr(rhs._ptr != nullptr ? _make(*rhs._ptr) : nullptr)
+        {}
+
+        //! boxed(boxed&& rhs) noexcept;
+        //!
+        //! \effects Takes ownership of the object boxed by `rhs`, if any.
+        //!
+        //! \postconditions `rhs` holds no object.
+        boxed(boxed&& rhs) noexcept
+          : _ptr(rhs._ptr)
+        {
+            rhs._ptr = nullptr;
+        }
+
+        //! ~boxed();
+        //!
+        //! \effects Destroys the boxed object, if any, and deallocates its
+        //!  storage.
+        ~boxed()
+        {
+            _destroy(_ptr);
+        }
+
+        //! boxed& operator=(boxed const& rhs);
+        //!
+        //! \effects If `rhs` holds no object, destroys the boxed object, if
+        //!  any; otherwise, if `*this` holds an object, assigns `*rhs` to it;
+        //!  otherwise, initializes a new boxed object with `*rhs`.
+        boxed& operator=(boxed const& rhs)
+        {
+            if (rhs._ptr == nullptr)
+            {
+                _destroy(_ptr);
+                _ptr = nullptr;
+            }
+            else if (_ptr != nullptr)
+            {
+                *_ptr = *rhs._ptr;
+            }
+            else
+            {
+                _ptr = _make(*rhs._ptr);
+            }
+            return *this;
+        }
+
+        //! boxed& operator=(boxed&& rhs) noexcept;
+        //!
+        //! \effects Exchanges the boxed objects of `*this` and `rhs`.
+        boxed& operator=(boxed&& rhs) noexcept
+        {
+            T* ptr = _ptr;
+            _ptr = rhs._ptr;
+            rhs._ptr = ptr;
+            return *this;
+        }
+
+        //! explicit operator bool() const noexcept;
+        //!
+        //! \returns `true` if `*this` holds an object, otherwise `false`.
+        explicit operator bool() const noexcept
+        {
+            return _ptr != nullptr;
+        }
+
+        //! T& get() noexcept;
+        //! T const& get() const noexcept;
+        //! T& operator*() noexcept;
+        //! T const& operator*() const noexcept;
+        //!
+        //! \requires `*this` holds an object.
+        //!
+        //! \returns A reference to the boxed object.
+        T& get() noexcept
+        {
+            return *_ptr;
+        }
+
+        T const& get() const noexcept
+        {
+            return *_ptr;
+        }
+
+        T& operator*() noexcept
+        {
+            return *_ptr;
+        }
+
+        T const& operator*() const noexcept
+        {
+            return *_ptr;
+        }
+
+        //! T* operator->() noexcept;
+        //! T const* operator->() const noexcept;
+        //!
+        //! \returns A pointer to the boxed object, or `nullptr` if `*this`
+        //!  holds no object.
+        T* operator->() noexcept
+        {
+            return _ptr;
+        }
+
+        T const* operator->() const noexcept
+        {
+            return _ptr;
+        }
+
+    private:
+        template <typename ...Args>
+        static T* _make(Args&&... args)
+        {
+            _guard guard = {box_pool<T>::allocate()};
+            T* ptr = ::new (guard.ptr) T(detail::forward<Args>(args)...);
+            guard.ptr = nullptr;
+            return ptr;
+        }
+
+        static void _destroy(T* ptr) noexcept
+        {
+            if (ptr != nullptr)
+            {
+                ptr->~T();
+                box_pool<T>::deallocate(ptr);
+            }
+        }
+
+    private:
+        T* _ptr;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    //! template <class T>
+    //! bool operator==(boxed<T> const& lhs, boxed<T> const& rhs);
+    //! template <class T>
+    //! bool operator!=(boxed<T> const& lhs, boxed<T> const& rhs);
+    //! template <class T>
+    //! bool operator<(boxed<T> const& lhs, boxed<T> const& rhs);
+    //! template <class T>
+    //! bool operator>(boxed<T> const& lhs, boxed<T> const& rhs);
+    //! template <class T>
+    //! bool operator<=(boxed<T> const& lhs, boxed<T> const& rhs);
+    //! template <class T>
+    //! bool operator>=(boxed<T> const& lhs, boxed<T> const& rhs);
+    //!
+    //! \returns If both `lhs` and `rhs` hold an object, `*lhs @ *rhs`;
+    //!  otherwise, `bool(lhs) @ bool(rhs)`, where `@` is the corresponding
+    //!  operator.
+    template <typename T>
+    bool operator==(boxed<T> const& lhs, boxed<T> const& rhs)
+    {
+        return lhs && rhs ? *lhs == *rhs : bool(lhs) == bool(rhs);
+    }
+
+    template <typename T>
+    bool operator!=(boxed<T> const& lhs, boxed<T> const& rhs)
+    {
+        return lhs && rhs ? *lhs != *rhs : bool(lhs) != bool(rhs);
+    }
+
+    template <typename T>
+    bool operator<(boxed<T> const& lhs, boxed<T> const& rhs)
+    {
+        return lhs && rhs ? *lhs < *rhs : bool(lhs) < bool(rhs);
+    }
+
+    template <typename T>
+    bool operator>(boxed<T> const& lhs, boxed<T> const& rhs)
+    {
+        return lhs && rhs ? *lhs > *rhs : bool(lhs) > bool(rhs);
+    }
+
+    template <typename T>
+    bool operator<=(boxed<T> const& lhs, boxed<T> const& rhs)
+    {
+        return lhs && rhs ? *lhs <= *rhs : bool(lhs) <= bool(rhs);
+    }
+
+    template <typename T>
+    bool operator>=(boxed<T> const& lhs, boxed<T> const& rhs)
+    {
+        return lhs && rhs ? *lhs >= *rhs : bool(lhs) >= bool(rhs);
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    namespace detail
+    {
+        template <typename T>
+        struct unboxed<boxed<T>>
+        {
+            using type = T;
+
+            // a moved-from alternative holds no object to refer to
+            static T& get(boxed<T>& member) noexcept
+            {
+                if (!member)
+                    std::terminate();
+                return *member;
+            }
+
+            static T const& get(boxed<T> const& member) noexcept
+            {
+                if (!member)
+                    std::terminate();
+                return *member;
+            }
+        };
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    //! template <std::size_t Threshold, class T>
+    //! struct box_if_larger;
+    //!
+    //! The member typedef `type` names `boxed<T>` if `T` is a non-const
+    //! type larger than `Threshold` bytes whose alignment does not exceed
+    //! `alignof(std::max_align_t)`; otherwise, it names `T`.
+    template <std::size_t Threshold, typename T>
+    struct box_if_larger
+    {
+        using type = typename std::conditional<
+            (sizeof(T) > Threshold)
+         && !std::is_const<T>::value
+         && alignof(T) <= alignof(std::max_align_t)
+          , boxed<T>, T
+        >::type;
+    };
+
+    //! template <std::size_t Threshold, class ...Ts>
+    //! using threshold_variant = variant<typename box_if_larger<Threshold, Ts>::type...>;
+    //!
+    //! A `variant` that holds every alternative larger than `Threshold`
+    //! bytes out of line. Since a boxed alternative is accessed as the type
+    //! it boxes, code that uses a `variant<Ts...>` through `get`, `get_if`,
+    //! `target`, `apply`, `emplace<T>` and `in_place<T>` works unchanged.
+    template <std::size_t Threshold, typename ...Ts>
+    using threshold_variant =
+        variant<typename box_if_larger<Threshold, Ts>::type...>;
+
+    //! template <class ...Ts>
+    //! using compact_variant = threshold_variant<64 - sizeof(std::size_t), Ts...>;
+    //!
+    //! A `threshold_variant` whose size does not exceed 64 bytes, a common
+    //! cache line size, unless an alternative is over-aligned.
+    template <typename ...Ts>
+    using compact_variant = threshold_variant<64 - sizeof(std::size_t), Ts...>;
+}}
+
+namespace std
+{
+    //! template <class T>
+    //! struct hash<::eggs::variants::boxed<T>>;
+    //!
+    //! For an object `b` of type `boxed<T>`, `std::hash<boxed<T>>()(b)`
+    //!  evaluates to the same value as `std::hash<T>()(*b)` if `b` holds an
+    //!  object, and to `0` otherwise.
+    template <typename T>
+    struct hash< ::eggs::variants::boxed<T>>
+    {
+        std::size_t operator()(::eggs::variants::boxed<T> const& b) const
+            noexcept(noexcept(std::hash<T>()(*b)))
+        {
+            return b ? std::hash<T>()(*b) : 0;
+        }
+    };
+}
+
+#include "detail/config/suffix.hpp"
+
+#endif /*EGGS_VARIANT_BOXED_HPP*/
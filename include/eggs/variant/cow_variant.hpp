@@ -0,0 +1,510 @@
+//! \file eggs/variant/cow_variant.hpp
+// Eggs.Variant
+//
+// Copyright Agustin K-ballo Berge, Fusion Fenix 2014-2018
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef EGGS_VARIANT_COW_VARIANT_HPP
+#define EGGS_VARIANT_COW_VARIANT_HPP
+
+#include "detail/pack.hpp"
+#include "detail/utility.hpp"
+
+#include "in_place.hpp"
+#include "variant.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+
+#include "detail/config/prefix.hpp"
+
+namespace eggs { namespace variants
+{
+    ///////////////////////////////////////////////////////////////////////////
+    //! class atomic_refcount;
+    //!
+    //! A reference count policy for `basic_cow_variant` that may be shared
+    //! by copies used concurrently from different threads.
+    class atomic_refcount
+    {
+    public:
+        atomic_refcount() noexcept
+          : _count(1)
+        {}
+
+        void acquire() noexcept
+        {
+            _count.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        bool release() noexcept
+        {
+            return _count.fetch_sub(1, std::memory_order_acq_rel) == 1;
+        }
+
+        std::size_t count() const noexcept
+        {
+            return _count.load(std::memory_order_acquire);
+        }
+
+    private:
+        std::atomic<std::size_t> _count;
+    };
+
+    //! class local_refcount;
+    //!
+    //! A reference count policy for `basic_cow_variant` that shall only be
+    //! shared by copies used from a single thread at a time.
+    class local_refcount
+    {
+    public:
+        local_refcount() noexcept
+          : _count(1)
+        {}
+
+        void acquire() noexcept
+        {
+            ++_count;
+        }
+
+        bool release() noexcept
+        {
+            return --_count == 0;
+        }
+
+        std::size_t count() const noexcept
+        {
+            return _count;
+        }
+
+    private:
+        std::size_t _count;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    //! template <class RefCount, class ...Ts>
+    //! class basic_cow_variant;
+    //!
+    //! A `basic_cow_variant` holds a `variant<Ts...>` in a representation
+    //! that copies share, with a reference count of type `RefCount`. The
+    //! value is only copied when it is about to be modified through a copy
+    //! that shares it: by `emplace`, by non-const `target` and `apply`, or
+    //! by `get` and `get_if` on a non-const `basic_cow_variant`. Accessing
+    //! it through a const `basic_cow_variant` never copies it.
+    //!
+    //! \remarks References and pointers obtained from a `basic_cow_variant`
+    //!  are invalidated when it is assigned to or copies its value.
+    template <typename RefCount, typename ...Ts>
+    class basic_cow_variant
+    {
+        using _variant = variant<Ts...>;
+
+        struct _rep
+        {
+            RefCount count;
+            _variant value;
+
+            template <typename ...Args>
+            explicit _rep(Args&&... args)
+              : count()
+              , value(detail::forward<Args>(args)...)
+            {}
+        };
+
+    public:
+        using value_type = _variant;
+        using refcount_type = RefCount;
+
+        //! static constexpr std::size_t npos = std::size_t(-1);
+        EGGS_CXX11_STATIC_CONSTEXPR std::size_t npos = std::size_t(-1);
+
+    public:
+        //! basic_cow_variant() noexcept;
+        //!
+        //! \postconditions `*this` has no active member.
+        basic_cow_variant() noexcept
+          : _ptr(nullptr)
+        {}
+
+        //! template <class U>
+        //! basic_cow_variant(U&& u);
+        //!
+        //! \effects Initializes the value with `variant<Ts...>(
+        //!  std::forward<U>(u))`, in a representation of its own.
+        //!
+        //! \remarks This constructor shall not participate in overload
+        //!  resolution unless `std::decay_t<U>` is not `basic_cow_variant` and
+        //!  `std::is_constructible_v<variant<Ts...>, U&&>` is `true`.
+        template <
+            typename U
+          , typename Enable = typename std::enable_if<
+                !std::is_same<typename std::decay<U>::type, basic_cow_variant>::value
+             && std::is_constructible<_variant, U&&>::value>::type
+        >
+        basic_cow_variant(U&& u)
+          : _ptr(new _rep(detail::forward<U>(u)))
+        {}
+
+        //! template <std::size_t I, class ...Args>
+        //! explicit basic_cow_variant(in_place_index_t<I>, Args&&... args);
+        //!
+        //! \effects Initializes the value as if by `variant<Ts...>(in_place<I>,
+        //!  std::forward<Args>(args)...)`.
+        template <std::size_t I, typename ...Args>
+        explicit basic_cow_variant(in_place_index_t<I> which, Args&&... args)
+          : _ptr(new _rep(which, detail::forward<Args>(args)...))
+        {}
+
+        //! template <class T, class ...Args>
+        //! explicit basic_cow_variant(in_place_type_t<T>, Args&&... args);
+        //!
+        //! \effects Initializes the value as if by `variant<Ts...>(in_place<T>,
+        //!  std::forward<Args>(args)...)`.
+        template <typename T, typename ...Args>
+        explicit basic_cow_variant(in_place_type_t<T> which, Args&&... args)
+          : _ptr(new _rep(which, detail::forward<Args>(args)...))
+        {}
+
+        //! basic_cow_variant(basic_cow_variant const& rhs) noexcept;
+        //!
+        //! \effects Shares the representation of `rhs`.
+        basic_cow_variant(basic_cow_variant const& rhs) noexcept
+          : _ptr(rhs._ptr)
+        {
+            if (_ptr != nullptr)
+                _ptr->count.acquire();
+        }
+
+        //! basic_cow_variant(basic_cow_variant&& rhs) noexcept;
+        //!
+        //! \effects Takes over the representation of `rhs`.
+        //!
+        //! \postconditions `rhs` has no active member.
+        basic_cow_variant(basic_cow_variant&& rhs) noexcept
+          : _ptr(rhs._ptr)
+        {
+            rhs._ptr = nullptr;
+        }
+
+        //! ~basic_cow_variant();
+        //!
+        //! \effects Releases the representation of `*this`, destroying it if
+        //!  no other copy shares it.
+        ~basic_cow_variant()
+        {
+            _release(_ptr);
+        }
+
+        //! basic_cow_variant& operator=(basic_cow_variant const& rhs) noexcept;
+        //!
+        //! \effects Releases the representation of `*this` and shares that
+        //!  of `rhs`.
+        basic_cow_variant& operator=(basic_cow_variant const& rhs) noexcept
+        {
+            if (rhs._ptr != nullptr)
+                rhs._ptr->count.acquire();
+            _release(_ptr);
+            _ptr = rhs._ptr;
+            return *this;
+        }
+
+        //! basic_cow_variant& operator=(basic_cow_variant&& rhs) noexcept;
+        //!
+        //! \effects Exchanges the representations of `*this` and `rhs`.
+        basic_cow_variant& operator=(basic_cow_variant&& rhs) noexcept
+        {
+            _rep* ptr = _ptr;
+            _ptr = rhs._ptr;
+            rhs._ptr = ptr;
+            return *this;
+        }
+
+        //! template <std::size_t I, class ...Args>
+        //! T& emplace(Args&&... args);
+        //!
+        //! \effects If `*this` shares its representation, replaces it with
+        //!  one of its own holding `variant<Ts...>(in_place<I>,
+        //!  std::forward<Args>(args)...)`; otherwise, equivalent to
+        //!  `value.emplace<I>(std::forward<Args>(args)...)`.
+        //!
+        //! \returns A reference to the new active member.
+        template <
+            std::size_t I, typename ...Args
+          , typename T = typename detail::checked_at_index<
+                I, detail::pack<Ts...>>::type
+        >
+        typename detail::unboxed<T>::type& emplace(Args&&... args)
+        {
+            if (_ptr != nullptr && _ptr->count.count() == 1)
+                return _ptr->value.template emplace<I>(
+                    detail::forward<Args>(args)...);
+
+            _rep* ptr = new _rep(in_place<I>, detail::forward<Args>(args)...);
+            _release(_ptr);
+            _ptr = ptr;
+            return variants::get<I>(_ptr->value);
+        }
+
+        //! template <class T, class ...Args>
+        //! T& emplace(Args&&... args);
+        //!
+        //! \effects Equivalent to `return emplace<I>(std::forward<Args>(
+        //!  args)...);` where `I` is the zero-based index of `T` in `Ts...`.
+        template <
+            typename T, typename ...Args
+          , std::size_t I = detail::checked_index_of<
+                T, detail::unboxed_pack<Ts...>>::value
+        >
+        T& emplace(Args&&... args)
+        {
+            return emplace<I>(detail::forward<Args>(args)...);
+        }
+
+        //! explicit operator bool() const noexcept;
+        //!
+        //! \returns `true` if `*this` has an active member; otherwise,
+        //!  `false`.
+        explicit operator bool() const noexcept
+        {
+            return _ptr != nullptr && bool(_ptr->value);
+        }
+
+        //! std::size_t which() const noexcept;
+        //!
+        //! \returns The zero-based index of the active member, or `npos` if
+        //!  `*this` has no active member.
+        std::size_t which() const noexcept
+        {
+            return _ptr != nullptr ? _ptr->value.which() : npos;
+        }
+
+        //! std::size_t use_count() const noexcept;
+        //!
+        //! \returns The number of copies that share the representation of
+        //!  `*this`, or `0` if it has none.
+        std::size_t use_count() const noexcept
+        {
+            return _ptr != nullptr ? _ptr->count.count() : 0;
+        }
+
+        //! template <class T>
+        //! T* target();
+        //!
+        //! \effects Copies the value if it is shared, as described above.
+        //!
+        //! \returns If `*this` has an active member of type `T`, a pointer
+        //!  to it; otherwise, a null pointer.
+        template <typename T>
+        T* target()
+        {
+            return _ptr != nullptr && _ptr->value.template target<T>() != nullptr
+              ? mutable_value().template target<T>() : nullptr;
+        }
+
+        //! template <class T>
+        //! T const* target() const noexcept;
+        //!
+        //! \returns If `*this` has an active member of type `T`, a pointer
+        //!  to it; otherwise, a null pointer.
+        template <typename T>
+        T const* target() const noexcept
+        {
+            return value().template target<T>();
+        }
+
+        //! variant<Ts...> const& value() const noexcept;
+        //!
+        //! \returns The shared value.
+        value_type const& value() const noexcept
+        {
+            return _ptr != nullptr ? _ptr->value : _empty();
+        }
+
+        //! variant<Ts...>& mutable_value();
+        //!
+        //! \effects If `*this` shares its representation, replaces it with
+        //!  one of its own holding a copy of the value.
+        //!
+        //! \returns The value, which `*this` does not share.
+        value_type& mutable_value()
+        {
+            if (_ptr == nullptr)
+            {
+                _ptr = new _rep();
+            } else if (_ptr->count.count() != 1) {
+                _rep* ptr = new _rep(_ptr->value);
+                _release(_ptr);
+                _ptr = ptr;
+            }
+            return _ptr->value;
+        }
+
+        //! template <class R, class F>
+        //! R apply(F&& f);
+        //!
+        //! \effects Equivalent to `return variants::apply<R>(std::forward<F>(
+        //!  f), mutable_value());`.
+        template <typename R, typename F>
+        R apply(F&& f)
+        {
+            return variants::apply<R>(detail::forward<F>(f), mutable_value());
+        }
+
+        //! template <class R, class F>
+        //! R apply(F&& f) const;
+        //!
+        //! \effects Equivalent to `return variants::apply<R>(std::forward<F>(
+        //!  f), value());`.
+        template <typename R, typename F>
+        R apply(F&& f) const
+        {
+            return variants::apply<R>(detail::forward<F>(f), value());
+        }
+
+    private:
+        static void _release(_rep* ptr) noexcept
+        {
+            if (ptr != nullptr && ptr->count.release())
+                delete ptr;
+        }
+
+        static _variant const& _empty() noexcept
+        {
+            static _variant const empty;
+            return empty;
+        }
+
+    private:
+        _rep* _ptr;
+    };
+
+    template <typename RefCount, typename ...Ts>
+    std::size_t const basic_cow_variant<RefCount, Ts...>::npos;
+
+    //! template <class ...Ts>
+    //! using cow_variant = basic_cow_variant<atomic_refcount, Ts...>;
+    template <typename ...Ts>
+    using cow_variant = basic_cow_variant<atomic_refcount, Ts...>;
+
+    ///////////////////////////////////////////////////////////////////////////
+    //! template <std::size_t I, class RefCount, class ...Ts>
+    //! variant_element_t<I, variant<Ts...>>& get(basic_cow_variant<RefCount, Ts...>& v);
+    //!
+    //! \effects Equivalent to `return variants::get<I>(v.mutable_value());`.
+    template <std::size_t I, typename RefCount, typename ...Ts>
+    auto get(basic_cow_variant<RefCount, Ts...>& v)
+     -> decltype(variants::get<I>(v.mutable_value()))
+    {
+        return variants::get<I>(v.mutable_value());
+    }
+
+    //! template <std::size_t I, class RefCount, class ...Ts>
+    //! variant_element_t<I, variant<Ts...>> const& get(basic_cow_variant<RefCount, Ts...> const& v);
+    //!
+    //! \effects Equivalent to `return variants::get<I>(v.value());`.
+    template <std::size_t I, typename RefCount, typename ...Ts>
+    auto get(basic_cow_variant<RefCount, Ts...> const& v)
+     -> decltype(variants::get<I>(v.value()))
+    {
+        return variants::get<I>(v.value());
+    }
+
+    //! template <class T, class RefCount, class ...Ts>
+    //! T& get(basic_cow_variant<RefCount, Ts...>& v);
+    //!
+    //! \effects Equivalent to `return variants::get<T>(v.mutable_value());`.
+    template <typename T, typename RefCount, typename ...Ts>
+    auto get(basic_cow_variant<RefCount, Ts...>& v)
+     -> decltype(variants::get<T>(v.mutable_value()))
+    {
+        return variants::get<T>(v.mutable_value());
+    }
+
+    //! template <class T, class RefCount, class ...Ts>
+    //! T const& get(basic_cow_variant<RefCount, Ts...> const& v);
+    //!
+    //! \effects Equivalent to `return variants::get<T>(v.value());`.
+    template <typename T, typename RefCount, typename ...Ts>
+    auto get(basic_cow_variant<RefCount, Ts...> const& v)
+     -> decltype(variants::get<T>(v.value()))
+    {
+        return variants::get<T>(v.value());
+    }
+
+    //! template <std::size_t I, class RefCount, class ...Ts>
+    //! variant_element_t<I, variant<Ts...>>* get_if(basic_cow_variant<RefCount, Ts...>* v);
+    //! template <class T, class RefCount, class ...Ts>
+    //! T* get_if(basic_cow_variant<RefCount, Ts...>* v);
+    //!
+    //! \returns A null pointer if `v` is a null pointer or `*v` does not
+    //!  have the requested active member; otherwise, `&get<I>(*v)` or
+    //!  `&get<T>(*v)`, respectively.
+    template <std::size_t I, typename RefCount, typename ...Ts>
+    auto get_if(basic_cow_variant<RefCount, Ts...>* v)
+     -> decltype(&variants::get<I>(v->mutable_value()))
+    {
+        return v != nullptr && v->which() == I
+          ? &variants::get<I>(v->mutable_value()) : nullptr;
+    }
+
+    template <typename T, typename RefCount, typename ...Ts>
+    auto get_if(basic_cow_variant<RefCount, Ts...>* v)
+     -> decltype(&variants::get<T>(v->mutable_value()))
+    {
+        return v != nullptr && variants::get_if<T>(&v->value()) != nullptr
+          ? &variants::get<T>(v->mutable_value()) : nullptr;
+    }
+
+    //! template <std::size_t I, class RefCount, class ...Ts>
+    //! variant_element_t<I, variant<Ts...>> const* get_if(basic_cow_variant<RefCount, Ts...> const* v);
+    //! template <class T, class RefCount, class ...Ts>
+    //! T const* get_if(basic_cow_variant<RefCount, Ts...> const* v);
+    //!
+    //! \returns `v != nullptr ? variants::get_if<I>(&v->value()) : nullptr`
+    //!  or `v != nullptr ? variants::get_if<T>(&v->value()) : nullptr`,
+    //!  respectively.
+    template <std::size_t I, typename RefCount, typename ...Ts>
+    auto get_if(basic_cow_variant<RefCount, Ts...> const* v)
+     -> decltype(variants::get_if<I>(&v->value()))
+    {
+        return v != nullptr ? variants::get_if<I>(&v->value()) : nullptr;
+    }
+
+    template <typename T, typename RefCount, typename ...Ts>
+    auto get_if(basic_cow_variant<RefCount, Ts...> const* v)
+     -> decltype(variants::get_if<T>(&v->value()))
+    {
+        return v != nullptr ? variants::get_if<T>(&v->value()) : nullptr;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    //! template <class RefCount, class ...Ts>
+    //! bool operator==(basic_cow_variant<RefCount, Ts...> const& lhs, basic_cow_variant<RefCount, Ts...> const& rhs);
+    //! template <class RefCount, class ...Ts>
+    //! bool operator!=(basic_cow_variant<RefCount, Ts...> const& lhs, basic_cow_variant<RefCount, Ts...> const& rhs);
+    //!
+    //! \returns `lhs.value() == rhs.value()` and `lhs.value() !=
+    //!  rhs.value()`, respectively.
+    template <typename RefCount, typename ...Ts>
+    bool operator==(
+        basic_cow_variant<RefCount, Ts...> const& lhs
+      , basic_cow_variant<RefCount, Ts...> const& rhs)
+    {
+        return lhs.value() == rhs.value();
+    }
+
+    template <typename RefCount, typename ...Ts>
+    bool operator!=(
+        basic_cow_variant<RefCount, Ts...> const& lhs
+      , basic_cow_variant<RefCount, Ts...> const& rhs)
+    {
+        return lhs.value() != rhs.value();
+    }
+}}
+
+#include "detail/config/suffix.hpp"
+
+#endif /*EGGS_VARIANT_COW_VARIANT_HPP*/
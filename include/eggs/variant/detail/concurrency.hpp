@@ -0,0 +1,93 @@
+//! \file eggs/variant/detail/concurrency.hpp
+// Eggs.Variant
+//
+// Copyright Agustin K-ballo Berge, Fusion Fenix 2014-2018
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef EGGS_VARIANT_DETAIL_CONCURRENCY_HPP
+#define EGGS_VARIANT_DETAIL_CONCURRENCY_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+
+#include "config/prefix.hpp"
+
+namespace eggs { namespace variants { namespace detail
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // the unit of coherence assumed when padding shared data apart
+    std::size_t const cache_line_size = 64;
+
+    inline std::size_t round_up_pow2(std::size_t n) noexcept
+    {
+        std::size_t result = 1;
+        while (result < n)
+            result <<= 1;
+        return result;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    // a fixed-size array of value-initialized `T`s, allocated with the
+    // alignment of `T` even when it exceeds that of `operator new`
+    template <typename T>
+    class aligned_array
+    {
+    public:
+        explicit aligned_array(std::size_t size)
+          : _buffer(new unsigned char[size * sizeof(T) + alignof(T) - 1])
+          , _data(nullptr)
+          , _size(0)
+        {
+            std::uintptr_t const address =
+                reinterpret_cast<std::uintptr_t>(_buffer);
+            _data = reinterpret_cast<T*>(
+                _buffer + (alignof(T) - address % alignof(T)) % alignof(T));
+
+#if EGGS_CXX11_STD_HAS_IS_NOTHROW_TRAITS
+            static_assert(
+                std::is_nothrow_default_constructible<T>::value
+              , "aligned_array elements shall be nothrow constructible");
+#endif
+            for (; _size < size; ++_size)
+                ::new (_data + _size) T();
+        }
+
+        aligned_array(aligned_array const&) = delete;
+        aligned_array& operator=(aligned_array const&) = delete;
+
+        ~aligned_array()
+        {
+            for (std::size_t i = _size; i > 0; --i)
+                _data[i - 1].~T();
+            delete[] _buffer;
+        }
+
+        std::size_t size() const noexcept
+        {
+            return _size;
+        }
+
+        T& operator[](std::size_t i) noexcept
+        {
+            return _data[i];
+        }
+
+        T const& operator[](std::size_t i) const noexcept
+        {
+            return _data[i];
+        }
+
+    private:
+        unsigned char* _buffer;
+        T* _data;
+        std::size_t _size;
+    };
+}}}
+
+#include "config/suffix.hpp"
+
+#endif /*EGGS_VARIANT_DETAIL_CONCURRENCY_HPP*/
@@ -24,6 +24,24 @@
 
 namespace eggs { namespace variants { namespace detail
 {
+    ///////////////////////////////////////////////////////////////////////////
+    // An alternative may hold its value indirectly, like `boxed<T>` does,
+    // and yet be accessed as that value; `unboxed<T>::type` is the type an
+    // alternative of type `T` is accessed as, and `unboxed<T>::get` yields
+    // it from the member.
+    template <typename T>
+    struct unboxed
+    {
+        using type = T;
+
+        template <typename U>
+        static EGGS_CXX11_CONSTEXPR U& get(U& member) noexcept
+        {
+            return member;
+        }
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
     template <typename Ts, bool IsTriviallyDestructible>
     struct _union;
 
@@ -57,19 +75,21 @@ namespace eggs { namespace variants { namespace detail
             return detail::addressof(_tail);
         }
 
-        EGGS_CXX14_CONSTEXPR T& get(index<0>) noexcept
+        EGGS_CXX14_CONSTEXPR typename unboxed<T>::type& get(index<0>) noexcept
         {
-            return this->_head;
+            return unboxed<T>::get(this->_head);
         }
 
-        EGGS_CXX11_CONSTEXPR T const& get(index<0>) const noexcept
+        EGGS_CXX11_CONSTEXPR typename unboxed<T>::type const& get(
+            index<0>) const noexcept
         {
-            return this->_head;
+            return unboxed<T>::get(this->_head);
         }
 
         template <
             std::size_t I
-          , typename U = typename at_index<I, pack<T, Ts...>>::type
+          , typename U = typename unboxed<
+                typename at_index<I, pack<T, Ts...>>::type>::type
         >
         EGGS_CXX14_CONSTEXPR U& get(index<I>) noexcept
         {
@@ -78,13 +98,29 @@ namespace eggs { namespace variants { namespace detail
 
         template <
             std::size_t I
-          , typename U = typename at_index<I, pack<T, Ts...>>::type
+          , typename U = typename unboxed<
+                typename at_index<I, pack<T, Ts...>>::type>::type
         >
         EGGS_CXX11_CONSTEXPR U const& get(index<I>) const noexcept
         {
             return this->_tail.get(index<I - 1>{});
         }
 
+        // the member itself, rather than the value it is accessed as
+        EGGS_CXX11_CONSTEXPR T const& member(index<0>) const noexcept
+        {
+            return this->_head;
+        }
+
+        template <
+            std::size_t I
+          , typename U = typename at_index<I, pack<T, Ts...>>::type
+        >
+        EGGS_CXX11_CONSTEXPR U const& member(index<I>) const noexcept
+        {
+            return this->_tail.member(index<I - 1>{});
+        }
+
     private:
         union
         {
@@ -120,19 +156,21 @@ namespace eggs { namespace variants { namespace detail
             return detail::addressof(_tail);
         }
 
-        EGGS_CXX14_CONSTEXPR T& get(index<0>) noexcept
+        EGGS_CXX14_CONSTEXPR typename unboxed<T>::type& get(index<0>) noexcept
         {
-            return this->_head;
+            return unboxed<T>::get(this->_head);
         }
 
-        EGGS_CXX11_CONSTEXPR T const& get(index<0>) const noexcept
+        EGGS_CXX11_CONSTEXPR typename unboxed<T>::type const& get(
+            index<0>) const noexcept
         {
-            return this->_head;
+            return unboxed<T>::get(this->_head);
         }
 
         template <
             std::size_t I
-          , typename U = typename at_index<I, pack<T, Ts...>>::type
+          , typename U = typename unboxed<
+                typename at_index<I, pack<T, Ts...>>::type>::type
         >
         EGGS_CXX14_CONSTEXPR U& get(index<I>) noexcept
         {
@@ -141,13 +179,29 @@ namespace eggs { namespace variants { namespace detail
 
         template <
             std::size_t I
-          , typename U = typename at_index<I, pack<T, Ts...>>::type
+          , typename U = typename unboxed<
+                typename at_index<I, pack<T, Ts...>>::type>::type
         >
         EGGS_CXX11_CONSTEXPR U const& get(index<I>) const noexcept
         {
             return this->_tail.get(index<I - 1>{});
         }
 
+        // the member itself, rather than the value it is accessed as
+        EGGS_CXX11_CONSTEXPR T const& member(index<0>) const noexcept
+        {
+            return this->_head;
+        }
+
+        template <
+            std::size_t I
+          , typename U = typename at_index<I, pack<T, Ts...>>::type
+        >
+        EGGS_CXX11_CONSTEXPR U const& member(index<I>) const noexcept
+        {
+            return this->_tail.member(index<I - 1>{});
+        }
+
     private:
         union
         {
@@ -274,7 +328,7 @@ namespace eggs { namespace variants { namespace detail
         {}
 
         template <typename T, std::size_t I, typename ...Args>
-        EGGS_CXX14_CONSTEXPR T& _emplace(
+        EGGS_CXX14_CONSTEXPR typename unboxed<T>::type& _emplace(
             /*is_copy_assignable<Ts...>=*/std::true_type
           , index<I> which, Args&&... args)
         {
@@ -283,20 +337,21 @@ namespace eggs { namespace variants { namespace detail
         }
 
         template <typename T, std::size_t I, typename ...Args>
-        T& _emplace(
+        typename unboxed<T>::type& _emplace(
             /*is_copy_assignable<Ts...>=*/std::false_type
           , index<I> /*which*/, Args&&... args)
         {
             T* ptr = ::new (target()) T(detail::forward<Args>(args)...);
             _which = I;
-            return *ptr;
+            return unboxed<T>::get(*ptr);
         }
 
         template <
             std::size_t I, typename ...Args
           , typename T = typename at_index<I, pack<Ts...>>::type
         >
-        EGGS_CXX14_CONSTEXPR T& emplace(index<I> which, Args&&... args)
+        EGGS_CXX14_CONSTEXPR typename unboxed<T>::type& emplace(
+            index<I> which, Args&&... args)
         {
             using is_copy_assignable = all_of<pack<std::is_copy_assignable<Ts>...>>;
             return _emplace<T>(
@@ -347,6 +402,7 @@ namespace eggs { namespace variants { namespace detail
 
         using base_type::target;
         using base_type::get;
+        using base_type::member;
 
     protected:
         typename smallest_index<sizeof...(Ts)>::type _which;
@@ -436,12 +492,13 @@ namespace eggs { namespace variants { namespace detail
             std::size_t I, typename ...Args
           , typename T = typename at_index<I, pack<Ts...>>::type
         >
-        T& emplace(index<I> /*which*/, Args&&... args)
+        typename unboxed<T>::type& emplace(
+            index<I> /*which*/, Args&&... args)
         {
             _destroy();
             T* ptr = ::new (target()) T(detail::forward<Args>(args)...);
             _which = I;
-            return *ptr;
+            return unboxed<T>::get(*ptr);
         }
 
         _storage& operator=(typename special_member_if<
@@ -529,6 +586,7 @@ namespace eggs { namespace variants { namespace detail
         using base_type::which;
         using base_type::target;
         using base_type::get;
+        using base_type::member;
 
     protected:
         void _destroy(
@@ -585,6 +643,7 @@ namespace eggs { namespace variants { namespace detail
         using base_type::which;
         using base_type::target;
         using base_type::get;
+        using base_type::member;
 
     protected:
         using base_type::_which;
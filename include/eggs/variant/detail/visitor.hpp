@@ -163,7 +163,7 @@ namespace eggs { namespace variants { namespace detail
         template <typename I>
         static EGGS_CXX11_CONSTEXPR bool call(Union const& lhs, Union const& rhs)
         {
-            return lhs.get(I{}) == rhs.get(I{});
+            return lhs.member(I{}) == rhs.member(I{});
         }
     };
 
@@ -174,7 +174,7 @@ namespace eggs { namespace variants { namespace detail
         template <typename I>
         static EGGS_CXX11_CONSTEXPR bool call(Union const& lhs, Union const& rhs)
         {
-            return lhs.get(I{}) != rhs.get(I{});
+            return lhs.member(I{}) != rhs.member(I{});
         }
     };
 
@@ -185,7 +185,7 @@ namespace eggs { namespace variants { namespace detail
         template <typename I>
         static EGGS_CXX11_CONSTEXPR bool call(Union const& lhs, Union const& rhs)
         {
-            return lhs.get(I{}) < rhs.get(I{});
+            return lhs.member(I{}) < rhs.member(I{});
         }
     };
 
@@ -196,7 +196,7 @@ namespace eggs { namespace variants { namespace detail
         template <typename I>
         static EGGS_CXX11_CONSTEXPR bool call(Union const& lhs, Union const& rhs)
         {
-            return lhs.get(I{}) > rhs.get(I{});
+            return lhs.member(I{}) > rhs.member(I{});
         }
     };
 
@@ -207,7 +207,7 @@ namespace eggs { namespace variants { namespace detail
         template <typename I>
         static EGGS_CXX11_CONSTEXPR bool call(Union const& lhs, Union const& rhs)
         {
-            return lhs.get(I{}) <= rhs.get(I{});
+            return lhs.member(I{}) <= rhs.member(I{});
         }
     };
 
@@ -218,7 +218,7 @@ namespace eggs { namespace variants { namespace detail
         template <typename I>
         static EGGS_CXX11_CONSTEXPR bool call(Union const& lhs, Union const& rhs)
         {
-            return lhs.get(I{}) >= rhs.get(I{});
+            return lhs.member(I{}) >= rhs.member(I{});
         }
     };
 
@@ -0,0 +1,218 @@
+//! \file eggs/variant/event_bus.hpp
+// Eggs.Variant
+//
+// Copyright Agustin K-ballo Berge, Fusion Fenix 2014-2018
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef EGGS_VARIANT_EVENT_BUS_HPP
+#define EGGS_VARIANT_EVENT_BUS_HPP
+
+#include "detail/pack.hpp"
+#include "detail/storage.hpp"
+#include "detail/utility.hpp"
+#include "detail/visitor.hpp"
+
+#include "variant.hpp"
+
+#include <cstddef>
+#include <functional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "detail/config/prefix.hpp"
+
+namespace eggs { namespace variants
+{
+    ///////////////////////////////////////////////////////////////////////////
+    //! template <class ...Ts>
+    //! class event_bus;
+    //!
+    //! An `event_bus` routes `variant<Ts...>` events to the handlers
+    //! subscribed to the type of their active member. Handlers are kept in a
+    //! contiguous vector per alternative, so publishing an event costs a
+    //! single jump through a table indexed by `which()`, followed by a loop
+    //! over the handlers of that alternative; no RTTI is involved.
+    //!
+    //! \remarks An `event_bus` is not synchronized. Handlers shall not
+    //!  subscribe nor unsubscribe while an event is being published.
+    template <typename ...Ts>
+    class event_bus
+    {
+        template <typename T>
+        struct _handler
+        {
+            std::size_t id;
+            std::function<void(T const&)> function;
+        };
+
+        using _handlers = std::tuple<std::vector<_handler<Ts>>...>;
+
+        struct _publish
+          : detail::visitor<_publish, void(_handlers const&, void const*)>
+        {
+            template <typename I>
+            static void call(_handlers const& handlers, void const* ptr)
+            {
+                using T = typename detail::at_index<
+                    I::value, detail::pack<Ts...>>::type;
+                T const& event = *static_cast<T const*>(ptr);
+                for (_handler<T> const& handler : std::get<I::value>(handlers))
+                    handler.function(event);
+            }
+        };
+
+        struct _unsubscribe
+          : detail::visitor<_unsubscribe, bool(_handlers&, std::size_t const&)>
+        {
+            template <typename I>
+            static bool call(_handlers& handlers, std::size_t const& id)
+            {
+                using T = typename detail::at_index<
+                    I::value, detail::pack<Ts...>>::type;
+                std::vector<_handler<T>>& vector = std::get<I::value>(handlers);
+                for (std::size_t i = 0; i < vector.size(); ++i)
+                {
+                    if (vector[i].id == id)
+                    {
+                        vector.erase(vector.begin() + i);
+                        return true;
+                    }
+                }
+                return false;
+            }
+        };
+
+    public:
+        //! struct subscription;
+        //!
+        //! A handle to a subscribed handler.
+        struct subscription
+        {
+            std::size_t which;
+            std::size_t id;
+        };
+
+    public:
+        //! event_bus() noexcept;
+        //!
+        //! \effects Constructs an `event_bus` with no handlers.
+        event_bus() noexcept
+          : _handlers_(), _next_id(0)
+        {}
+
+        //! template <std::size_t I, class F>
+        //! subscription subscribe(F&& f);
+        //!
+        //! \requires `I < sizeof...(Ts)`; otherwise, the program is
+        //!  ill-formed. `f` shall be callable with an argument of type
+        //!  `T const&`, where `T` is the `I`th type in `Ts...`.
+        //!
+        //! \effects Adds `std::forward<F>(f)` to the handlers of the `I`th
+        //!  alternative, after those already subscribed.
+        //!
+        //! \returns A `subscription` identifying the handler.
+        template <
+            std::size_t I, typename F
+          , typename T = typename detail::checked_at_index<
+                I, detail::pack<Ts...>>::type
+        >
+        subscription subscribe(F&& f)
+        {
+            _handler<T> handler = {_next_id, detail::forward<F>(f)};
+            std::get<I>(_handlers_).push_back(detail::move(handler));
+            subscription const s = {I, _next_id++};
+            return s;
+        }
+
+        //! template <class T, class F>
+        //! subscription subscribe(F&& f);
+        //!
+        //! \requires The type `T` occurs exactly once in `Ts...`; otherwise,
+        //!  the program is ill-formed.
+        //!
+        //! \effects Equivalent to `return subscribe<I>(std::forward<F>(f));`
+        //!  where `I` is the zero-based index of `T` in `Ts...`.
+        template <
+            typename T, typename F
+          , std::size_t I = detail::checked_index_of<
+                T, detail::pack<Ts...>>::value
+        >
+        subscription subscribe(F&& f)
+        {
+            return subscribe<I>(detail::forward<F>(f));
+        }
+
+        //! bool unsubscribe(subscription s);
+        //!
+        //! \effects Removes the handler identified by `s`, if any.
+        //!
+        //! \returns `true` if a handler was removed; otherwise, `false`.
+        bool unsubscribe(subscription s)
+        {
+            return s.which < sizeof...(Ts)
+                && _unsubscribe{}(
+                    detail::typed_index_pack<detail::pack<Ts...>>{}, s.which
+                  , _handlers_, s.id);
+        }
+
+        //! std::size_t subscribers(std::size_t which) const noexcept;
+        //!
+        //! \returns The number of handlers subscribed to the alternative at
+        //!  index `which`, or `0` if `which` is out of range.
+        std::size_t subscribers(std::size_t which) const noexcept
+        {
+            return _subscribers(
+                which, detail::make_index_pack<sizeof...(Ts)>{});
+        }
+
+        //! void publish(variant<Ts...> const& event) const;
+        //!
+        //! \effects If `event` has an active member, calls each handler
+        //!  subscribed to its alternative with the active member, in the
+        //!  order they were subscribed.
+        void publish(variant<Ts...> const& event) const
+        {
+            std::size_t const which = event.which();
+            if (which != variant<Ts...>::npos)
+            {
+                _publish{}(
+                    detail::typed_index_pack<detail::pack<Ts...>>{}, which
+                  , _handlers_, event.target());
+            }
+        }
+
+        //! template <class InputIt>
+        //! void publish(InputIt first, InputIt last) const;
+        //!
+        //! \requires The value type of `InputIt` shall be `variant<Ts...>`.
+        //!
+        //! \effects Publishes each event in `[first, last)`, in order.
+        template <typename InputIt>
+        void publish(InputIt first, InputIt last) const
+        {
+            for (; first != last; ++first)
+                publish(*first);
+        }
+
+    private:
+        template <std::size_t ...Is>
+        std::size_t _subscribers(
+            std::size_t which, detail::pack_c<std::size_t, Is...>) const noexcept
+        {
+            std::size_t const sizes[] = {std::get<Is>(_handlers_).size()..., 0};
+            return which < sizeof...(Ts) ? sizes[which] : 0;
+        }
+
+    private:
+        _handlers _handlers_;
+        std::size_t _next_id;
+    };
+}}
+
+#include "detail/config/suffix.hpp"
+
+#endif /*EGGS_VARIANT_EVENT_BUS_HPP*/
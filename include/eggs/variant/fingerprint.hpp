@@ -0,0 +1,168 @@
+//! \file eggs/variant/fingerprint.hpp
+// Eggs.Variant
+//
+// Copyright Agustin K-ballo Berge, Fusion Fenix 2014-2018
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef EGGS_VARIANT_FINGERPRINT_HPP
+#define EGGS_VARIANT_FINGERPRINT_HPP
+
+#include "detail/pack.hpp"
+
+#include "variant.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "detail/config/prefix.hpp"
+
+namespace eggs { namespace variants
+{
+    ///////////////////////////////////////////////////////////////////////////
+    //! template <class T>
+    //! struct type_name;
+    //!
+    //! \remarks Users may specialize `type_name<T>` to contribute a stable
+    //!  name for `T` to variant fingerprints. A specialization shall have a
+    //!  `static constexpr char const* value` member designating a
+    //!  null-terminated string usable in constant expressions. The primary
+    //!  template has no `value` member, and then only the size and alignment
+    //!  of `T` contribute to a fingerprint.
+    template <typename T>
+    struct type_name
+    {};
+
+    namespace detail
+    {
+        ///////////////////////////////////////////////////////////////////////
+        std::uint64_t const fnv1a_basis = 14695981039346656037ull;
+
+        EGGS_CXX11_CONSTEXPR inline std::uint64_t fnv1a(
+            std::uint64_t hash, std::uint64_t value, unsigned bytes = 8)
+        {
+            return bytes == 0 ? hash : detail::fnv1a(
+                (hash ^ (value & 0xffu)) * 1099511628211ull,
+                value >> 8, bytes - 1);
+        }
+
+        EGGS_CXX11_CONSTEXPR inline std::uint64_t fnv1a_string(
+            std::uint64_t hash, char const* str)
+        {
+            return *str == '\0' ? hash : detail::fnv1a_string(
+                (hash ^ static_cast<unsigned char>(*str)) * 1099511628211ull,
+                str + 1);
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        template <typename T, typename Enable = void>
+        struct _type_name_fingerprint
+          : std::integral_constant<std::uint64_t, 0>
+        {};
+
+        template <typename T>
+        struct _type_name_fingerprint<T, typename std::enable_if<
+            std::is_convertible<
+                decltype(type_name<T>::value), char const*>::value
+        >::type>
+          : std::integral_constant<std::uint64_t,
+                detail::fnv1a_string(fnv1a_basis, type_name<T>::value)>
+        {};
+
+        template <typename T>
+        struct _type_fingerprint;
+
+        template <typename Ts>
+        struct _pack_fingerprint;
+
+        template <>
+        struct _pack_fingerprint<pack<>>
+          : std::integral_constant<std::uint64_t, fnv1a_basis>
+        {};
+
+        template <typename T, typename ...Ts>
+        struct _pack_fingerprint<pack<T, Ts...>>
+          : std::integral_constant<std::uint64_t, detail::fnv1a(
+                _pack_fingerprint<pack<Ts...>>::value,
+                _type_fingerprint<T>::value)>
+        {};
+
+        // alternatives are hashed by layout and name, nested variants by
+        // their own fingerprint
+        template <typename T>
+        struct _type_fingerprint
+          : std::integral_constant<std::uint64_t, detail::fnv1a(detail::fnv1a(
+                detail::fnv1a(fnv1a_basis, sizeof(T)),
+                std::alignment_of<T>::value),
+                _type_name_fingerprint<T>::value)>
+        {};
+
+        template <typename ...Ts>
+        struct _type_fingerprint<variant<Ts...>>
+          : std::integral_constant<std::uint64_t, detail::fnv1a(
+                _pack_fingerprint<pack<Ts...>>::value, sizeof...(Ts))>
+        {};
+
+        template <typename T>
+        struct _type_fingerprint<T const>
+          : _type_fingerprint<T>
+        {};
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    //! template <class T>
+    //! struct variant_fingerprint;
+    //!
+    //! \remarks All specializations of `variant_fingerprint<T>` shall meet
+    //!  the `UnaryTypeTrait` requirements with a `BaseCharacteristic` of
+    //!  `std::integral_constant<std::uint64_t, N>` for some `N` if `T` is a
+    //!  variant-like type; otherwise it shall be empty.
+    template <typename T>
+    struct variant_fingerprint
+    {};
+
+    //! template <class ...Ts>
+    //! struct variant_fingerprint<variant<Ts...>>;
+    //!
+    //! \remarks Has a `BaseCharacteristic` of `std::integral_constant<
+    //!  std::uint64_t, N>`, where `N` is a hash of `sizeof...(Ts)` and, in
+    //!  order, of the size, the alignment, and the `type_name` of each type
+    //!  in `Ts...`, where nested variants contribute their own fingerprint.
+    //!  `N` depends neither on RTTI nor on the translation unit, so it can be
+    //!  compared across binaries to detect a changed or reordered list of
+    //!  alternatives, subject to hash collisions. Types that differ only in
+    //!  their `type_name` are not distinguished when it is not specialized.
+    template <typename ...Ts>
+    struct variant_fingerprint<variant<Ts...>>
+      : std::integral_constant<
+            std::uint64_t
+          , detail::_type_fingerprint<variant<Ts...>>::value
+        >
+    {};
+
+    //! template <class T>
+    //! struct variant_fingerprint<T const>;
+    //!
+    //! \remarks Let `VF` denote `variant_fingerprint<T>` of the
+    //!  cv-unqualified type `T`. Has a `BaseCharacteristic` of
+    //!  `std::integral_constant<std::uint64_t, VF::value>` if `T` is a
+    //!  variant-like type; otherwise it is empty.
+    template <typename T>
+    struct variant_fingerprint<T const>
+      : variant_fingerprint<T>
+    {};
+
+#if EGGS_CXX14_HAS_VARIABLE_TEMPLATES
+    //! template <class T>
+    //! inline constexpr std::uint64_t variant_fingerprint_v = variant_fingerprint<T>::value;
+    template <typename T>
+    EGGS_CXX17_INLINE EGGS_CXX11_CONSTEXPR std::uint64_t variant_fingerprint_v =
+        variant_fingerprint<T>::value;
+#endif
+}}
+
+#include "detail/config/suffix.hpp"
+
+#endif /*EGGS_VARIANT_FINGERPRINT_HPP*/
@@ -0,0 +1,326 @@
+//! \file eggs/variant/interned_variant.hpp
+// Eggs.Variant
+//
+// Copyright Agustin K-ballo Berge, Fusion Fenix 2014-2018
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef EGGS_VARIANT_INTERNED_VARIANT_HPP
+#define EGGS_VARIANT_INTERNED_VARIANT_HPP
+
+#include "detail/concurrency.hpp"
+#include "detail/storage.hpp"
+#include "detail/utility.hpp"
+#include "detail/visitor.hpp"
+
+#include "variant.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+
+#include "detail/config/prefix.hpp"
+
+namespace eggs { namespace variants
+{
+    ///////////////////////////////////////////////////////////////////////////
+    //! template <class ...Ts>
+    //! class interned_variant;
+    //!
+    //! An `interned_variant` is a pointer-sized handle to an immutable
+    //! `variant<Ts...>` value held in a table shared by all threads, which
+    //! holds a single copy of every distinct value interned. Two handles
+    //! are equal if and only if they refer to the same entry, so comparing
+    //! and hashing them does not look at the values.
+    //!
+    //! A value that does not compare equal to itself, such as one holding a
+    //! floating-point NaN, is interned by the object representation of its
+    //! active member instead, so that interning it again yields the same
+    //! entry.
+    //!
+    //! The table is split into shards by the hash of the value, each guarded
+    //! by its own lock, and every thread caches the entries it interned
+    //! last so that interning a recurring value does not take a lock.
+    //! Entries are never removed; they are destroyed on program exit.
+    //!
+    //! \requires `std::hash<variant<Ts...>>` shall be enabled, and
+    //!  `variant<Ts...>` shall be equality comparable. The active member of
+    //!  an interned value that does not compare equal to itself shall be
+    //!  of a trivially copyable type.
+    template <typename ...Ts>
+    class interned_variant
+    {
+        using _variant = variant<Ts...>;
+
+        struct _entry
+        {
+            _variant value;
+            std::size_t hash;
+        };
+
+        EGGS_CXX11_STATIC_CONSTEXPR std::size_t _shards = 64;
+        EGGS_CXX11_STATIC_CONSTEXPR std::size_t _cached = 64;
+
+        struct alignas(detail::cache_line_size) _shard
+        {
+            std::mutex mutex;
+            std::unordered_multimap<std::size_t, _entry*> entries;
+        };
+
+        struct _table
+        {
+            _shard shards[_shards];
+            std::atomic<std::size_t> size;
+
+            _table() noexcept
+              : size(0)
+            {}
+
+            ~_table()
+            {
+                for (_shard& shard : shards)
+                {
+                    for (auto const& entry : shard.entries)
+                        delete entry.second;
+                }
+            }
+        };
+
+        static _table& _this_table() noexcept
+        {
+            static _table table;
+            return table;
+        }
+
+        static _entry const** _this_thread_cache() noexcept
+        {
+            static thread_local _entry const* cache[_cached] = {};
+            return cache;
+        }
+
+        // whether the active members of two values with the same active
+        // alternative have the same object representation
+        struct _same_representation
+          : detail::visitor<
+                _same_representation, bool(void const*, void const*)>
+        {
+            template <typename T>
+            static bool call(void const* lhs, void const* rhs)
+            {
+                return detail::is_trivially_copyable<T>::value
+                    && std::memcmp(lhs, rhs, sizeof(T)) == 0;
+            }
+        };
+
+        // values that compare equal to themselves are interned by value, and
+        // those that do not by representation
+        static bool _equivalent(
+            _variant const& lhs, _variant const& rhs, bool reflexive)
+        {
+            return reflexive
+              ? lhs == rhs
+              : lhs.which() == rhs.which()
+             && !(lhs == lhs)
+             && _same_representation{}(
+                    detail::pack<Ts...>{}, lhs.which()
+                  , lhs.target(), rhs.target());
+        }
+
+        static _entry const* _intern(_variant&& value)
+        {
+            if (value.which() == _variant::npos)
+                return nullptr;
+
+            std::size_t const hash = std::hash<_variant>()(value);
+            bool const reflexive = value == value;
+
+            _entry const*& cached = _this_thread_cache()[hash % _cached];
+            if (cached != nullptr && cached->hash == hash
+             && _equivalent(cached->value, value, reflexive))
+                return cached;
+
+            _table& table = _this_table();
+            _shard& shard = table.shards[hash % _shards];
+
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            auto range = shard.entries.equal_range(hash);
+            for (; range.first != range.second; ++range.first)
+            {
+                if (_equivalent(range.first->second->value, value, reflexive))
+                    return cached = range.first->second;
+            }
+
+            _entry* entry = new _entry{detail::move(value), hash};
+            shard.entries.emplace(hash, entry);
+            table.size.fetch_add(1, std::memory_order_relaxed);
+            return cached = entry;
+        }
+
+    public:
+        using value_type = _variant;
+
+    public:
+        //! interned_variant() noexcept;
+        //!
+        //! \postconditions `*this` refers to the empty `variant<Ts...>`.
+        interned_variant() noexcept
+          : _ptr(nullptr)
+        {}
+
+        //! template <class U>
+        //! interned_variant(U&& u);
+        //!
+        //! \effects Interns the value of `variant<Ts...>(std::forward<U>(u))`
+        //!  and refers to its entry.
+        //!
+        //! \remarks This constructor shall not participate in overload
+        //!  resolution unless `std::decay_t<U>` is not `interned_variant` and
+        //!  `std::is_constructible_v<variant<Ts...>, U&&>` is `true`.
+        template <
+            typename U
+          , typename Enable = typename std::enable_if<
+                !std::is_same<typename std::decay<U>::type, interned_variant>::value
+             && std::is_constructible<_variant, U&&>::value>::type
+        >
+        interned_variant(U&& u)
+          : _ptr(_intern(_variant(detail::forward<U>(u))))
+        {}
+
+        //! variant<Ts...> const& get() const noexcept;
+        //! variant<Ts...> const& operator*() const noexcept;
+        //!
+        //! \returns A reference to the interned value.
+        _variant const& get() const noexcept
+        {
+            return _ptr != nullptr ? _ptr->value : _empty();
+        }
+
+        _variant const& operator*() const noexcept
+        {
+            return get();
+        }
+
+        //! variant<Ts...> const* operator->() const noexcept;
+        //!
+        //! \returns A pointer to the interned value.
+        _variant const* operator->() const noexcept
+        {
+            return &get();
+        }
+
+        //! explicit operator bool() const noexcept;
+        //!
+        //! \returns `bool(get())`.
+        explicit operator bool() const noexcept
+        {
+            return _ptr != nullptr;
+        }
+
+        //! std::size_t which() const noexcept;
+        //!
+        //! \returns `get().which()`.
+        std::size_t which() const noexcept
+        {
+            return _ptr != nullptr ? _ptr->value.which() : npos;
+        }
+
+        //! template <class T>
+        //! T const* target() const noexcept;
+        //!
+        //! \returns `get().template target<T>()`.
+        template <typename T>
+        T const* target() const noexcept
+        {
+            return get().template target<T>();
+        }
+
+        //! std::size_t hash() const noexcept;
+        //!
+        //! \returns `std::hash<variant<Ts...>>()(get())`, computed when the
+        //!  value was interned.
+        std::size_t hash() const noexcept
+        {
+            return _ptr != nullptr
+              ? _ptr->hash : std::hash<_variant>()(_empty());
+        }
+
+        //! static std::size_t pool_size() noexcept;
+        //!
+        //! \returns The number of distinct values interned so far.
+        static std::size_t pool_size() noexcept
+        {
+            return _this_table().size.load(std::memory_order_relaxed);
+        }
+
+        //! friend bool operator==(interned_variant lhs, interned_variant rhs) noexcept;
+        //! friend bool operator!=(interned_variant lhs, interned_variant rhs) noexcept;
+        //!
+        //! \returns Whether `lhs` and `rhs` refer to the same entry, or its
+        //!  negation. For values that compare equal to themselves, this is
+        //!  equivalent to `*lhs == *rhs`; two handles to a value that does
+        //!  not, such as one holding a NaN, are equal when the values have
+        //!  the same representation even though `*lhs == *rhs` is `false`.
+        friend bool operator==(
+            interned_variant lhs, interned_variant rhs) noexcept
+        {
+            return lhs._ptr == rhs._ptr;
+        }
+
+        friend bool operator!=(
+            interned_variant lhs, interned_variant rhs) noexcept
+        {
+            return lhs._ptr != rhs._ptr;
+        }
+
+    public:
+        //! static constexpr std::size_t npos = std::size_t(-1);
+        EGGS_CXX11_STATIC_CONSTEXPR std::size_t npos = std::size_t(-1);
+
+    private:
+        static _variant const& _empty() noexcept
+        {
+            static _variant const empty;
+            return empty;
+        }
+
+    private:
+        _entry const* _ptr;
+    };
+
+    template <typename ...Ts>
+    std::size_t const interned_variant<Ts...>::npos;
+
+    template <typename ...Ts>
+    std::size_t const interned_variant<Ts...>::_shards;
+
+    template <typename ...Ts>
+    std::size_t const interned_variant<Ts...>::_cached;
+}}
+
+namespace std
+{
+    //! template <class ...Ts>
+    //! struct hash<::eggs::variants::interned_variant<Ts...>>;
+    //!
+    //! For an object `i` of type `interned_variant<Ts...>`,
+    //!  `std::hash<interned_variant<Ts...>>()(i)` evaluates to `i.hash()`.
+    template <typename ...Ts>
+    struct hash< ::eggs::variants::interned_variant<Ts...>>
+    {
+        std::size_t operator()(
+            ::eggs::variants::interned_variant<Ts...> const& i) const noexcept
+        {
+            return i.hash();
+        }
+    };
+}
+
+#include "detail/config/suffix.hpp"
+
+#endif /*EGGS_VARIANT_INTERNED_VARIANT_HPP*/
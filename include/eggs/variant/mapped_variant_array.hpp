@@ -0,0 +1,459 @@
+//! \file eggs/variant/mapped_variant_array.hpp
+// Eggs.Variant
+//
+// Copyright Agustin K-ballo Berge, Fusion Fenix 2014-2018
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef EGGS_VARIANT_MAPPED_VARIANT_ARRAY_HPP
+#define EGGS_VARIANT_MAPPED_VARIANT_ARRAY_HPP
+
+#include "detail/apply.hpp"
+#include "detail/pack.hpp"
+#include "detail/storage.hpp"
+#include "detail/utility.hpp"
+
+#include "bad_variant_access.hpp"
+#include "fingerprint.hpp"
+#include "serialization.hpp"
+#include "variant.hpp"
+
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <type_traits>
+
+#include "detail/config/prefix.hpp"
+
+namespace eggs { namespace variants
+{
+    namespace detail
+    {
+        ///////////////////////////////////////////////////////////////////////
+        template <std::size_t ...Vs>
+        struct max_of;
+
+        template <>
+        struct max_of<>
+          : std::integral_constant<std::size_t, 1>
+        {};
+
+        template <std::size_t V, std::size_t ...Vs>
+        struct max_of<V, Vs...>
+          : std::integral_constant<
+                std::size_t
+              , (V > max_of<Vs...>::value) ? V : max_of<Vs...>::value
+            >
+        {};
+
+        ///////////////////////////////////////////////////////////////////////
+        // A view of an element of a mapped array that satisfies the interface
+        // of `storage` used by `apply`, `which()` is `0` for no active member.
+        template <typename ...Ts>
+        struct mapped_element
+        {
+            EGGS_CXX11_STATIC_CONSTEXPR std::size_t size = 1 + sizeof...(Ts);
+
+            EGGS_CXX11_CONSTEXPR std::size_t which() const noexcept
+            {
+                return _which;
+            }
+
+            EGGS_CXX11_CONSTEXPR void const* target() const noexcept
+            {
+                return _ptr;
+            }
+
+            template <
+                std::size_t I
+              , typename T = typename at_index<I, pack<empty, Ts...>>::type
+            >
+            T const& get(index<I>) const noexcept
+            {
+                return *static_cast<T const*>(_ptr);
+            }
+
+            std::size_t _which;
+            void const* _ptr;
+        };
+
+        struct mapped_header
+        {
+            unsigned char magic[8];
+            std::uint32_t endianness;
+            std::uint32_t slot_size;
+            std::uint64_t fingerprint;
+            std::uint64_t count;
+            std::uint64_t payload_offset;
+        };
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    //! template <class ...Ts>
+    //! class mapped_variant_array;
+    //!
+    //! A `mapped_variant_array` is a read-only view of an array of
+    //! `variant<Ts...>` values stored in a relocatable format, suitable to
+    //! be memory mapped from a file and accessed in place without parsing.
+    //!
+    //! The format consists of a header, an array of one byte discriminators
+    //! (`0` for no active member, `I + 1` for an active member at index
+    //! `I`), and an array of fixed-size slots, each suitably aligned for the
+    //! types `Ts...`, holding the object representation of the active
+    //! members. The header records the byte order of the writer and the
+    //! `variant_fingerprint` of `variant<Ts...>`, and mismatched
+    //! images are rejected when mapped.
+    //!
+    //! All `T` in `Ts...` shall be trivially copyable.
+    template <typename ...Ts>
+    class mapped_variant_array
+    {
+        static_assert(
+            detail::all_of<detail::pack<
+                detail::is_trivially_copyable<Ts>...>>::value
+          , "mapped_variant_array alternatives shall be trivially copyable");
+
+        static_assert(
+            sizeof...(Ts) < UCHAR_MAX
+          , "mapped_variant_array has too many alternatives");
+
+        using _element = detail::mapped_element<Ts...>;
+
+        EGGS_CXX11_STATIC_CONSTEXPR std::size_t _slot_align =
+            detail::max_of<std::alignment_of<Ts>::value...>::value;
+
+        EGGS_CXX11_STATIC_CONSTEXPR std::size_t _slot_size =
+            (detail::max_of<sizeof(Ts)...>::value + _slot_align - 1)
+                / _slot_align * _slot_align;
+
+        static EGGS_CXX11_CONSTEXPR std::size_t _payload_offset(
+            std::size_t count) noexcept
+        {
+            return (sizeof(detail::mapped_header) + count + _slot_align - 1)
+                / _slot_align * _slot_align;
+        }
+
+        static detail::mapped_header _header(std::size_t count) noexcept
+        {
+            detail::mapped_header header;
+            std::memcpy(header.magic, "EGGSVMA", 8);
+            header.endianness = 0x01020304u;
+            header.slot_size = _slot_size;
+            header.fingerprint = fingerprint;
+            header.count = count;
+            header.payload_offset = _payload_offset(count);
+            return header;
+        }
+
+        struct _write_slot
+          : detail::visitor<_write_slot, void(unsigned char*, void const*)>
+        {
+            template <typename T>
+            static void call(unsigned char* slot, void const* ptr)
+            {
+                std::memcpy(slot, ptr, sizeof(T));
+            }
+        };
+
+    public:
+        //! static constexpr std::size_t npos = std::size_t(-1);
+        EGGS_CXX11_STATIC_CONSTEXPR std::size_t npos = std::size_t(-1);
+
+        //! static constexpr std::uint64_t fingerprint =
+        //!     variant_fingerprint<variant<Ts...>>::value;
+        //!
+        //! The fingerprint recorded in the header of every image.
+        EGGS_CXX11_STATIC_CONSTEXPR std::uint64_t fingerprint =
+            variant_fingerprint<variant<Ts...>>::value;
+
+        //! static constexpr std::size_t alignment = unspecified;
+        //!
+        //! The alignment required of the start of an image.
+        EGGS_CXX11_STATIC_CONSTEXPR std::size_t alignment =
+            _slot_align > std::alignment_of<detail::mapped_header>::value
+              ? _slot_align : std::alignment_of<detail::mapped_header>::value;
+
+    public:
+        //! static constexpr std::size_t image_size(std::size_t count) noexcept;
+        //!
+        //! \returns The size in bytes of an image holding `count` elements.
+        static EGGS_CXX11_CONSTEXPR std::size_t image_size(
+            std::size_t count) noexcept
+        {
+            return _payload_offset(count) + count * _slot_size;
+        }
+
+        //! template <class ForwardIt, class OutputIt>
+        //! static OutputIt write(ForwardIt first, ForwardIt last, OutputIt out);
+        //!
+        //! \requires The value type of `ForwardIt` shall be `variant<Ts...>`.
+        //!  `OutputIt` shall be an output iterator that accepts `unsigned
+        //!  char`.
+        //!
+        //! \effects Writes to `out` an image of the elements in `[first,
+        //!  last)`, of size `image_size(std::distance(first, last))`. Bytes
+        //!  not occupied by an active member are written as zeros.
+        //!
+        //! \returns The advanced output iterator.
+        template <typename ForwardIt, typename OutputIt>
+        static OutputIt write(ForwardIt first, ForwardIt last, OutputIt out)
+        {
+            std::size_t const count =
+                static_cast<std::size_t>(std::distance(first, last));
+
+            detail::mapped_header const header = _header(count);
+            unsigned char const* header_bytes =
+                reinterpret_cast<unsigned char const*>(&header);
+            out = std::copy(header_bytes, header_bytes + sizeof(header), out);
+
+            for (ForwardIt it = first; it != last; ++it)
+            {
+                *out = static_cast<unsigned char>(
+                    detail::access::storage(*it).which());
+                ++out;
+            }
+            for (std::size_t i = sizeof(header) + count;
+                    i < header.payload_offset; ++i)
+            {
+                *out = 0;
+                ++out;
+            }
+
+            for (ForwardIt it = first; it != last; ++it)
+            {
+                unsigned char slot[_slot_size] = {};
+                if (it->which() != npos)
+                {
+                    _write_slot{}(
+                        detail::pack<Ts...>{}, it->which()
+                      , slot, it->target());
+                }
+                out = std::copy(slot, slot + _slot_size, out);
+            }
+            return out;
+        }
+
+    public:
+        //! mapped_variant_array() noexcept;
+        //!
+        //! \postconditions `size() == 0`.
+        mapped_variant_array() noexcept
+          : _whiches(nullptr), _slots(nullptr), _size(0)
+        {}
+
+        //! mapped_variant_array(void const* data, std::size_t size);
+        //!
+        //! \effects Equivalent to calling `map(data, size)`.
+        //!
+        //! \throws `bad_variant_decode` if `map(data, size)` fails.
+        mapped_variant_array(void const* data, std::size_t size)
+          : _whiches(nullptr), _slots(nullptr), _size(0)
+        {
+            decode_status const status = map(data, size);
+            if (status != decode_status::ok)
+                detail::throw_bad_variant_decode<void>(status);
+        }
+
+        //! decode_status map(void const* data, std::size_t size) noexcept;
+        //!
+        //! \requires `data` shall point to `size` readable bytes, which shall
+        //!  remain valid and unchanged for as long as they are accessed
+        //!  through `*this`.
+        //!
+        //! \effects Validates the image in `[data, data + size)` and, if
+        //!  successful, makes `*this` a view of its elements; otherwise,
+        //!  `*this` is left unchanged. The validation checks the header, the
+        //!  bounds of the arrays, and the range of every discriminator; no
+        //!  element is copied.
+        //!
+        //! \returns `decode_status::ok` if successful; `decode_status::
+        //!  incomplete` if the image is truncated; otherwise, `decode_status::
+        //!  malformed`, in particular if `data` is not aligned to
+        //!  `alignment`, or if the image was written with a different byte
+        //!  order or for alternatives with a different fingerprint.
+        decode_status map(void const* data, std::size_t size) noexcept
+        {
+            if (size < sizeof(detail::mapped_header))
+                return decode_status::incomplete;
+            if (reinterpret_cast<std::uintptr_t>(data) % alignment != 0)
+                return decode_status::malformed;
+
+            detail::mapped_header header;
+            std::memcpy(&header, data, sizeof(header));
+            if (std::memcmp(header.magic, "EGGSVMA", 8) != 0
+             || header.endianness != 0x01020304u
+             || header.fingerprint != fingerprint
+             || header.slot_size != _slot_size)
+            {
+                return decode_status::malformed;
+            }
+
+            std::uint64_t const count = header.count;
+            if (count > size || header.payload_offset != _payload_offset(
+                    static_cast<std::size_t>(count)))
+            {
+                return decode_status::malformed;
+            }
+            if (count > size - sizeof(header)
+             || header.payload_offset > size
+             || (size - header.payload_offset) / _slot_size < count)
+            {
+                return decode_status::incomplete;
+            }
+
+            unsigned char const* bytes = static_cast<unsigned char const*>(data);
+            unsigned char const* whiches = bytes + sizeof(header);
+            unsigned char max_which = 0;
+            for (std::size_t i = 0; i < count; ++i)
+                max_which = whiches[i] > max_which ? whiches[i] : max_which;
+            if (max_which > sizeof...(Ts))
+                return decode_status::malformed;
+
+            _whiches = whiches;
+            _slots = bytes + header.payload_offset;
+            _size = static_cast<std::size_t>(count);
+            return decode_status::ok;
+        }
+
+        //! std::size_t size() const noexcept;
+        //!
+        //! \returns The number of elements in the array.
+        std::size_t size() const noexcept
+        {
+            return _size;
+        }
+
+        //! bool empty() const noexcept;
+        //!
+        //! \returns `size() == 0`.
+        bool empty() const noexcept
+        {
+            return _size == 0;
+        }
+
+        //! std::size_t which(std::size_t i) const noexcept;
+        //!
+        //! \requires `i < size()`.
+        //!
+        //! \returns The zero-based index of the active member of the `i`th
+        //!  element if it has one. Otherwise, returns `npos`.
+        std::size_t which(std::size_t i) const noexcept
+        {
+            return std::size_t(_whiches[i]) - 1;
+        }
+
+        //! void const* target(std::size_t i) const noexcept;
+        //!
+        //! \requires `i < size()`.
+        //!
+        //! \returns If the `i`th element has an active member, a pointer to
+        //!  the active member; otherwise a null pointer.
+        void const* target(std::size_t i) const noexcept
+        {
+            return _whiches[i] != 0 ? _slots + i * _slot_size : nullptr;
+        }
+
+        //! template <std::size_t I>
+        //! variant_element_t<I, variant<Ts...>> const* get_if(std::size_t i) const noexcept;
+        //!
+        //! \requires `i < size()`. `I < sizeof...(Ts)`; otherwise, the program
+        //!  is ill-formed.
+        //!
+        //! \returns A pointer to the `I`th member of the `i`th element if it
+        //!  is active, where indexing is zero-based. Otherwise, returns a null
+        //!  pointer.
+        template <
+            std::size_t I
+          , typename T = typename detail::checked_at_index<
+                I, detail::pack<Ts...>>::type
+        >
+        T const* get_if(std::size_t i) const noexcept
+        {
+            return _whiches[i] == I + 1
+              ? reinterpret_cast<T const*>(_slots + i * _slot_size)
+              : nullptr;
+        }
+
+        //! template <class T>
+        //! T const* get_if(std::size_t i) const noexcept;
+        //!
+        //! \requires `i < size()`. The type `T` occurs exactly once in
+        //!  `Ts...`; otherwise, the program is ill-formed.
+        //!
+        //! \effects Equivalent to `return get_if<I>(i);` where `I` is the
+        //!  zero-based index of `T` in `Ts...`.
+        template <
+            typename T
+          , std::size_t I = detail::checked_index_of<
+                T, detail::pack<typename std::remove_cv<Ts>::type...>>::value
+        >
+        T const* get_if(std::size_t i) const noexcept
+        {
+            return get_if<I>(i);
+        }
+
+        //! template <class R, class F>
+        //! R apply(F&& f, std::size_t i) const;
+        //!
+        //! \requires `i < size()`.
+        //!
+        //! \effects Equivalent to `INVOKE(std::forward<F>(f), *get_if<I>(i),
+        //!  R)` where `I` is the zero-based index of the active member of the
+        //!  `i`th element.
+        //!
+        //! \throws `bad_variant_access` if the `i`th element has no active
+        //!  member.
+        template <typename R, typename F>
+        R apply(F&& f, std::size_t i) const
+        {
+            return _whiches[i] != 0
+              ? detail::apply<R>(detail::forward<F>(f), _at(i))
+              : detail::throw_bad_variant_access<R>();
+        }
+
+        //! template <class F>
+        //! R apply(F&& f, std::size_t i) const;
+        //!
+        //! Let `R` be the common return type of every potentially evaluated
+        //!  `INVOKE` expression.
+        //!
+        //! \effects Equivalent to `apply<R>(std::forward<F>(f), i)`.
+        template <
+            int DeductionGuard = 0, typename F
+          , typename R = typename detail::apply_result<
+                F, detail::pack<_element const&>>::type
+        >
+        R apply(F&& f, std::size_t i) const
+        {
+            return apply<R>(detail::forward<F>(f), i);
+        }
+
+    private:
+        _element _at(std::size_t i) const noexcept
+        {
+            _element element = {_whiches[i], _slots + i * _slot_size};
+            return element;
+        }
+
+    private:
+        unsigned char const* _whiches;
+        unsigned char const* _slots;
+        std::size_t _size;
+    };
+
+    template <typename ...Ts>
+    std::size_t const mapped_variant_array<Ts...>::npos;
+
+    template <typename ...Ts>
+    std::uint64_t const mapped_variant_array<Ts...>::fingerprint;
+
+    template <typename ...Ts>
+    std::size_t const mapped_variant_array<Ts...>::alignment;
+}}
+
+#include "detail/config/suffix.hpp"
+
+#endif /*EGGS_VARIANT_MAPPED_VARIANT_ARRAY_HPP*/
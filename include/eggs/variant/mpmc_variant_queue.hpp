@@ -0,0 +1,234 @@
+//! \file eggs/variant/mpmc_variant_queue.hpp
+// Eggs.Variant
+//
+// Copyright Agustin K-ballo Berge, Fusion Fenix 2014-2018
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef EGGS_VARIANT_MPMC_VARIANT_QUEUE_HPP
+#define EGGS_VARIANT_MPMC_VARIANT_QUEUE_HPP
+
+#include "detail/apply.hpp"
+#include "detail/concurrency.hpp"
+#include "detail/pack.hpp"
+#include "detail/storage.hpp"
+#include "detail/utility.hpp"
+
+#include "variant.hpp"
+
+#include <atomic>
+#include <cstddef>
+
+#include "detail/config/prefix.hpp"
+
+namespace eggs { namespace variants
+{
+    ///////////////////////////////////////////////////////////////////////////
+    //! template <class ...Ts>
+    //! class mpmc_variant_queue;
+    //!
+    //! A `mpmc_variant_queue` is a bounded lock-free queue of `variant<Ts...>`
+    //! elements shared by any number of producer and consumer threads. Each
+    //! cell holds the storage of a `variant<Ts...>` and a sequence number
+    //! that tells whether the cell is ready to be written or read at a given
+    //! position; producers and consumers claim positions by advancing a
+    //! shared counter, then construct or visit the element in place.
+    //!
+    //! \remarks A thread that claims a position and is then suspended
+    //!  before completing its operation delays consumers of that position,
+    //!  but no other thread.
+    template <typename ...Ts>
+    class mpmc_variant_queue
+    {
+        struct alignas(detail::cache_line_size) _cell
+        {
+            std::atomic<std::size_t> sequence;
+            detail::storage<Ts...> storage;
+        };
+
+        struct alignas(detail::cache_line_size) _position
+        {
+            std::atomic<std::size_t> value;
+        };
+
+        // makes a claimed cell available at the next lap, even if the
+        // construction or the visitation of its element exits via an
+        // exception
+        class _release_guard
+        {
+        public:
+            _release_guard(_cell& cell, std::size_t sequence) noexcept
+              : _cell_(cell), _sequence(sequence)
+            {}
+
+            _release_guard(_release_guard const&) = delete;
+            _release_guard& operator=(_release_guard const&) = delete;
+
+            ~_release_guard()
+            {
+                _cell_.sequence.store(_sequence, std::memory_order_release);
+            }
+
+        private:
+            _cell& _cell_;
+            std::size_t _sequence;
+        };
+
+        struct _consume_guard
+        {
+            ~_consume_guard()
+            {
+                storage.emplace(detail::index<0>{});
+            }
+
+            detail::storage<Ts...>& storage;
+        };
+
+    public:
+        //! explicit mpmc_variant_queue(std::size_t capacity);
+        //!
+        //! \effects Constructs an empty queue that holds at least `capacity`
+        //!  elements.
+        explicit mpmc_variant_queue(std::size_t capacity)
+          : _cells(detail::round_up_pow2(capacity > 1 ? capacity : 2))
+          , _mask(_cells.size() - 1)
+        {
+            for (std::size_t i = 0; i < _cells.size(); ++i)
+                _cells[i].sequence.store(i, std::memory_order_relaxed);
+            _enqueue.value.store(0, std::memory_order_relaxed);
+            _dequeue.value.store(0, std::memory_order_relaxed);
+        }
+
+        mpmc_variant_queue(mpmc_variant_queue const&) = delete;
+        mpmc_variant_queue& operator=(mpmc_variant_queue const&) = delete;
+
+        //! std::size_t capacity() const noexcept;
+        //!
+        //! \returns The maximum number of elements the queue can hold.
+        std::size_t capacity() const noexcept
+        {
+            return _cells.size();
+        }
+
+        //! template <std::size_t I, class ...Args>
+        //! bool try_emplace(Args&&... args);
+        //!
+        //! \requires `I < sizeof...(Ts)`; otherwise, the program is
+        //!  ill-formed.
+        //!
+        //! \effects If the queue is not full, claims the next position and
+        //!  constructs the `I`th member of a `variant<Ts...>` in its cell with
+        //!  `std::forward<Args>(args)...`.
+        //!
+        //! \returns `true` if an element was constructed; otherwise, `false`.
+        //!
+        //! \remarks If the initialization of the member exits via an
+        //!  exception, the claimed position holds no element and consumers
+        //!  skip it.
+        template <
+            std::size_t I, typename ...Args
+          , typename T = typename detail::checked_at_index<
+                I, detail::pack<Ts...>>::type
+        >
+        bool try_emplace(Args&&... args)
+        {
+            std::size_t position = _enqueue.value.load(std::memory_order_relaxed);
+            for (;;)
+            {
+                _cell& cell = _cells[position & _mask];
+                std::ptrdiff_t const lag = static_cast<std::ptrdiff_t>(
+                    cell.sequence.load(std::memory_order_acquire) - position);
+                if (lag == 0)
+                {
+                    if (_enqueue.value.compare_exchange_weak(
+                            position, position + 1, std::memory_order_relaxed))
+                    {
+                        _release_guard guard(cell, position + 1);
+                        cell.storage.emplace(
+                            detail::index<I + 1>{}, detail::forward<Args>(args)...);
+                        return true;
+                    }
+                } else if (lag < 0) {
+                    return false; // the cell is a lap behind, full
+                } else {
+                    position = _enqueue.value.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        //! template <class T, class ...Args>
+        //! bool try_emplace(Args&&... args);
+        //!
+        //! \requires The type `T` occurs exactly once in `Ts...`; otherwise,
+        //!  the program is ill-formed.
+        //!
+        //! \effects Equivalent to `return try_emplace<I>(std::forward<Args>(
+        //!  args)...);` where `I` is the zero-based index of `T` in `Ts...`.
+        template <
+            typename T, typename ...Args
+          , std::size_t I = detail::checked_index_of<
+                T, detail::pack<Ts...>>::value
+        >
+        bool try_emplace(Args&&... args)
+        {
+            return try_emplace<I>(detail::forward<Args>(args)...);
+        }
+
+        //! template <class F>
+        //! bool try_consume(F&& f);
+        //!
+        //! \effects If the queue is not empty, claims the oldest position
+        //!  and calls `INVOKE(std::forward<F>(f), m)`, where `m` is an lvalue
+        //!  that designates the active member of its element in place, and
+        //!  then destroys the element. `f` may move from `m`.
+        //!
+        //! \returns `true` if an element was consumed; otherwise, `false`.
+        //!
+        //! \remarks If `f` exits via an exception, the element is destroyed
+        //!  and its position is released nonetheless.
+        template <typename F>
+        bool try_consume(F&& f)
+        {
+            std::size_t position = _dequeue.value.load(std::memory_order_relaxed);
+            for (;;)
+            {
+                _cell& cell = _cells[position & _mask];
+                std::ptrdiff_t const lag = static_cast<std::ptrdiff_t>(
+                    cell.sequence.load(std::memory_order_acquire) - (position + 1));
+                if (lag == 0)
+                {
+                    if (_dequeue.value.compare_exchange_weak(
+                            position, position + 1, std::memory_order_relaxed))
+                    {
+                        _release_guard guard(cell, position + _mask + 1);
+                        if (cell.storage.which() == 0)
+                        {
+                            // a producer failed to construct this element
+                            position = position + 1;
+                            continue;
+                        }
+
+                        _consume_guard consume = {cell.storage};
+                        detail::apply<void>(detail::forward<F>(f), cell.storage);
+                        return true;
+                    }
+                } else if (lag < 0) {
+                    return false; // the cell has not been written, empty
+                } else {
+                    position = _dequeue.value.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+    private:
+        detail::aligned_array<_cell> _cells;
+        std::size_t const _mask;
+        _position _enqueue;
+        _position _dequeue;
+    };
+}}
+
+#include "detail/config/suffix.hpp"
+
+#endif /*EGGS_VARIANT_MPMC_VARIANT_QUEUE_HPP*/
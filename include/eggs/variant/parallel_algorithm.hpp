@@ -0,0 +1,508 @@
+//! \file eggs/variant/parallel_algorithm.hpp
+// Eggs.Variant
+//
+// Copyright Agustin K-ballo Berge, Fusion Fenix 2014-2018
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef EGGS_VARIANT_PARALLEL_ALGORITHM_HPP
+#define EGGS_VARIANT_PARALLEL_ALGORITHM_HPP
+
+#include "detail/pack.hpp"
+#include "detail/utility.hpp"
+#include "detail/visitor.hpp"
+
+#include "algorithm.hpp"
+#include "task_variant.hpp"
+#include "variant.hpp"
+#include "work_stealing_pool.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "detail/config/prefix.hpp"
+
+namespace eggs { namespace variants
+{
+    namespace detail
+    {
+        // a chunk of the work of any parallel algorithm, so that the chunks
+        // of every algorithm can run on the same pool
+        struct _chunk_task
+        {
+            void (*run)(void*, std::size_t);
+            void* body;
+            std::size_t chunk;
+
+            void operator()() const
+            {
+                run(body, chunk);
+            }
+        };
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    //! using parallel_pool = work_stealing_pool<unspecified>;
+    //!
+    //! A pool of worker threads on which the parallel algorithms can run,
+    //! so that repeated calls do not start and join threads of their own.
+    using parallel_pool = work_stealing_pool<task_variant<detail::_chunk_task>>;
+
+    namespace detail
+    {
+        ///////////////////////////////////////////////////////////////////////
+        // the number of elements handled by a single task; it depends on
+        // nothing else, so that the grouping of a reduction is deterministic
+        std::size_t const parallel_chunk_size = 16384;
+
+        template <typename V>
+        struct _variant_members;
+
+        template <typename ...Ts>
+        struct _variant_members<variant<Ts...>>
+        {
+            using type = pack<Ts...>;
+        };
+
+        template <typename ...Ts>
+        struct _variant_members<variant<Ts...> const>
+        {
+            using type = pack<Ts const...>;
+        };
+
+        template <typename Sink, typename Iterator, typename Ts>
+        struct _apply_bucket;
+
+        template <typename Sink, typename Iterator, typename ...Ts>
+        struct _apply_bucket<Sink, Iterator, pack<Ts...>>
+          : visitor<
+                _apply_bucket<Sink, Iterator, pack<Ts...>>
+              , void(Sink&, Iterator const&, std::uint32_t const*
+                  , std::uint32_t const*)
+            >
+        {
+            // members are accessed as the type they hold, see `unboxed`
+            template <typename I>
+            static void call(Sink& sink, Iterator const& first,
+                std::uint32_t const* pos, std::uint32_t const* last)
+            {
+                for (; pos != last; ++pos)
+                    sink(access::get(*(first + *pos), index<I::value>{}));
+            }
+        };
+
+        // Elements of a chunk are bucketed by the index of their active
+        // member, and each bucket is then visited in a loop specialized for
+        // its type, so that dispatch happens once per bucket rather than
+        // once per element.
+        template <typename Sink, typename Iterator>
+        void apply_chunk(Sink& sink, Iterator first, std::size_t size)
+        {
+            using variant_type = typename iterator_variant<Iterator>::type;
+            using members = typename _variant_members<variant_type>::type;
+            EGGS_CXX11_STATIC_CONSTEXPR std::size_t N =
+                iterator_variant_size<Iterator>::value;
+
+            // `bounds[b]` is the start of the bucket of internal
+            // discriminator `b`, `0` for no active member
+            std::array<std::uint32_t, N + 2> bounds = {};
+            for (std::size_t i = 0; i < size; ++i)
+                ++bounds[detail::which_of(first + i) + 1];
+            for (std::size_t b = 1; b < N + 2; ++b)
+                bounds[b] += bounds[b - 1];
+
+            std::vector<std::uint32_t> order(size);
+            std::array<std::uint32_t, N + 2> heads = bounds;
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                order[heads[detail::which_of(first + i)]++] =
+                    static_cast<std::uint32_t>(i);
+            }
+
+            for (std::size_t b = 1; b < N + 1; ++b)
+            {
+                if (bounds[b] != bounds[b + 1])
+                {
+                    _apply_bucket<Sink, Iterator, members>{}(
+                        typed_index_pack<members>{}, b - 1
+                      , sink, first
+                      , order.data() + bounds[b], order.data() + bounds[b + 1]);
+                }
+            }
+        }
+
+        template <typename Body>
+        void _run_chunk(void* body, std::size_t chunk)
+        {
+            (*static_cast<Body*>(body))(chunk);
+        }
+
+        template <typename Body>
+        void parallel_chunks(
+            std::size_t chunks, parallel_pool& pool, Body& body)
+        {
+            if (pool.size() <= 1 || chunks <= 1)
+            {
+                for (std::size_t c = 0; c < chunks; ++c)
+                    body(c);
+                return;
+            }
+
+            for (std::size_t c = 0; c < chunks; ++c)
+                pool.submit(_chunk_task{&_run_chunk<Body>, &body, c});
+            pool.wait();
+        }
+
+        template <typename Body>
+        void parallel_chunks(
+            std::size_t chunks, std::size_t threads, Body& body)
+        {
+            if (threads <= 1 || chunks <= 1)
+            {
+                for (std::size_t c = 0; c < chunks; ++c)
+                    body(c);
+                return;
+            }
+
+            parallel_pool pool(threads < chunks ? threads : chunks);
+            detail::parallel_chunks(chunks, pool, body);
+        }
+
+        template <typename F, typename Iterator>
+        struct _apply_each_body
+        {
+            F& f;
+            Iterator first;
+            std::size_t size;
+
+            void operator()(std::size_t chunk) const
+            {
+                std::size_t const offset = chunk * parallel_chunk_size;
+                std::size_t const rest = size - offset;
+                detail::apply_chunk(f, first + offset,
+                    rest < parallel_chunk_size ? rest : parallel_chunk_size);
+            }
+        };
+
+        template <typename R, typename F, typename Op>
+        struct _reduce_sink
+        {
+            F& f;
+            Op& op;
+            variant<R> partial;
+
+            template <typename T>
+            void operator()(T& member)
+            {
+                if (R* acc = partial.template target<R>())
+                {
+                    *acc = op(detail::move(*acc), f(member));
+                } else {
+                    partial.template emplace<0>(f(member));
+                }
+            }
+        };
+
+        template <typename R, typename F, typename Op, typename Iterator>
+        struct _apply_reduce_body
+        {
+            F& f;
+            Op& op;
+            Iterator first;
+            std::size_t size;
+            std::vector<variant<R>>& partials;
+
+            void operator()(std::size_t chunk) const
+            {
+                std::size_t const offset = chunk * parallel_chunk_size;
+                std::size_t const rest = size - offset;
+                _reduce_sink<R, F, Op> sink = {f, op, variant<R>()};
+                detail::apply_chunk(sink, first + offset,
+                    rest < parallel_chunk_size ? rest : parallel_chunk_size);
+                partials[chunk] = detail::move(sink.partial);
+            }
+        };
+
+        ///////////////////////////////////////////////////////////////////////
+        // Every element of a segment holds an active member of the same
+        // type, so the kernel is a plain loop over members of that type,
+        // with no dispatch and no check for empty partial results.
+        template <typename R, typename F, typename Op, typename Iterator>
+        struct _reduce_segment
+          : visitor<
+                _reduce_segment<R, F, Op, Iterator>
+              , void(F&, Op&, Iterator const&, Iterator const&, variant<R>&)
+            >
+        {
+            // members are accessed as the type they hold, see `unboxed`
+            template <typename I>
+            static void call(F& f, Op& op,
+                Iterator const& first, Iterator const& last, variant<R>& out)
+            {
+                Iterator it = first;
+                R acc = f(access::get(*it, index<I::value>{}));
+                for (++it; it != last; ++it)
+                    acc = op(detail::move(acc), f(access::get(*it, index<I::value>{})));
+                out.template emplace<0>(detail::move(acc));
+            }
+        };
+
+        template <typename R, typename F, typename Op, typename Iterator, std::size_t N>
+        struct _reduce_by_type_body
+        {
+            F& f;
+            Op& op;
+            which_partition<Iterator, N> const& partition;
+            // `starts[I]` is the first task of the `I`th alternative
+            std::array<std::size_t, N + 1> const& starts;
+            std::vector<variant<R>>& partials;
+
+            void operator()(std::size_t task) const
+            {
+                std::size_t which = 0;
+                while (starts[which + 1] <= task)
+                    ++which;
+
+                subrange<Iterator> const segment = partition[which];
+                std::size_t const offset =
+                    (task - starts[which]) * parallel_chunk_size;
+                std::size_t const rest = segment.size() - offset;
+                Iterator const first = segment.begin() + offset;
+                Iterator const last = first
+                  + (rest < parallel_chunk_size ? rest : parallel_chunk_size);
+
+                using members = typename _variant_members<
+                    typename iterator_variant<Iterator>::type>::type;
+                _reduce_segment<R, F, Op, Iterator>{}(
+                    typed_index_pack<members>{}, which
+                  , f, op, first, last, partials[task]);
+            }
+        };
+
+        ///////////////////////////////////////////////////////////////////////
+        template <typename F, typename Range, typename Threads>
+        void parallel_apply_each(F& f, Range& range, Threads& threads)
+        {
+            using iterator = decltype(std::begin(range));
+            static_assert(
+                detail::is_random_access_iterator<iterator>::value
+              , "parallel_apply_each requires a random access range");
+
+            iterator const first = std::begin(range);
+            std::size_t const size =
+                static_cast<std::size_t>(std::end(range) - first);
+            std::size_t const chunks = (size + detail::parallel_chunk_size - 1)
+                / detail::parallel_chunk_size;
+
+            detail::_apply_each_body<F, iterator> body = {f, first, size};
+            detail::parallel_chunks(chunks, threads, body);
+        }
+
+        template <typename R, typename F, typename Range, typename Op, typename Threads>
+        R parallel_apply_reduce(F& f, Range& range, R init, Op& op, Threads& threads)
+        {
+            using iterator = decltype(std::begin(range));
+            static_assert(
+                detail::is_random_access_iterator<iterator>::value
+              , "parallel_apply_reduce requires a random access range");
+
+            iterator const first = std::begin(range);
+            std::size_t const size =
+                static_cast<std::size_t>(std::end(range) - first);
+            std::size_t const chunks = (size + detail::parallel_chunk_size - 1)
+                / detail::parallel_chunk_size;
+
+            std::vector<variant<R>> partials(chunks);
+            detail::_apply_reduce_body<R, F, Op, iterator> body =
+                {f, op, first, size, partials};
+            detail::parallel_chunks(chunks, threads, body);
+
+            for (variant<R>& partial : partials)
+            {
+                if (R* value = partial.template target<R>())
+                    init = op(detail::move(init), detail::move(*value));
+            }
+            return init;
+        }
+
+        template <
+            typename R, typename F, typename Iterator, std::size_t N, typename Op
+          , typename Threads
+        >
+        R transform_reduce_by_type(
+            which_partition<Iterator, N> const& partition, F& f, R init, Op& op,
+            Threads& threads)
+        {
+            static_assert(
+                detail::is_random_access_iterator<Iterator>::value
+              , "transform_reduce_by_type requires random access iterators");
+
+            std::array<std::size_t, N + 1> starts;
+            starts[0] = 0;
+            for (std::size_t i = 0; i < N; ++i)
+            {
+                std::size_t const size = partition[i].size();
+                starts[i + 1] = starts[i] + (size + detail::parallel_chunk_size - 1)
+                    / detail::parallel_chunk_size;
+            }
+
+            std::vector<variant<R>> partials(starts[N]);
+            detail::_reduce_by_type_body<R, F, Op, Iterator, N> body =
+                {f, op, partition, starts, partials};
+            detail::parallel_chunks(starts[N], threads, body);
+
+            for (variant<R>& partial : partials)
+            {
+                if (R* value = partial.template target<R>())
+                    init = op(detail::move(init), detail::move(*value));
+            }
+            return init;
+        }
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    //! template <class F, class Range>
+    //! void parallel_apply_each(F&& f, Range& range, std::size_t threads = std::thread::hardware_concurrency());
+    //!
+    //! \requires The value type of `Range` shall be a possibly const
+    //!  qualified specialization of `variant`, and its iterators shall be
+    //!  random access iterators. `f` shall be callable with an lvalue
+    //!  designating any of the alternatives, and calls to `f` shall be safe
+    //!  to make concurrently.
+    //!
+    //! \effects Calls `f(m)` for each element of `range` that has an active
+    //!  member, where `m` is an lvalue that designates that member, using up
+    //!  to `threads` threads. The range is split into chunks of a fixed size;
+    //!  within a chunk, the elements are visited grouped by the index of
+    //!  their active member, in the order they occur within each group.
+    //!
+    //! \remarks If `f` exits via an exception while running on a worker
+    //!  thread, `std::terminate` is called.
+    template <typename F, typename Range>
+    void parallel_apply_each(F&& f, Range& range,
+        std::size_t threads = std::thread::hardware_concurrency())
+    {
+        detail::parallel_apply_each(f, range, threads);
+    }
+
+    //! template <class F, class Range>
+    //! void parallel_apply_each(F&& f, Range& range, parallel_pool& pool);
+    //!
+    //! \requires As for `parallel_apply_each(f, range, threads)`.
+    //!  Shall not be called from a worker thread of `pool`.
+    //!
+    //! \effects As `parallel_apply_each(f, range, threads)`, running on the
+    //!  worker threads of `pool` instead.
+    template <typename F, typename Range>
+    void parallel_apply_each(F&& f, Range& range, parallel_pool& pool)
+    {
+        detail::parallel_apply_each(f, range, pool);
+    }
+
+    //! template <class R, class F, class Range, class Op>
+    //! R parallel_apply_reduce(F&& f, Range& range, R init, Op op, std::size_t threads = std::thread::hardware_concurrency());
+    //!
+    //! \requires As for `parallel_apply_each`; additionally, the results of
+    //!  `f` shall be convertible to `R`, and `op` shall be an associative
+    //!  and commutative operation on values of type `R`, safe to call
+    //!  concurrently.
+    //!
+    //! \effects Combines with `op` the results of calling `f(m)` for each
+    //!  element of `range` that has an active member, where `m` is an lvalue
+    //!  that designates that member, using up to `threads` threads. The
+    //!  results within each chunk are combined in the order in which they
+    //!  are visited, and the results of each chunk are then combined with
+    //!  `init` in the order of the chunks; since the chunks have a fixed
+    //!  size, the grouping does not depend on the number of threads.
+    //!
+    //! \returns The combined result, or `init` if no element has an active
+    //!  member.
+    //!
+    //! \remarks If `f` or `op` exits via an exception while running on a
+    //!  worker thread, `std::terminate` is called.
+    template <typename R, typename F, typename Range, typename Op>
+    R parallel_apply_reduce(F&& f, Range& range, R init, Op op,
+        std::size_t threads = std::thread::hardware_concurrency())
+    {
+        return detail::parallel_apply_reduce(
+            f, range, detail::move(init), op, threads);
+    }
+
+    //! template <class R, class F, class Range, class Op>
+    //! R parallel_apply_reduce(F&& f, Range& range, R init, Op op, parallel_pool& pool);
+    //!
+    //! \requires As for `parallel_apply_reduce(f, range, init, op, threads)`.
+    //!  Shall not be called from a worker thread of `pool`.
+    //!
+    //! \effects As `parallel_apply_reduce(f, range, init, op, threads)`,
+    //!  running on the worker threads of `pool` instead.
+    template <typename R, typename F, typename Range, typename Op>
+    R parallel_apply_reduce(F&& f, Range& range, R init, Op op,
+        parallel_pool& pool)
+    {
+        return detail::parallel_apply_reduce(
+            f, range, detail::move(init), op, pool);
+    }
+
+    //! template <class R, class F, class Iterator, std::size_t N, class Op>
+    //! R transform_reduce_by_type(which_partition<Iterator, N> const& partition, F&& f, R init, Op op, std::size_t threads = std::thread::hardware_concurrency());
+    //!
+    //! \requires `Iterator` shall be a random access iterator. `f` shall be
+    //!  callable with an lvalue designating any of the alternatives, and its
+    //!  results shall be convertible to `R`; `op` shall be an associative
+    //!  and commutative operation on values of type `R`. Calls to `f` and
+    //!  `op` shall be safe to make concurrently.
+    //!
+    //! \effects Combines with `op` the results of calling `f(m)` for each
+    //!  element of `partition` that has an active member, where `m` is an
+    //!  lvalue that designates that member, using up to `threads` threads.
+    //!  The group of elements of each alternative is reduced independently,
+    //!  split into chunks of a fixed size, by a loop specialized for the type
+    //!  of that alternative. The results of each chunk are then combined
+    //!  with `init` in the order of the alternatives and of the chunks
+    //!  within them, so the grouping does not depend on the number of
+    //!  threads.
+    //!
+    //! \returns The combined result, or `init` if no element has an active
+    //!  member.
+    //!
+    //! \remarks If `f` or `op` exits via an exception while running on a
+    //!  worker thread, `std::terminate` is called.
+    template <typename R, typename F, typename Iterator, std::size_t N, typename Op>
+    R transform_reduce_by_type(
+        which_partition<Iterator, N> const& partition, F&& f, R init, Op op,
+        std::size_t threads = std::thread::hardware_concurrency())
+    {
+        return detail::transform_reduce_by_type(
+            partition, f, detail::move(init), op, threads);
+    }
+
+    //! template <class R, class F, class Iterator, std::size_t N, class Op>
+    //! R transform_reduce_by_type(which_partition<Iterator, N> const& partition, F&& f, R init, Op op, parallel_pool& pool);
+    //!
+    //! \requires As for
+    //!  `transform_reduce_by_type(partition, f, init, op, threads)`. Shall
+    //!  not be called from a worker thread of `pool`.
+    //!
+    //! \effects As `transform_reduce_by_type(partition, f, init, op, threads)`,
+    //!  running on the worker threads of `pool` instead.
+    template <typename R, typename F, typename Iterator, std::size_t N, typename Op>
+    R transform_reduce_by_type(
+        which_partition<Iterator, N> const& partition, F&& f, R init, Op op,
+        parallel_pool& pool)
+    {
+        return detail::transform_reduce_by_type(
+            partition, f, detail::move(init), op, pool);
+    }
+}}
+
+#include "detail/config/suffix.hpp"
+
+#endif /*EGGS_VARIANT_PARALLEL_ALGORITHM_HPP*/
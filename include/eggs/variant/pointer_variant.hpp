@@ -0,0 +1,527 @@
+//! \file eggs/variant/pointer_variant.hpp
+// Eggs.Variant
+//
+// Copyright Agustin K-ballo Berge, Fusion Fenix 2014-2018
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef EGGS_VARIANT_POINTER_VARIANT_HPP
+#define EGGS_VARIANT_POINTER_VARIANT_HPP
+
+#include "detail/apply.hpp"
+#include "detail/pack.hpp"
+#include "detail/utility.hpp"
+#include "detail/visitor.hpp"
+
+#include "bad_variant_access.hpp"
+#include "in_place.hpp"
+#include "variant.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+
+#include "detail/config/prefix.hpp"
+
+namespace eggs { namespace variants
+{
+    ///////////////////////////////////////////////////////////////////////////
+    //! struct low_bits_tag;
+    //!
+    //! A tagging policy for `basic_pointer_variant` that keeps the tag in
+    //! the low bits of the pointer, which are zero as long as the alignment
+    //! of every pointee type is large enough to leave room for it.
+    struct low_bits_tag
+    {
+        template <typename T, std::size_t Bits>
+        struct fits
+          : std::integral_constant<bool, (alignof(T) >> Bits) != 0>
+        {};
+
+        template <std::size_t Bits>
+        static std::uintptr_t encode(
+            std::uintptr_t ptr, std::uintptr_t tag) noexcept
+        {
+            return ptr | tag;
+        }
+
+        template <std::size_t Bits>
+        static std::uintptr_t pointer(std::uintptr_t bits) noexcept
+        {
+            return bits & ~((std::uintptr_t(1) << Bits) - 1);
+        }
+
+        template <std::size_t Bits>
+        static std::uintptr_t tag(std::uintptr_t bits) noexcept
+        {
+            return bits & ((std::uintptr_t(1) << Bits) - 1);
+        }
+    };
+
+    //! struct high_bits_tag;
+    //!
+    //! A tagging policy for `basic_pointer_variant` that keeps the tag in
+    //! the high bits of the pointer, which on x86-64 and AArch64 are zero
+    //! for user space addresses, for up to 16 bits of tag. It allows for
+    //! pointee types of any alignment.
+    //!
+    //! \requires The high bits of every pointer held shall be zero.
+    struct high_bits_tag
+    {
+        template <typename T, std::size_t Bits>
+        struct fits
+          : std::integral_constant<bool,
+                sizeof(std::uintptr_t) == 8 && Bits <= 16>
+        {};
+
+        template <std::size_t Bits>
+        static std::uintptr_t encode(
+            std::uintptr_t ptr, std::uintptr_t tag) noexcept
+        {
+            return ptr | (tag << (sizeof(std::uintptr_t) * 8 - Bits));
+        }
+
+        template <std::size_t Bits>
+        static std::uintptr_t pointer(std::uintptr_t bits) noexcept
+        {
+            return bits & (~std::uintptr_t(0) >> Bits);
+        }
+
+        template <std::size_t Bits>
+        static std::uintptr_t tag(std::uintptr_t bits) noexcept
+        {
+            return bits >> (sizeof(std::uintptr_t) * 8 - Bits);
+        }
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    namespace detail
+    {
+        template <std::size_t N, std::size_t Bits = 0>
+        struct tag_bits
+          : tag_bits<N / 2, Bits + 1>
+        {};
+
+        template <std::size_t Bits>
+        struct tag_bits<0, Bits>
+          : std::integral_constant<std::size_t, Bits>
+        {};
+
+        template <typename T>
+        struct pointee;
+
+        template <typename T>
+        struct pointee<T*>
+        {
+            using type = T;
+        };
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    //! template <class Tag, class ...Ts>
+    //! class basic_pointer_variant;
+    //!
+    //! A `basic_pointer_variant` holds one pointer out of a closed set of
+    //! pointer types `Ts...` in a single word, with the zero-based index of
+    //! its type, plus one, stored in unused bits of the pointer as directed
+    //! by the tagging policy `Tag`; a word of zero means no pointer is held.
+    //! It offers the observers of `variant<Ts...>`, but yields the pointers
+    //! held by value since there is no pointer object to refer to.
+    //!
+    //! A `basic_pointer_variant` is trivially copyable, so it can be held
+    //! in a `std::atomic`, and its representation is available as `bits()`.
+    //!
+    //! \requires Each type in `Ts...` shall be a pointer to object type.
+    //!  When a member function that stores a pointer is instantiated, the
+    //!  pointee types shall be complete and `Tag` shall have room for the
+    //!  tag of every alternative.
+    template <typename Tag, typename ...Ts>
+    class basic_pointer_variant
+    {
+        EGGS_CXX11_STATIC_CONSTEXPR std::size_t _bits =
+            detail::tag_bits<sizeof...(Ts)>::value;
+
+        template <typename R, typename F>
+        struct _apply
+          : detail::visitor<_apply<R, F>, R(F&, void*)>
+        {
+            template <typename T>
+            static R call(F& f, void* ptr)
+            {
+                return f(static_cast<T>(ptr));
+            }
+        };
+
+    public:
+        //! static constexpr std::size_t npos = std::size_t(-1);
+        EGGS_CXX11_STATIC_CONSTEXPR std::size_t npos = std::size_t(-1);
+
+    public:
+        //! constexpr basic_pointer_variant() noexcept;
+        //!
+        //! \postconditions `*this` holds no pointer and `bits() == 0`.
+        EGGS_CXX11_CONSTEXPR basic_pointer_variant() noexcept
+          : _value(0)
+        {}
+
+        //! template <class T>
+        //! basic_pointer_variant(T ptr) noexcept;
+        //!
+        //! \effects Holds `ptr` as a `T`.
+        //!
+        //! \remarks This constructor shall not participate in overload
+        //!  resolution unless `T` occurs exactly once in `Ts...`.
+        template <
+            typename T
+          , std::size_t I = detail::index_of<T, detail::pack<Ts...>>::value
+        >
+        basic_pointer_variant(T ptr) noexcept
+          : _value(_encode<I>(ptr))
+        {}
+
+        //! template <std::size_t I>
+        //! basic_pointer_variant(in_place_index_t<I>, T ptr) noexcept;
+        //!
+        //! Let `T` be the `I`th element in `Ts...`.
+        //!
+        //! \effects Holds `ptr` as a `T`.
+        template <
+            std::size_t I
+          , typename T = typename detail::checked_at_index<
+                I, detail::pack<Ts...>>::type
+        >
+        basic_pointer_variant(in_place_index_t<I>, T ptr) noexcept
+          : _value(_encode<I>(ptr))
+        {}
+
+        //! template <class T>
+        //! basic_pointer_variant(in_place_type_t<T>, T ptr) noexcept;
+        //!
+        //! \effects Equivalent to `basic_pointer_variant(in_place<I>, ptr)`
+        //!  where `I` is the zero-based index of `T` in `Ts...`.
+        template <
+            typename T
+          , std::size_t I = detail::checked_index_of<
+                T, detail::pack<Ts...>>::value
+        >
+        basic_pointer_variant(
+            in_place_type_t<T>
+          , typename detail::at_index<I, detail::pack<Ts...>>::type ptr) noexcept
+          : _value(_encode<I>(ptr))
+        {}
+
+        //! static basic_pointer_variant from_bits(std::uintptr_t bits) noexcept;
+        //!
+        //! \requires `bits` shall be the value of `bits()` for some object
+        //!  of type `basic_pointer_variant`.
+        //!
+        //! \returns A `basic_pointer_variant` `r` for which `r.bits() ==
+        //!  bits`.
+        static basic_pointer_variant from_bits(std::uintptr_t bits) noexcept
+        {
+            basic_pointer_variant r;
+            r._value = bits;
+            return r;
+        }
+
+        //! template <std::size_t I>
+        //! T emplace(T ptr) noexcept;
+        //!
+        //! Let `T` be the `I`th element in `Ts...`.
+        //!
+        //! \effects Holds `ptr` as a `T`.
+        //!
+        //! \returns `ptr`.
+        template <
+            std::size_t I
+          , typename T = typename detail::checked_at_index<
+                I, detail::pack<Ts...>>::type
+        >
+        T emplace(T ptr) noexcept
+        {
+            _value = _encode<I>(ptr);
+            return ptr;
+        }
+
+        //! explicit operator bool() const noexcept;
+        //!
+        //! \returns `true` if `*this` holds a pointer, even a null one;
+        //!  otherwise, `false`.
+        explicit operator bool() const noexcept
+        {
+            return _value != 0;
+        }
+
+        //! std::size_t which() const noexcept;
+        //!
+        //! \returns The zero-based index of the type of the pointer held, or
+        //!  `npos` if `*this` holds no pointer.
+        std::size_t which() const noexcept
+        {
+            return _value != 0
+              ? std::size_t(Tag::template tag<_bits>(_value)) - 1 : npos;
+        }
+
+        //! void const* target() const noexcept;
+        //!
+        //! \returns The pointer held, converted to `void const*`, or a null
+        //!  pointer if `*this` holds no pointer.
+        void const* target() const noexcept
+        {
+            return _pointer();
+        }
+
+        //! template <class T>
+        //! T* target() const noexcept;
+        //!
+        //! \returns If `*this` holds a pointer of type `T*`, that pointer;
+        //!  otherwise, a null pointer.
+        template <typename T>
+        T* target() const noexcept
+        {
+            using I = detail::checked_index_of<T*, detail::pack<Ts...>>;
+            return which() == I::value ? static_cast<T*>(_pointer()) : nullptr;
+        }
+
+        //! std::uintptr_t bits() const noexcept;
+        //!
+        //! \returns The representation of `*this`.
+        std::uintptr_t bits() const noexcept
+        {
+            return _value;
+        }
+
+        //! template <class R, class F>
+        //! R apply(F&& f) const;
+        //!
+        //! \effects Calls `std::forward<F>(f)(p)`, where `p` is the pointer
+        //!  held, as a prvalue of its type.
+        //!
+        //! \throws `bad_variant_access` if `*this` holds no pointer.
+        template <typename R, typename F>
+        R apply(F&& f) const
+        {
+            std::size_t const which = this->which();
+            if (which == npos)
+                return detail::throw_bad_variant_access<R>();
+
+            return _apply<R, typename std::remove_reference<F>::type>{}(
+                detail::pack<Ts...>{}, which, f, _pointer());
+        }
+
+        //! template <class F>
+        //! R apply(F&& f) const;
+        //!
+        //! Let `R` be the common return type of every potentially evaluated
+        //!  `INVOKE` expression.
+        //!
+        //! \effects Equivalent to `apply<R>(std::forward<F>(f))`.
+        template <
+            int DeductionGuard = 0, typename F
+          , typename R = typename detail::_apply_result_combine<
+                typename detail::_result_of<
+                    typename std::remove_reference<F>::type&
+                  , detail::pack<Ts>>::type...>::type
+        >
+        R apply(F&& f) const
+        {
+            return apply<R>(detail::forward<F>(f));
+        }
+
+    private:
+        template <std::size_t I, typename T>
+        static std::uintptr_t _encode(T ptr) noexcept
+        {
+            using pointee = typename detail::pointee<T>::type;
+            static_assert(
+                Tag::template fits<pointee, _bits>::value,
+                "the tagging policy has no room for the tag of this type");
+
+            return Tag::template encode<_bits>(
+                reinterpret_cast<std::uintptr_t>(
+                    const_cast<void*>(static_cast<void const volatile*>(ptr)))
+              , I + 1);
+        }
+
+        void* _pointer() const noexcept
+        {
+            return reinterpret_cast<void*>(Tag::template pointer<_bits>(_value));
+        }
+
+    private:
+        std::uintptr_t _value;
+    };
+
+    template <typename Tag, typename ...Ts>
+    std::size_t const basic_pointer_variant<Tag, Ts...>::_bits;
+
+    template <typename Tag, typename ...Ts>
+    std::size_t const basic_pointer_variant<Tag, Ts...>::npos;
+
+    //! template <class ...Ts>
+    //! using pointer_variant = basic_pointer_variant<low_bits_tag, Ts...>;
+    template <typename ...Ts>
+    using pointer_variant = basic_pointer_variant<low_bits_tag, Ts...>;
+
+    ///////////////////////////////////////////////////////////////////////////
+    //! template <std::size_t I, class Tag, class ...Ts>
+    //! variant_element_t<I, variant<Ts...>> get(basic_pointer_variant<Tag, Ts...> const& v);
+    //!
+    //! \returns The pointer held by `v`.
+    //!
+    //! \throws `bad_variant_access` if `v.which() != I`.
+    template <
+        std::size_t I, typename Tag, typename ...Ts
+      , typename T = typename detail::checked_at_index<
+            I, detail::pack<Ts...>>::type
+    >
+    T get(basic_pointer_variant<Tag, Ts...> const& v)
+    {
+        return v.which() == I
+          ? static_cast<T>(const_cast<void*>(v.target()))
+          : detail::throw_bad_variant_access<T>();
+    }
+
+    //! template <class T, class Tag, class ...Ts>
+    //! T get(basic_pointer_variant<Tag, Ts...> const& v);
+    //!
+    //! \effects Equivalent to `return get<I>(v);` where `I` is the
+    //!  zero-based index of `T` in `Ts...`.
+    template <
+        typename T, typename Tag, typename ...Ts
+      , std::size_t I = detail::checked_index_of<
+            T, detail::pack<Ts...>>::value
+    >
+    T get(basic_pointer_variant<Tag, Ts...> const& v)
+    {
+        return variants::get<I>(v);
+    }
+
+    //! template <std::size_t I, class Tag, class ...Ts>
+    //! variant_element_t<I, variant<Ts...>> get_if(basic_pointer_variant<Tag, Ts...> const* v) noexcept;
+    //! template <class T, class Tag, class ...Ts>
+    //! T get_if(basic_pointer_variant<Tag, Ts...> const* v) noexcept;
+    //!
+    //! \returns If `v` is not a null pointer and `*v` holds a pointer of
+    //!  the requested type, that pointer; otherwise, a null pointer.
+    template <
+        std::size_t I, typename Tag, typename ...Ts
+      , typename T = typename detail::checked_at_index<
+            I, detail::pack<Ts...>>::type
+    >
+    T get_if(basic_pointer_variant<Tag, Ts...> const* v) noexcept
+    {
+        return v != nullptr && v->which() == I
+          ? static_cast<T>(const_cast<void*>(v->target())) : nullptr;
+    }
+
+    template <
+        typename T, typename Tag, typename ...Ts
+      , std::size_t I = detail::checked_index_of<
+            T, detail::pack<Ts...>>::value
+    >
+    T get_if(basic_pointer_variant<Tag, Ts...> const* v) noexcept
+    {
+        return variants::get_if<I>(v);
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    //! template <class Tag, class ...Ts>
+    //! bool operator==(basic_pointer_variant<Tag, Ts...> const& lhs, basic_pointer_variant<Tag, Ts...> const& rhs) noexcept;
+    //! template <class Tag, class ...Ts>
+    //! bool operator!=(basic_pointer_variant<Tag, Ts...> const& lhs, basic_pointer_variant<Tag, Ts...> const& rhs) noexcept;
+    //!
+    //! \returns Whether `lhs` and `rhs` hold the same pointer as the same
+    //!  type, or both hold none; or its negation.
+    template <typename Tag, typename ...Ts>
+    bool operator==(
+        basic_pointer_variant<Tag, Ts...> const& lhs
+      , basic_pointer_variant<Tag, Ts...> const& rhs) noexcept
+    {
+        return lhs.bits() == rhs.bits();
+    }
+
+    template <typename Tag, typename ...Ts>
+    bool operator!=(
+        basic_pointer_variant<Tag, Ts...> const& lhs
+      , basic_pointer_variant<Tag, Ts...> const& rhs) noexcept
+    {
+        return lhs.bits() != rhs.bits();
+    }
+
+    //! template <class Tag, class ...Ts>
+    //! bool operator<(basic_pointer_variant<Tag, Ts...> const& lhs, basic_pointer_variant<Tag, Ts...> const& rhs) noexcept;
+    //!
+    //! \returns `true` if `lhs` holds no pointer and `rhs` does, or if
+    //!  `lhs.which() < rhs.which()`, or if both hold a pointer of the same
+    //!  type and `std::less<void const*>()(lhs.target(), rhs.target())`;
+    //!  otherwise, `false`.
+    template <typename Tag, typename ...Ts>
+    bool operator<(
+        basic_pointer_variant<Tag, Ts...> const& lhs
+      , basic_pointer_variant<Tag, Ts...> const& rhs) noexcept
+    {
+        return lhs.which() + 1 != rhs.which() + 1
+          ? lhs.which() + 1 < rhs.which() + 1
+          : std::less<void const*>()(lhs.target(), rhs.target());
+    }
+
+    //! template <class Tag, class ...Ts>
+    //! bool operator>(basic_pointer_variant<Tag, Ts...> const& lhs, basic_pointer_variant<Tag, Ts...> const& rhs) noexcept;
+    //! template <class Tag, class ...Ts>
+    //! bool operator<=(basic_pointer_variant<Tag, Ts...> const& lhs, basic_pointer_variant<Tag, Ts...> const& rhs) noexcept;
+    //! template <class Tag, class ...Ts>
+    //! bool operator>=(basic_pointer_variant<Tag, Ts...> const& lhs, basic_pointer_variant<Tag, Ts...> const& rhs) noexcept;
+    //!
+    //! \returns `rhs < lhs`, `!(rhs < lhs)` and `!(lhs < rhs)`,
+    //!  respectively.
+    template <typename Tag, typename ...Ts>
+    bool operator>(
+        basic_pointer_variant<Tag, Ts...> const& lhs
+      , basic_pointer_variant<Tag, Ts...> const& rhs) noexcept
+    {
+        return rhs < lhs;
+    }
+
+    template <typename Tag, typename ...Ts>
+    bool operator<=(
+        basic_pointer_variant<Tag, Ts...> const& lhs
+      , basic_pointer_variant<Tag, Ts...> const& rhs) noexcept
+    {
+        return !(rhs < lhs);
+    }
+
+    template <typename Tag, typename ...Ts>
+    bool operator>=(
+        basic_pointer_variant<Tag, Ts...> const& lhs
+      , basic_pointer_variant<Tag, Ts...> const& rhs) noexcept
+    {
+        return !(lhs < rhs);
+    }
+}}
+
+namespace std
+{
+    //! template <class Tag, class ...Ts>
+    //! struct hash<::eggs::variants::basic_pointer_variant<Tag, Ts...>>;
+    //!
+    //! For an object `v` of type `basic_pointer_variant<Tag, Ts...>`,
+    //!  `std::hash<basic_pointer_variant<Tag, Ts...>>()(v)` evaluates to
+    //!  `std::hash<std::uintptr_t>()(v.bits())`.
+    template <typename Tag, typename ...Ts>
+    struct hash< ::eggs::variants::basic_pointer_variant<Tag, Ts...>>
+    {
+        std::size_t operator()(
+            ::eggs::variants::basic_pointer_variant<Tag, Ts...> const& v
+        ) const noexcept
+        {
+            return std::hash<std::uintptr_t>()(v.bits());
+        }
+    };
+}
+
+#include "detail/config/suffix.hpp"
+
+#endif /*EGGS_VARIANT_POINTER_VARIANT_HPP*/
@@ -0,0 +1,564 @@
+//! \file eggs/variant/recursive.hpp
+// Eggs.Variant
+//
+// Copyright Agustin K-ballo Berge, Fusion Fenix 2014-2018
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef EGGS_VARIANT_RECURSIVE_HPP
+#define EGGS_VARIANT_RECURSIVE_HPP
+
+#include "detail/storage.hpp"
+#include "detail/utility.hpp"
+
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+#include "detail/config/prefix.hpp"
+
+namespace eggs { namespace variants
+{
+    ///////////////////////////////////////////////////////////////////////////
+    //! class recursive_resource;
+    //!
+    //! A `recursive_resource` is the interface to the memory from which the
+    //! nodes held by `recursive<T>` are allocated.
+    class recursive_resource
+    {
+    public:
+        virtual ~recursive_resource() {}
+
+        //! void* allocate(std::size_t size, std::size_t alignment);
+        //!
+        //! \returns `do_allocate(size, alignment)`.
+        void* allocate(std::size_t size, std::size_t alignment)
+        {
+            return do_allocate(size, alignment);
+        }
+
+        //! void deallocate(void* ptr, std::size_t size, std::size_t alignment) noexcept;
+        //!
+        //! \effects Equivalent to `do_deallocate(ptr, size, alignment)`.
+        void deallocate(
+            void* ptr, std::size_t size, std::size_t alignment) noexcept
+        {
+            do_deallocate(ptr, size, alignment);
+        }
+
+    private:
+        virtual void* do_allocate(
+            std::size_t size, std::size_t alignment) = 0;
+
+        virtual void do_deallocate(
+            void* ptr, std::size_t size, std::size_t alignment) noexcept = 0;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    //! class recursive_arena;
+    //!
+    //! A `recursive_arena` is a `recursive_resource` that carves nodes out
+    //! of blocks of at least `block_size` bytes and never deallocates them
+    //! individually; all of its memory is released at once, by `release()`
+    //! or on destruction.
+    class recursive_arena
+      : public recursive_resource
+    {
+        struct _block
+        {
+            _block* next;
+        };
+
+    public:
+        //! explicit recursive_arena(std::size_t block_size = 4096);
+        explicit recursive_arena(std::size_t block_size = 4096) noexcept
+          : _head(nullptr), _current(nullptr), _end(nullptr)
+          , _block_size(block_size), _allocated(0), _blocks(0)
+        {}
+
+        recursive_arena(recursive_arena const&) = delete;
+        recursive_arena& operator=(recursive_arena const&) = delete;
+
+        //! ~recursive_arena();
+        //!
+        //! \effects Calls `release()`.
+        ~recursive_arena()
+        {
+            release();
+        }
+
+        //! void release() noexcept;
+        //!
+        //! \requires No node allocated from `*this` shall be alive.
+        //!
+        //! \effects Releases every block of memory held by `*this`.
+        void release() noexcept
+        {
+            while (_block* block = _head)
+            {
+                _head = block->next;
+                ::operator delete(block);
+            }
+            _current = _end = nullptr;
+            _allocated = _blocks = 0;
+        }
+
+        //! std::size_t allocated() const noexcept;
+        //!
+        //! \returns The number of bytes allocated from `*this` since it was
+        //!  constructed or last released.
+        std::size_t allocated() const noexcept
+        {
+            return _allocated;
+        }
+
+        //! std::size_t blocks() const noexcept;
+        //!
+        //! \returns The number of blocks of memory held by `*this`.
+        std::size_t blocks() const noexcept
+        {
+            return _blocks;
+        }
+
+    private:
+        void* do_allocate(std::size_t size, std::size_t alignment) override
+        {
+            std::size_t space = std::size_t(_end - _current);
+            void* ptr = _current;
+            if (_current == nullptr
+             || std::align(alignment, size, ptr, space) == nullptr)
+            {
+                std::size_t const header =
+                    (sizeof(_block) + alignment - 1) / alignment * alignment;
+                std::size_t const bytes =
+                    header + size > _block_size ? header + size : _block_size;
+                _block* block = static_cast<_block*>(::operator new(bytes));
+                block->next = _head;
+                _head = block;
+                ++_blocks;
+
+                ptr = reinterpret_cast<char*>(block) + header;
+                _end = reinterpret_cast<char*>(block) + bytes;
+            }
+
+            _current = static_cast<char*>(ptr) + size;
+            _allocated += size;
+            return ptr;
+        }
+
+        void do_deallocate(
+            void* /*ptr*/, std::size_t /*size*/
+          , std::size_t /*alignment*/) noexcept override
+        {}
+
+    private:
+        _block* _head;
+        char* _current;
+        char* _end;
+        std::size_t _block_size;
+        std::size_t _allocated;
+        std::size_t _blocks;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    namespace detail
+    {
+        inline recursive_resource*& _recursive_resource() noexcept
+        {
+            static thread_local recursive_resource* resource = nullptr;
+            return resource;
+        }
+    }
+
+    //! recursive_resource* get_recursive_resource() noexcept;
+    //!
+    //! \returns The resource from which the calling thread allocates new
+    //!  nodes for `recursive<T>`, or a null pointer if it uses the global
+    //!  allocation functions.
+    inline recursive_resource* get_recursive_resource() noexcept
+    {
+        return detail::_recursive_resource();
+    }
+
+    //! recursive_resource* set_recursive_resource(recursive_resource* resource) noexcept;
+    //!
+    //! \effects Makes the calling thread allocate new nodes for
+    //!  `recursive<T>` from `resource`, or with the global allocation
+    //!  functions if `resource` is a null pointer.
+    //!
+    //! \returns The previous value of `get_recursive_resource()`.
+    inline recursive_resource* set_recursive_resource(
+        recursive_resource* resource) noexcept
+    {
+        recursive_resource* previous = detail::_recursive_resource();
+        detail::_recursive_resource() = resource;
+        return previous;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    //! template <class T>
+    //! class recursive;
+    //!
+    //! A `recursive<T>` holds an object of type `T` in a node allocated
+    //! from the `recursive_resource` of the thread that constructs it, so
+    //! that `T` may be incomplete where `recursive<T>` is named; this allows
+    //! for a `variant` alternative that refers to a type that contains the
+    //! `variant` itself. A `variant` alternative of type `recursive<T>` is
+    //! accessed as `T`, just like one of type `boxed<T>`.
+    //!
+    //! Each node records the resource it was allocated from, and is
+    //! returned to it when the `recursive<T>` is destroyed; with a
+    //! `recursive_arena`, that is a no-op and a whole tree is freed at once
+    //! when the arena is.
+    //!
+    //! A moved-from `recursive<T>` holds no object; it can be destroyed,
+    //! assigned to, copied, compared and hashed, just like a moved-from
+    //! `boxed<T>`.
+    template <typename T>
+    class recursive
+    {
+        // the node resource is stored right before the object, which may
+        // be incomplete where this class is instantiated
+        static EGGS_CXX11_CONSTEXPR std::size_t _offset() noexcept
+        {
+            return alignof(T) > sizeof(recursive_resource*)
+              ? alignof(T) : sizeof(recursive_resource*);
+        }
+
+        static EGGS_CXX11_CONSTEXPR std::size_t _alignment() noexcept
+        {
+            return alignof(T) > alignof(recursive_resource*)
+              ? alignof(T) : alignof(recursive_resource*);
+        }
+
+        struct _guard
+        {
+            recursive_resource* resource;
+            void* ptr;
+
+            ~_guard()
+            {
+                if (ptr != nullptr)
+                    recursive::_deallocate(resource, ptr);
+            }
+        };
+
+        template <typename ...Args>
+        struct _is_self
+          : std::false_type
+        {};
+
+        template <typename U>
+        struct _is_self<U>
+          : std::is_same<typename std::decay<U>::type, recursive>
+        {};
+
+    public:
+        using element_type = T;
+
+    public:
+        //! template <class U>
+        //! recursive(U&& value);
+        //!
+        //! \effects Initializes the held object with `std::forward<U>(value)`.
+        //!
+        //! \remarks This constructor shall not participate in overload
+        //!  resolution unless `std::decay_t<U>` is not `recursive` and
+        //!  `std::is_convertible_v<U&&, T>` is `true`.
+        template <
+            typename U
+          , typename NotSelf = typename std::enable_if<
+                !_is_self<U>::value>::type
+          , typename Enable = typename std::enable_if<
+                std::is_convertible<U&&, T>::value>::type
+        >
+        recursive(U&& value)
+          : _ptr(_make(detail::forward<U>(value)))
+        {}
+
+        //! template <class ...Args>
+        //! explicit recursive(Args&&... args);
+        //!
+        //! \effects Initializes the held object as if direct-non-list-
+        //!  initializing an object of type `T` with
+        //!  `std::forward<Args>(args)...`.
+        //!
+        //! \remarks This constructor shall not participate in overload
+        //!  resolution unless `std::is_constructible_v<T, Args&&...>` is
+        //!  `true`.
+        template <
+            typename ...Args
+          , typename NotSelf = typename std::enable_if<
+                !_is_self<Args...>::value>::type
+          , typename Enable = typename std::enable_if<
+                std::is_constructible<T, Args&&...>::value>::type
+        >
+        explicit recursive(Args&&... args)
+          : _ptr(_make(detail::forward<Args>(args)...))
+        {}
+
+        //! recursive(recursive const& rhs);
+        //!
+        //! \effects If `rhs` holds an object, initializes the held object
+        //!  with `*rhs`, in a node allocated from `get_recursive_resource()`;
+        //!  otherwise, `*this` holds no object.
+        recursive(recursive const& rhs)
+          : _ptr(rhs._ptr != nullptr ? _make(*rhs._ptr) : nullptr)
+        {}
+
+        //! recursive(recursive&& rhs) noexcept;
+        //!
+        //! \effects Takes ownership of the node held by `rhs`.
+        //!
+        //! \postconditions `rhs` holds no object.
+        recursive(recursive&& rhs) noexcept
+          : _ptr(rhs._ptr)
+        {
+            rhs._ptr = nullptr;
+        }
+
+        //! ~recursive();
+        //!
+        //! \effects Destroys the held object, if any, and returns its node to
+        //!  the resource it was allocated from.
+        ~recursive()
+        {
+            _destroy(_ptr);
+        }
+
+        //! recursive& operator=(recursive const& rhs);
+        //!
+        //! \effects If `rhs` holds no object, destroys the held object, if
+        //!  any; otherwise, if `*this` holds an object, assigns `*rhs` to it;
+        //!  otherwise, initializes a new held object with `*rhs`.
+        recursive& operator=(recursive const& rhs)
+        {
+            if (rhs._ptr == nullptr)
+            {
+                _destroy(_ptr);
+                _ptr = nullptr;
+            } else if (_ptr != nullptr) {
+                *_ptr = *rhs._ptr;
+            } else {
+                _ptr = _make(*rhs._ptr);
+            }
+            return *this;
+        }
+
+        //! recursive& operator=(recursive&& rhs) noexcept;
+        //!
+        //! \effects Exchanges the nodes held by `*this` and `rhs`.
+        recursive& operator=(recursive&& rhs) noexcept
+        {
+            T* ptr = _ptr;
+            _ptr = rhs._ptr;
+            rhs._ptr = ptr;
+            return *this;
+        }
+
+        //! explicit operator bool() const noexcept;
+        //!
+        //! \returns `true` if `*this` holds an object, otherwise `false`.
+        explicit operator bool() const noexcept
+        {
+            return _ptr != nullptr;
+        }
+
+        //! T& get() noexcept;
+        //! T const& get() const noexcept;
+        //! T& operator*() noexcept;
+        //! T const& operator*() const noexcept;
+        //!
+        //! \requires `*this` holds an object.
+        //!
+        //! \returns A reference to the held object.
+        T& get() noexcept
+        {
+            return *_ptr;
+        }
+
+        T const& get() const noexcept
+        {
+            return *_ptr;
+        }
+
+        T& operator*() noexcept
+        {
+            return *_ptr;
+        }
+
+        T const& operator*() const noexcept
+        {
+            return *_ptr;
+        }
+
+        //! T* operator->() noexcept;
+        //! T const* operator->() const noexcept;
+        //!
+        //! \returns A pointer to the held object, if any; otherwise, a null
+        //!  pointer.
+        T* operator->() noexcept
+        {
+            return _ptr;
+        }
+
+        T const* operator->() const noexcept
+        {
+            return _ptr;
+        }
+
+    private:
+        static recursive_resource*& _resource(void* ptr) noexcept
+        {
+            return *reinterpret_cast<recursive_resource**>(
+                static_cast<char*>(ptr) - _offset());
+        }
+
+        static void _deallocate(recursive_resource* resource, void* ptr) noexcept
+        {
+            void* node = static_cast<char*>(ptr) - _offset();
+            if (resource != nullptr)
+            {
+                resource->deallocate(node, _offset() + sizeof(T), _alignment());
+            } else {
+                ::operator delete(node);
+            }
+        }
+
+        static void _destroy(T* ptr) noexcept
+        {
+            if (ptr != nullptr)
+            {
+                ptr->~T();
+                _deallocate(_resource(ptr), ptr);
+            }
+        }
+
+        template <typename ...Args>
+        static T* _make(Args&&... args)
+        {
+            static_assert(
+                alignof(T) <= alignof(std::max_align_t),
+                "over-aligned types cannot be held by recursive");
+
+            recursive_resource* resource = get_recursive_resource();
+            void* node = resource != nullptr
+              ? resource->allocate(_offset() + sizeof(T), _alignment())
+              : ::operator new(_offset() + sizeof(T));
+
+            _guard guard = {resource, static_cast<char*>(node) + _offset()};
+            _resource(guard.ptr) = resource;
+            T* ptr = ::new (guard.ptr) T(detail::forward<Args>(args)...);
+            guard.ptr = nullptr;
+            return ptr;
+        }
+
+    private:
+        T* _ptr;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    //! template <class T>
+    //! bool operator==(recursive<T> const& lhs, recursive<T> const& rhs);
+    //! template <class T>
+    //! bool operator!=(recursive<T> const& lhs, recursive<T> const& rhs);
+    //! template <class T>
+    //! bool operator<(recursive<T> const& lhs, recursive<T> const& rhs);
+    //! template <class T>
+    //! bool operator>(recursive<T> const& lhs, recursive<T> const& rhs);
+    //! template <class T>
+    //! bool operator<=(recursive<T> const& lhs, recursive<T> const& rhs);
+    //! template <class T>
+    //! bool operator>=(recursive<T> const& lhs, recursive<T> const& rhs);
+    //!
+    //! \returns If both `lhs` and `rhs` hold an object, `*lhs @ *rhs`;
+    //!  otherwise, `bool(lhs) @ bool(rhs)`, where `@` is the corresponding
+    //!  operator.
+    template <typename T>
+    bool operator==(recursive<T> const& lhs, recursive<T> const& rhs)
+    {
+        return lhs && rhs ? *lhs == *rhs : bool(lhs) == bool(rhs);
+    }
+
+    template <typename T>
+    bool operator!=(recursive<T> const& lhs, recursive<T> const& rhs)
+    {
+        return lhs && rhs ? *lhs != *rhs : bool(lhs) != bool(rhs);
+    }
+
+    template <typename T>
+    bool operator<(recursive<T> const& lhs, recursive<T> const& rhs)
+    {
+        return lhs && rhs ? *lhs < *rhs : bool(lhs) < bool(rhs);
+    }
+
+    template <typename T>
+    bool operator>(recursive<T> const& lhs, recursive<T> const& rhs)
+    {
+        return lhs && rhs ? *lhs > *rhs : bool(lhs) > bool(rhs);
+    }
+
+    template <typename T>
+    bool operator<=(recursive<T> const& lhs, recursive<T> const& rhs)
+    {
+        return lhs && rhs ? *lhs <= *rhs : bool(lhs) <= bool(rhs);
+    }
+
+    template <typename T>
+    bool operator>=(recursive<T> const& lhs, recursive<T> const& rhs)
+    {
+        return lhs && rhs ? *lhs >= *rhs : bool(lhs) >= bool(rhs);
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    namespace detail
+    {
+        template <typename T>
+        struct unboxed<recursive<T>>
+        {
+            using type = T;
+
+            // a moved-from alternative holds no object to refer to
+            static T& get(recursive<T>& member) noexcept
+            {
+                if (!member)
+                    std::terminate();
+                return *member;
+            }
+
+            static T const& get(recursive<T> const& member) noexcept
+            {
+                if (!member)
+                    std::terminate();
+                return *member;
+            }
+        };
+    }
+}}
+
+namespace std
+{
+    //! template <class T>
+    //! struct hash<::eggs::variants::recursive<T>>;
+    //!
+    //! For an object `r` of type `recursive<T>`, `std::hash<recursive<T>>()(r)`
+    //!  evaluates to the same value as `std::hash<T>()(*r)` if `r` holds an
+    //!  object, and to `0` otherwise.
+    template <typename T>
+    struct hash< ::eggs::variants::recursive<T>>
+    {
+        std::size_t operator()(::eggs::variants::recursive<T> const& r) const
+            noexcept(noexcept(std::hash<T>()(*r)))
+        {
+            return r ? std::hash<T>()(*r) : 0;
+        }
+    };
+}
+
+#include "detail/config/suffix.hpp"
+
+#endif /*EGGS_VARIANT_RECURSIVE_HPP*/
@@ -0,0 +1,467 @@
+//! \file eggs/variant/schema.hpp
+// Eggs.Variant
+//
+// Copyright Agustin K-ballo Berge, Fusion Fenix 2014-2018
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef EGGS_VARIANT_SCHEMA_HPP
+#define EGGS_VARIANT_SCHEMA_HPP
+
+#include "detail/pack.hpp"
+#include "detail/storage.hpp"
+#include "detail/utility.hpp"
+
+#include "fingerprint.hpp"
+#include "serialization.hpp"
+#include "variant.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+#include <vector>
+
+#include "detail/config/prefix.hpp"
+
+namespace eggs { namespace variants
+{
+    ///////////////////////////////////////////////////////////////////////////
+    template <typename T>
+    struct alternative_id;
+
+    namespace detail
+    {
+        ///////////////////////////////////////////////////////////////////////
+        template <typename T, std::uint64_t Name>
+        struct _named_alternative_id
+          : std::integral_constant<std::uint64_t, detail::fnv1a(detail::fnv1a(
+                detail::fnv1a(fnv1a_basis, sizeof(T)),
+                std::alignment_of<T>::value), Name)>
+        {};
+
+        template <typename T, typename Enable = void>
+        struct _alternative_id
+        {};
+
+        template <typename T>
+        struct _alternative_id<T, typename std::enable_if<
+            std::is_convertible<
+                decltype(type_name<T>::value), char const*>::value
+        >::type>
+          : _named_alternative_id<T, _type_name_fingerprint<T>::value>
+        {};
+
+        template <typename T, typename Enable = void>
+        struct has_alternative_id
+          : std::false_type
+        {};
+
+        template <typename T>
+        struct has_alternative_id<T, typename std::enable_if<
+            std::is_convertible<
+                decltype(alternative_id<T>::value), std::uint64_t>::value
+        >::type>
+          : std::true_type
+        {};
+
+        template <typename Ts, typename Enable = void>
+        struct _pack_alternative_id
+        {};
+
+        template <>
+        struct _pack_alternative_id<pack<>>
+          : std::integral_constant<std::uint64_t, fnv1a_basis>
+        {};
+
+        template <typename T, typename ...Ts>
+        struct _pack_alternative_id<pack<T, Ts...>, typename std::enable_if<
+            has_alternative_id<T>::value
+         && std::is_convertible<
+                decltype(_pack_alternative_id<pack<Ts...>>::value)
+              , std::uint64_t>::value
+        >::type>
+          : std::integral_constant<std::uint64_t, detail::fnv1a(
+                _pack_alternative_id<pack<Ts...>>::value,
+                alternative_id<T>::value)>
+        {};
+
+        EGGS_CXX11_CONSTEXPR inline bool _contains_id(std::uint64_t /*id*/)
+        {
+            return false;
+        }
+
+        template <typename ...Ids>
+        EGGS_CXX11_CONSTEXPR bool _contains_id(
+            std::uint64_t id, std::uint64_t head, Ids... tail)
+        {
+            return id == head || detail::_contains_id(id, tail...);
+        }
+
+        EGGS_CXX11_CONSTEXPR inline bool _unique_ids()
+        {
+            return true;
+        }
+
+        template <typename ...Ids>
+        EGGS_CXX11_CONSTEXPR bool _unique_ids(std::uint64_t head, Ids... tail)
+        {
+            return !detail::_contains_id(head, tail...)
+                && detail::_unique_ids(tail...);
+        }
+    }
+
+    //! template <class T>
+    //! struct alternative_id;
+    //!
+    //! \remarks If `T` has an id, has a `BaseCharacteristic` of
+    //!  `std::integral_constant<std::uint64_t, N>`, where `N` identifies `T`
+    //!  in a schema; otherwise, it is empty. A type has an id if it is an
+    //!  arithmetic type, in which case `N` is a hash of its size, its
+    //!  alignment and its name; if `type_name<T>` is specialized, in which
+    //!  case `N` is a hash of the size, the alignment and the `type_name` of
+    //!  `T`; or if it is a `variant` all of whose alternatives have an id,
+    //!  in which case `N` is a hash of those ids. Users may specialize
+    //!  `alternative_id<T>` to give `T` an explicit id. The layout of a type
+    //!  alone does not identify it, so that alternatives that merely share
+    //!  a layout, such as `int` and `float`, are not mistaken for each other.
+    template <typename T>
+    struct alternative_id
+      : detail::_alternative_id<T>
+    {};
+
+    template <typename T>
+    struct alternative_id<T const>
+      : alternative_id<T>
+    {};
+
+    template <typename ...Ts>
+    struct alternative_id<variant<Ts...>>
+      : detail::_pack_alternative_id<detail::pack<Ts...>>
+    {};
+
+#define EGGS_VARIANT_DETAIL_ALTERNATIVE_ID(T)                                 \
+    template <>                                                               \
+    struct alternative_id<T>                                                  \
+      : detail::_named_alternative_id<T,                                      \
+            detail::fnv1a_string(detail::fnv1a_basis, #T)>                    \
+    {};
+
+    EGGS_VARIANT_DETAIL_ALTERNATIVE_ID(bool)
+    EGGS_VARIANT_DETAIL_ALTERNATIVE_ID(char)
+    EGGS_VARIANT_DETAIL_ALTERNATIVE_ID(signed char)
+    EGGS_VARIANT_DETAIL_ALTERNATIVE_ID(unsigned char)
+    EGGS_VARIANT_DETAIL_ALTERNATIVE_ID(wchar_t)
+    EGGS_VARIANT_DETAIL_ALTERNATIVE_ID(char16_t)
+    EGGS_VARIANT_DETAIL_ALTERNATIVE_ID(char32_t)
+    EGGS_VARIANT_DETAIL_ALTERNATIVE_ID(short)
+    EGGS_VARIANT_DETAIL_ALTERNATIVE_ID(unsigned short)
+    EGGS_VARIANT_DETAIL_ALTERNATIVE_ID(int)
+    EGGS_VARIANT_DETAIL_ALTERNATIVE_ID(unsigned int)
+    EGGS_VARIANT_DETAIL_ALTERNATIVE_ID(long)
+    EGGS_VARIANT_DETAIL_ALTERNATIVE_ID(unsigned long)
+    EGGS_VARIANT_DETAIL_ALTERNATIVE_ID(long long)
+    EGGS_VARIANT_DETAIL_ALTERNATIVE_ID(unsigned long long)
+    EGGS_VARIANT_DETAIL_ALTERNATIVE_ID(float)
+    EGGS_VARIANT_DETAIL_ALTERNATIVE_ID(double)
+    EGGS_VARIANT_DETAIL_ALTERNATIVE_ID(long double)
+
+#undef EGGS_VARIANT_DETAIL_ALTERNATIVE_ID
+
+    namespace detail
+    {
+        ///////////////////////////////////////////////////////////////////////
+        struct counting_output_iterator
+        {
+            using iterator_category = std::output_iterator_tag;
+            using value_type = void;
+            using difference_type = std::ptrdiff_t;
+            using pointer = void;
+            using reference = void;
+
+            counting_output_iterator& operator*() noexcept { return *this; }
+            counting_output_iterator& operator++() noexcept { return *this; }
+            counting_output_iterator& operator++(int) noexcept { return *this; }
+
+            counting_output_iterator& operator=(unsigned char) noexcept
+            {
+                ++count;
+                return *this;
+            }
+
+            std::size_t count;
+        };
+
+        template <typename Variant>
+        struct schema_ids;
+
+        template <typename T, bool HasId = has_alternative_id<T>::value>
+        struct _alternative_id_or_zero
+          : std::integral_constant<std::uint64_t, 0>
+        {};
+
+        template <typename T>
+        struct _alternative_id_or_zero<T, /*HasId=*/true>
+          : alternative_id<T>
+        {};
+
+        template <typename ...Ts>
+        struct schema_ids<variant<Ts...>>
+        {
+            static EGGS_CXX11_CONSTEXPR bool _has_ids =
+                all_of<pack_c<bool, has_alternative_id<Ts>::value...>>::value;
+
+            static_assert(_has_ids,
+                "every alternative shall have an alternative_id; specialize "
+                "type_name<T> or alternative_id<T> for it");
+
+            static_assert(!_has_ids
+             || detail::_unique_ids(_alternative_id_or_zero<Ts>::value...),
+                "alternatives shall have distinct alternative_ids");
+
+            static std::uint64_t const* value() noexcept
+            {
+                static std::uint64_t const ids[sizeof...(Ts) + 1] = {
+                    alternative_id<Ts>::value..., 0};
+                return ids;
+            }
+        };
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    //! template <class Variant, class OutputIt>
+    //! OutputIt encode_schema(OutputIt out);
+    //!
+    //! \requires `Variant` shall be a specialization of `variant`, and
+    //!  `alternative_id<T>` shall have an id for each alternative `T`, and
+    //!  those ids shall be distinct. `OutputIt` shall be an output iterator
+    //!  that accepts `unsigned char`.
+    //!
+    //! \effects Writes to `out` the schema of `Variant`: the number of
+    //!  alternatives as a variable-length integer, followed by the 8 bytes
+    //!  of `alternative_id<T>::value` for each alternative `T`, in order.
+    //!
+    //! \returns The advanced output iterator.
+    template <
+        typename Variant, typename OutputIt
+      , typename Enable = typename std::enable_if<
+            detail::is_variant<Variant>::value>::type
+    >
+    OutputIt encode_schema(OutputIt out)
+    {
+        std::size_t const size = variant_size<Variant>::value;
+        std::uint64_t const* ids =
+            detail::schema_ids<typename std::remove_cv<Variant>::type>::value();
+        out = detail::encode_varint(size, out);
+        for (std::size_t i = 0; i < size; ++i)
+            out = serialize<std::uint64_t>::encode(ids[i], out);
+        return out;
+    }
+
+    //! template <class ...Ts, class OutputIt>
+    //! OutputIt encode_framed(variant<Ts...> const& v, OutputIt out);
+    //!
+    //! \requires `serialize<T>` shall be enabled for all `T` in `Ts...`.
+    //!  `OutputIt` shall be an output iterator that accepts `unsigned char`.
+    //!
+    //! \effects Writes to `out` the discriminator of `v` as if by `encode`,
+    //!  followed by the size in bytes of the encoding of the active member
+    //!  as a variable-length integer, or `0` if `v` has no active member,
+    //!  followed by that encoding. A reader can thus skip records of
+    //!  alternatives it does not know.
+    //!
+    //! \returns The advanced output iterator.
+    template <typename ...Ts, typename OutputIt>
+    OutputIt encode_framed(variant<Ts...> const& v, OutputIt out)
+    {
+        std::size_t const which = detail::access::storage(v).which();
+        out = detail::encode_varint(which, out);
+        if (which == 0)
+            return detail::encode_varint(0, out);
+
+        detail::counting_output_iterator counter = {0};
+        counter = detail::encode_alternative<detail::counting_output_iterator>{}(
+            detail::pack<Ts...>{}, which - 1
+          , v.target(), detail::move(counter));
+        out = detail::encode_varint(counter.count, out);
+        return detail::encode_alternative<OutputIt>{}(
+            detail::pack<Ts...>{}, which - 1
+          , v.target(), detail::move(out));
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    //! template <class ...Ts>
+    //! class schema_decoder;
+    //!
+    //! A `schema_decoder` decodes records written as if by `encode_framed`
+    //! by a writer whose list of alternatives may differ from `Ts...`, as
+    //! described by the schema the writer encoded as if by `encode_schema`.
+    //! Alternatives are matched by `alternative_id` once, when the schema is
+    //! read, into a table from the discriminators of the writer to those of
+    //! the reader, so decoding a record costs a single lookup.
+    //!
+    //! \requires `serialize<T>` shall be enabled and `alternative_id<T>`
+    //!  shall have an id for all `T` in `Ts...`, and those ids shall be
+    //!  distinct. All alternatives `T` for which `serialize<T>` is not a
+    //!  library provided specialization shall be default constructible.
+    template <typename ...Ts>
+    class schema_decoder
+    {
+        static_assert(detail::schema_ids<variant<Ts...>>::_has_ids,
+            "every alternative shall have an alternative_id");
+
+    public:
+        //! static constexpr std::size_t npos = std::size_t(-1);
+        EGGS_CXX11_STATIC_CONSTEXPR std::size_t npos = std::size_t(-1);
+
+    public:
+        //! schema_decoder();
+        //!
+        //! \effects Initializes the table with the schema of
+        //!  `variant<Ts...>`.
+        schema_decoder()
+          : _remap(sizeof...(Ts) + 1)
+        {
+            for (std::size_t i = 0; i <= sizeof...(Ts); ++i)
+                _remap[i] = i;
+        }
+
+        //! decode_status read_schema(unsigned char const*& first, unsigned char const* last);
+        //!
+        //! \effects Decodes a schema from `[first, last)` and, if successful,
+        //!  advances `first` past it and replaces the table with one that
+        //!  maps every alternative of the writer to the alternative in
+        //!  `Ts...` with the same `alternative_id`, if any; otherwise,
+        //!  `first` and the table are unchanged.
+        //!
+        //! \returns `decode_status::ok` if successful; otherwise, the reason
+        //!  for the failure. A schema that lists the same id more than once
+        //!  is malformed.
+        decode_status read_schema(
+            unsigned char const*& first, unsigned char const* last)
+        {
+            unsigned char const* it = first;
+            std::uint64_t count = 0;
+            decode_status status = detail::decode_varint(it, last, count);
+            if (status != decode_status::ok)
+                return status;
+            if (count > static_cast<std::size_t>(last - it) / 8)
+            {
+                return count > (npos - 1) / 8
+                  ? decode_status::malformed : decode_status::incomplete;
+            }
+
+            std::uint64_t const* ids = detail::schema_ids<variant<Ts...>>::value();
+            std::vector<std::size_t> remap(
+                static_cast<std::size_t>(count) + 1, npos);
+            std::vector<std::uint64_t> seen;
+            seen.reserve(static_cast<std::size_t>(count));
+            remap[0] = 0;
+            for (std::size_t i = 1; i <= count; ++i)
+            {
+                std::uint64_t id = 0;
+                serialize<std::uint64_t>::decode(it, last, id);
+                if (std::find(seen.begin(), seen.end(), id) != seen.end())
+                    return decode_status::malformed;
+                seen.push_back(id);
+                for (std::size_t j = 0; j < sizeof...(Ts); ++j)
+                {
+                    if (ids[j] == id)
+                    {
+                        remap[i] = j + 1;
+                        break;
+                    }
+                }
+            }
+
+            _remap.swap(remap);
+            first = it;
+            return decode_status::ok;
+        }
+
+        //! std::size_t remap(std::size_t which) const noexcept;
+        //!
+        //! \returns The zero-based index in `Ts...` of the alternative that
+        //!  the writer numbers `which`, or `npos` if the reader does not know
+        //!  it or `which` is out of range.
+        std::size_t remap(std::size_t which) const noexcept
+        {
+            return which + 1 < _remap.size() && _remap[which + 1] != npos
+              ? _remap[which + 1] - 1 : npos;
+        }
+
+        //! decode_status try_decode(unsigned char const*& first, unsigned char const* last, variant<Ts...>& v) const;
+        //!
+        //! \effects Decodes a record written as if by `encode_framed` from
+        //!  the bytes in `[first, last)` into `v`, after mapping its
+        //!  discriminator through the table. A record of an alternative the
+        //!  reader does not know is skipped, and decodes as a `variant` with
+        //!  no active member. If successful, advances `first` past the
+        //!  record; otherwise, `first` is unchanged and `v` has no active
+        //!  member.
+        //!
+        //! \returns `decode_status::ok` if successful; otherwise, the reason
+        //!  for the failure. A record whose payload is not decoded from
+        //!  exactly its framed size is malformed.
+        decode_status try_decode(
+            unsigned char const*& first, unsigned char const* last,
+            variant<Ts...>& v) const
+        {
+            unsigned char const* it = first;
+            std::uint64_t which = 0;
+            std::uint64_t size = 0;
+            decode_status status = detail::decode_varint(it, last, which);
+            if (status == decode_status::ok)
+                status = detail::decode_varint(it, last, size);
+            if (status == decode_status::ok)
+            {
+                if (which >= _remap.size())
+                    status = decode_status::malformed;
+                else if (size > static_cast<std::size_t>(last - it))
+                    status = decode_status::incomplete;
+            }
+
+            if (status == decode_status::ok)
+            {
+                std::size_t const target = _remap[which];
+                unsigned char const* const end = it + size;
+                if (target == 0 || target == npos)
+                {
+                    if (target == 0 && size != 0)
+                        status = decode_status::malformed;
+                    detail::reset(v);
+                    it = end;
+                } else {
+                    status = detail::decode_alternative<variant<Ts...>>{}(
+                        detail::typed_index_pack<detail::pack<Ts...>>{}
+                      , target - 1, it, end, v);
+                    if (status == decode_status::incomplete
+                     || (status == decode_status::ok && it != end))
+                    {
+                        status = decode_status::malformed;
+                    }
+                }
+            }
+
+            if (status == decode_status::ok)
+            {
+                first = it;
+            } else {
+                detail::reset(v);
+            }
+            return status;
+        }
+
+    private:
+        std::vector<std::size_t> _remap;
+    };
+
+    template <typename ...Ts>
+    std::size_t const schema_decoder<Ts...>::npos;
+}}
+
+#include "detail/config/suffix.hpp"
+
+#endif /*EGGS_VARIANT_SCHEMA_HPP*/
@@ -0,0 +1,215 @@
+//! \file eggs/variant/seqlock_variant.hpp
+// Eggs.Variant
+//
+// Copyright Agustin K-ballo Berge, Fusion Fenix 2014-2018
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef EGGS_VARIANT_SEQLOCK_VARIANT_HPP
+#define EGGS_VARIANT_SEQLOCK_VARIANT_HPP
+
+#include "detail/pack.hpp"
+#include "detail/storage.hpp"
+#include "detail/utility.hpp"
+
+#include "in_place.hpp"
+#include "variant.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#include "detail/config/prefix.hpp"
+
+namespace eggs { namespace variants
+{
+    ///////////////////////////////////////////////////////////////////////////
+    //! template <class ...Ts>
+    //! class seqlock_variant;
+    //!
+    //! A `seqlock_variant` holds a `variant<Ts...>` that is read often and
+    //! written rarely. Readers copy the value out optimistically and retry
+    //! if a writer intervened, without writing to shared memory; writers
+    //! are serialized among themselves by a sequence counter, which is odd
+    //! while a write is in progress.
+    //!
+    //! All `T` in `Ts...` shall be trivially copyable.
+    //!
+    //! \remarks The value is kept as an array of words accessed with relaxed
+    //!  atomic operations, so concurrent reads and writes are free of data
+    //!  races. A reader may spin while a writer is in progress, so a reader
+    //!  and a writer in the same thread of execution shall not interleave.
+    template <typename ...Ts>
+    class seqlock_variant
+    {
+        static_assert(
+            detail::all_of<detail::pack<
+                detail::is_trivially_copyable<Ts>...>>::value
+          , "seqlock_variant alternatives shall be trivially copyable");
+
+        using _variant = variant<Ts...>;
+
+        using _word = std::uintptr_t;
+
+        EGGS_CXX11_STATIC_CONSTEXPR std::size_t _words =
+            (sizeof(_variant) + sizeof(_word) - 1) / sizeof(_word);
+
+    public:
+        using value_type = _variant;
+
+    public:
+        //! seqlock_variant() noexcept;
+        //!
+        //! \effects Initializes the stored value with a `variant<Ts...>`
+        //!  that has no active member.
+        seqlock_variant() noexcept
+          : _sequence(0)
+        {
+            _write(_variant());
+        }
+
+        //! seqlock_variant(variant<Ts...> const& v) noexcept;
+        //!
+        //! \effects Initializes the stored value with `v`.
+        seqlock_variant(_variant const& v) noexcept
+          : _sequence(0)
+        {
+            _write(v);
+        }
+
+        seqlock_variant(seqlock_variant const&) = delete;
+        seqlock_variant& operator=(seqlock_variant const&) = delete;
+
+        //! variant<Ts...> load() const noexcept;
+        //!
+        //! \returns A copy of the stored value, as of some point between the
+        //!  call and the return, never a mix of two values.
+        _variant load() const noexcept
+        {
+            _word words[_words];
+            for (;;)
+            {
+                unsigned const before =
+                    _sequence.load(std::memory_order_acquire);
+                if ((before & 1u) != 0)
+                {
+                    std::this_thread::yield();
+                    continue;
+                }
+
+                for (std::size_t i = 0; i < _words; ++i)
+                    words[i] = _value[i].load(std::memory_order_relaxed);
+
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (_sequence.load(std::memory_order_relaxed) == before)
+                    break;
+            }
+
+            _variant v;
+            std::memcpy(detail::addressof(v), words, sizeof(_variant));
+            return v;
+        }
+
+        //! template <class R, class F>
+        //! R apply(F&& f) const;
+        //!
+        //! \effects Equivalent to `return variants::apply<R>(std::forward<F>(
+        //!  f), load());`.
+        //!
+        //! \remarks `f` is called on a consistent snapshot, outside of any
+        //!  retry loop, and thus at most once.
+        template <typename R, typename F>
+        R apply(F&& f) const
+        {
+            return variants::apply<R>(detail::forward<F>(f), load());
+        }
+
+        //! template <class F>
+        //! R apply(F&& f) const;
+        //!
+        //! \effects Equivalent to `return variants::apply(std::forward<F>(
+        //!  f), load());`.
+        template <
+            int DeductionGuard = 0, typename F
+          , typename R = decltype(variants::apply(
+                std::declval<F>(), std::declval<_variant>()))
+        >
+        R apply(F&& f) const
+        {
+            return variants::apply(detail::forward<F>(f), load());
+        }
+
+        //! void store(variant<Ts...> const& v) noexcept;
+        //!
+        //! \effects Replaces the stored value with `v`, waiting for any
+        //!  other writer to complete.
+        void store(_variant const& v) noexcept
+        {
+            unsigned sequence = _sequence.load(std::memory_order_relaxed);
+            for (;;)
+            {
+                if ((sequence & 1u) == 0
+                 && _sequence.compare_exchange_weak(
+                        sequence, sequence + 1, std::memory_order_acquire,
+                        std::memory_order_relaxed))
+                {
+                    break;
+                }
+                std::this_thread::yield();
+                sequence = _sequence.load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_release);
+
+            _write(v);
+
+            _sequence.store(sequence + 2, std::memory_order_release);
+        }
+
+        //! template <std::size_t I, class ...Args>
+        //! void emplace(Args&&... args);
+        //!
+        //! \effects Equivalent to `store(variant<Ts...>(in_place<I>,
+        //!  std::forward<Args>(args)...))`.
+        template <std::size_t I, typename ...Args>
+        void emplace(Args&&... args)
+        {
+            store(_variant(in_place<I>, detail::forward<Args>(args)...));
+        }
+
+        //! template <class T, class ...Args>
+        //! void emplace(Args&&... args);
+        //!
+        //! \effects Equivalent to `store(variant<Ts...>(in_place<T>,
+        //!  std::forward<Args>(args)...))`.
+        template <typename T, typename ...Args>
+        void emplace(Args&&... args)
+        {
+            store(_variant(in_place<T>, detail::forward<Args>(args)...));
+        }
+
+    private:
+        void _write(_variant const& v) noexcept
+        {
+            _word words[_words] = {};
+            std::memcpy(words, detail::addressof(v), sizeof(_variant));
+            for (std::size_t i = 0; i < _words; ++i)
+                _value[i].store(words[i], std::memory_order_relaxed);
+        }
+
+    private:
+        std::atomic<unsigned> _sequence;
+        std::atomic<_word> _value[_words];
+    };
+
+    template <typename ...Ts>
+    std::size_t const seqlock_variant<Ts...>::_words;
+}}
+
+#include "detail/config/suffix.hpp"
+
+#endif /*EGGS_VARIANT_SEQLOCK_VARIANT_HPP*/
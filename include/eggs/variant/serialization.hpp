@@ -0,0 +1,746 @@
+//! \file eggs/variant/serialization.hpp
+// Eggs.Variant
+//
+// Copyright Agustin K-ballo Berge, Fusion Fenix 2014-2018
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef EGGS_VARIANT_SERIALIZATION_HPP
+#define EGGS_VARIANT_SERIALIZATION_HPP
+
+#include "detail/pack.hpp"
+#include "detail/storage.hpp"
+#include "detail/utility.hpp"
+#include "detail/visitor.hpp"
+
+#include "variant.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <type_traits>
+#include <vector>
+
+#include "detail/config/prefix.hpp"
+
+namespace eggs { namespace variants
+{
+    ///////////////////////////////////////////////////////////////////////////
+    //! enum class decode_status;
+    //!
+    //! The result of an attempt to decode a value from a range of bytes.
+    //!  `ok` signals that a value was decoded, `incomplete` that the range
+    //!  ends before the encoded value does, and `malformed` that the range
+    //!  does not hold a valid encoding.
+    enum class decode_status
+    {
+        ok = 0,
+        incomplete,
+        malformed
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    //! class bad_variant_decode : public std::exception
+    //!
+    //! Objects of type `bad_variant_decode` are thrown to report attempts to
+    //! decode a `variant` object from a range of bytes that does not hold a
+    //! complete and valid encoding.
+    class bad_variant_decode
+      : public std::exception
+    {
+    public:
+        //! bad_variant_decode(decode_status status) noexcept;
+        //!
+        //! \effects Constructs a `bad_variant_decode` object.
+        //!
+        //! \postconditions `status() == status`.
+        explicit bad_variant_decode(decode_status status) noexcept
+          : _status(status)
+        {}
+
+        //! decode_status status() const noexcept;
+        //!
+        //! \returns The reason for the failure.
+        decode_status status() const noexcept
+        {
+            return _status;
+        }
+
+        //! char const* what() const noexcept override;
+        //!
+        //! \returns An implementation-defined NTBS.
+        char const* what() const noexcept /*override*/
+        {
+            return "bad_variant_decode";
+        }
+
+    private:
+        decode_status _status;
+    };
+
+    namespace detail
+    {
+        ///////////////////////////////////////////////////////////////////////
+        template <typename T>
+        EGGS_CXX11_NORETURN inline T throw_bad_variant_decode(
+            decode_status status)
+        {
+#if EGGS_CXX98_HAS_EXCEPTIONS
+            throw bad_variant_decode{status};
+#else
+            (void)status;
+            std::terminate();
+#endif
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        template <typename OutputIt>
+        OutputIt encode_varint(std::uint64_t value, OutputIt out)
+        {
+            for (; value >= 0x80u; value >>= 7)
+            {
+                *out = static_cast<unsigned char>(value | 0x80u);
+                ++out;
+            }
+            *out = static_cast<unsigned char>(value);
+            ++out;
+            return out;
+        }
+
+        inline decode_status decode_varint(
+            unsigned char const*& first, unsigned char const* last,
+            std::uint64_t& value) noexcept
+        {
+            std::uint64_t result = 0;
+            unsigned char const* it = first;
+            for (unsigned shift = 0; shift < 64; shift += 7)
+            {
+                if (it == last)
+                    return decode_status::incomplete;
+
+                unsigned char const byte = *it++;
+                result |= std::uint64_t(byte & 0x7fu) << shift;
+                if ((byte & 0x80u) == 0)
+                {
+                    // reject encodings with bits beyond the 64th
+                    if (shift == 63 && byte > 1u)
+                        return decode_status::malformed;
+
+                    value = result;
+                    first = it;
+                    return decode_status::ok;
+                }
+            }
+            return decode_status::malformed;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        template <typename T>
+        struct is_raw_serializable
+          : std::integral_constant<
+                bool
+              , is_trivially_copyable<T>::value
+             && !std::is_pointer<T>::value
+             && !std::is_member_pointer<T>::value
+             && !std::is_same<T, bool>::value
+             && !std::is_enum<T>::value
+             && !is_variant<T>::value
+            >
+        {};
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    //! template <class T, class Enable = void>
+    //! struct serialize;
+    //!
+    //! Customization point for the encoding of values of type `T`. Enabled
+    //!  specializations provide the static member functions:
+    //!
+    //!     template <class OutputIt>
+    //!     static OutputIt encode(T const& value, OutputIt out);
+    //!
+    //!     static decode_status decode(
+    //!         unsigned char const*& first, unsigned char const* last,
+    //!         T& value);
+    //!
+    //!  where `encode` writes the bytes encoding `value` to `out` and returns
+    //!  the advanced iterator, and `decode` reads an encoded value from
+    //!  `[first, last)` into `value` and, if successful, advances `first`
+    //!  past it. A `decode` shall never read outside of `[first, last)`.
+    //!
+    //! \remarks The library provides enabled specializations for trivially
+    //!  copyable types other than pointers, which are encoded as their
+    //!  object representation, for `bool` and enumerations, which are
+    //!  validated when decoded, and for `variant`. Users may specialize
+    //!  `serialize` for their own types.
+    template <typename T, typename Enable = void>
+    struct serialize; // undefined
+
+    //! template <class T>
+    //! struct serialize<T>;
+    //!
+    //! \remarks Enabled for trivially copyable types `T` other than pointers,
+    //!  pointers to members, `bool`, enumerations, and `variant`s. Encodes
+    //!  the `sizeof(T)` bytes of the object representation of a value as
+    //!  they are, so the encoding is only meaningful to a reader that shares
+    //!  the representation of `T`. Decoding does not validate the bytes, so
+    //!  a class type with a member of a type that has invalid
+    //!  representations, such as `bool` or an enumeration, shall specialize
+    //!  `serialize` to decode untrusted input.
+    template <typename T>
+    struct serialize<T, typename std::enable_if<
+        detail::is_raw_serializable<T>::value>::type>
+    {
+        template <typename OutputIt>
+        static OutputIt encode(T const& value, OutputIt out)
+        {
+            unsigned char const* bytes =
+                reinterpret_cast<unsigned char const*>(detail::addressof(value));
+            for (std::size_t i = 0; i < sizeof(T); ++i)
+            {
+                *out = bytes[i];
+                ++out;
+            }
+            return out;
+        }
+
+        static unsigned char* encode(T const& value, unsigned char* out) noexcept
+        {
+            std::memcpy(out, detail::addressof(value), sizeof(T));
+            return out + sizeof(T);
+        }
+
+        static decode_status decode(
+            unsigned char const*& first, unsigned char const* last,
+            T& value) noexcept
+        {
+            if (static_cast<std::size_t>(last - first) < sizeof(T))
+                return decode_status::incomplete;
+
+            std::memcpy(detail::addressof(value), first, sizeof(T));
+            first += sizeof(T);
+            return decode_status::ok;
+        }
+    };
+
+    //! template <>
+    //! struct serialize<bool>;
+    //!
+    //! \remarks Encodes a value as a single byte, `0` or `1`; any other byte
+    //!  is malformed.
+    template <>
+    struct serialize<bool>
+    {
+        template <typename OutputIt>
+        static OutputIt encode(bool value, OutputIt out)
+        {
+            *out = static_cast<unsigned char>(value ? 1u : 0u);
+            ++out;
+            return out;
+        }
+
+        static decode_status decode(
+            unsigned char const*& first, unsigned char const* last,
+            bool& value) noexcept
+        {
+            if (first == last)
+                return decode_status::incomplete;
+            if (*first > 1u)
+                return decode_status::malformed;
+
+            value = *first != 0u;
+            ++first;
+            return decode_status::ok;
+        }
+    };
+
+    //! template <class T>
+    //! struct serialize<T>;
+    //!
+    //! \requires Every value of the underlying type `U` of `T` shall be a
+    //!  value of `T`, as it is when the underlying type of `T` is fixed;
+    //!  otherwise, `serialize<T>` shall be specialized to decode untrusted
+    //!  input.
+    //!
+    //! \remarks Enabled for enumerations `T`. Encodes a value as its
+    //!  underlying type, as if by `serialize<U>`.
+    template <typename T>
+    struct serialize<T, typename std::enable_if<
+        std::is_enum<T>::value>::type>
+    {
+        using _underlying = typename std::underlying_type<T>::type;
+
+        template <typename OutputIt>
+        static OutputIt encode(T value, OutputIt out)
+        {
+            return serialize<_underlying>::encode(
+                static_cast<_underlying>(value), out);
+        }
+
+        static decode_status decode(
+            unsigned char const*& first, unsigned char const* last,
+            T& value) noexcept
+        {
+            _underlying underlying = _underlying();
+            decode_status const status =
+                serialize<_underlying>::decode(first, last, underlying);
+            if (status == decode_status::ok)
+                value = static_cast<T>(underlying);
+            return status;
+        }
+    };
+
+    namespace detail
+    {
+        ///////////////////////////////////////////////////////////////////////
+        template <typename OutputIt>
+        struct encode_alternative
+          : visitor<encode_alternative<OutputIt>, OutputIt(void const*, OutputIt)>
+        {
+            template <typename T>
+            static OutputIt call(void const* ptr, OutputIt out)
+            {
+                return serialize<typename std::remove_const<T>::type>::encode(
+                    *static_cast<T const*>(ptr), out);
+            }
+        };
+
+        template <typename V>
+        struct decode_alternative
+          : visitor<
+                decode_alternative<V>
+              , decode_status(
+                    unsigned char const*&, unsigned char const* const&, V&)
+            >
+        {
+            template <typename T, std::size_t I>
+            static decode_status _call(
+                /*is_raw_serializable<T>=*/std::true_type, index<I>,
+                unsigned char const*& first, unsigned char const* last, V& v)
+            {
+                // no default constructor required, `T` is constructed from
+                // a copy of its object representation
+                if (static_cast<std::size_t>(last - first) < sizeof(T))
+                    return decode_status::incomplete;
+
+                typename std::aligned_storage<
+                    sizeof(T), std::alignment_of<T>::value>::type buffer;
+                std::memcpy(&buffer, first, sizeof(T));
+                v.template emplace<I>(*reinterpret_cast<T const*>(&buffer));
+                first += sizeof(T);
+                return decode_status::ok;
+            }
+
+            template <typename T, std::size_t I>
+            static decode_status _call(
+                /*is_raw_serializable<T>=*/std::false_type, index<I>,
+                unsigned char const*& first, unsigned char const* last, V& v)
+            {
+                return serialize<T>::decode(first, last, v.template emplace<I>());
+            }
+
+            template <typename I>
+            static decode_status call(
+                unsigned char const*& first, unsigned char const* const& last,
+                V& v)
+            {
+                using T = typename std::remove_const<
+                    typename variant_element<I::value, V>::type>::type;
+                return _call<T>(is_raw_serializable<T>{}, I{}, first, last, v);
+            }
+        };
+
+        template <typename ...Ts>
+        decode_status decode_which(
+            unsigned char const*& first, unsigned char const* last,
+            std::size_t& which) noexcept
+        {
+            std::uint64_t value = 0;
+            decode_status const status =
+                detail::decode_varint(first, last, value);
+            if (status != decode_status::ok)
+                return status;
+            if (value > sizeof...(Ts))
+                return decode_status::malformed;
+
+            which = static_cast<std::size_t>(value);
+            return decode_status::ok;
+        }
+
+        template <typename V>
+        void reset(V& v)
+        {
+            detail::access::storage(v).emplace(index<0>{});
+        }
+
+        inline void reset(variant<>& /*v*/) noexcept
+        {}
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    //! template <class ...Ts, class OutputIt>
+    //! OutputIt encode(variant<Ts...> const& v, OutputIt out);
+    //!
+    //! \requires `serialize<T>` shall be enabled for all `T` in `Ts...`.
+    //!  `OutputIt` shall be an output iterator that accepts `unsigned char`.
+    //!
+    //! \effects Writes to `out` the discriminator `v.which() + 1`, or `0` if
+    //!  `v` has no active member, as a variable-length integer of 7 bits per
+    //!  byte, followed by the encoding of the active member if any. Variants
+    //!  with fewer than 128 alternatives use a single byte for the
+    //!  discriminator.
+    //!
+    //! \returns The advanced output iterator.
+    template <typename ...Ts, typename OutputIt>
+    OutputIt encode(variant<Ts...> const& v, OutputIt out)
+    {
+        std::size_t const which = detail::access::storage(v).which();
+        out = detail::encode_varint(which, out);
+        return which != 0
+          ? detail::encode_alternative<OutputIt>{}(
+                detail::pack<Ts...>{}, which - 1
+              , v.target(), detail::move(out))
+          : out;
+    }
+
+    //! template <class ...Ts>
+    //! decode_status try_decode(unsigned char const*& first, unsigned char const* last, variant<Ts...>& v);
+    //!
+    //! \requires `serialize<T>` shall be enabled for all `T` in `Ts...`. All
+    //!  alternatives `T` for which `serialize<T>` is not a library provided
+    //!  specialization shall be default constructible.
+    //!
+    //! \effects Decodes a `variant` encoded as if by `encode` from the bytes
+    //!  in `[first, last)` into `v`. If successful, advances `first` past the
+    //!  encoded value; otherwise, `first` is unchanged and `v` has no active
+    //!  member.
+    //!
+    //! \returns `decode_status::ok` if successful; otherwise, the reason for
+    //!  the failure.
+    //!
+    //! \remarks No byte outside of `[first, last)` is ever read, and the
+    //!  discriminator is validated, which makes this function suitable to
+    //!  decode untrusted input as long as `serialize<T>::decode` is for every
+    //!  alternative `T`; see `serialize`.
+    template <typename ...Ts>
+    decode_status try_decode(
+        unsigned char const*& first, unsigned char const* last,
+        variant<Ts...>& v)
+    {
+        unsigned char const* it = first;
+        std::size_t which = 0;
+        decode_status status =
+            detail::decode_which<Ts...>(it, last, which);
+        if (status == decode_status::ok)
+        {
+            if (which != 0)
+            {
+                status = detail::decode_alternative<variant<Ts...>>{}(
+                    detail::typed_index_pack<detail::pack<Ts...>>{}, which - 1
+                  , it, last, v);
+            } else {
+                detail::reset(v);
+            }
+        }
+
+        if (status == decode_status::ok)
+        {
+            first = it;
+        } else {
+            detail::reset(v);
+        }
+        return status;
+    }
+
+    //! template <class Variant>
+    //! Variant decode(unsigned char const*& first, unsigned char const* last);
+    //!
+    //! \requires `Variant` shall be a specialization of `variant`.
+    //!
+    //! \effects Equivalent to `Variant v; try_decode(first, last, v);`.
+    //!
+    //! \returns `v`.
+    //!
+    //! \throws `bad_variant_decode` if `try_decode` fails.
+    template <
+        typename Variant
+      , typename Enable = typename std::enable_if<
+            detail::is_variant<Variant>::value>::type
+    >
+    Variant decode(unsigned char const*& first, unsigned char const* last)
+    {
+        Variant v;
+        decode_status const status = variants::try_decode(first, last, v);
+        if (status != decode_status::ok)
+            detail::throw_bad_variant_decode<void>(status);
+        return v;
+    }
+
+    //! template <class ...Ts>
+    //! struct serialize<variant<Ts...>>;
+    //!
+    //! \remarks Enabled if `serialize<T>` is enabled for all `T` in `Ts...`.
+    //!  Encodes nested variants as if by `encode`.
+    template <typename ...Ts>
+    struct serialize<variant<Ts...>>
+    {
+        template <typename OutputIt>
+        static OutputIt encode(variant<Ts...> const& value, OutputIt out)
+        {
+            return variants::encode(value, out);
+        }
+
+        static decode_status decode(
+            unsigned char const*& first, unsigned char const* last,
+            variant<Ts...>& value)
+        {
+            return variants::try_decode(first, last, value);
+        }
+    };
+
+    namespace detail
+    {
+        ///////////////////////////////////////////////////////////////////////
+        template <typename F>
+        struct decode_apply_alternative
+          : visitor<
+                decode_apply_alternative<F>
+              , decode_status(
+                    unsigned char const*&, unsigned char const* const&, F&)
+            >
+        {
+            template <typename T>
+            static decode_status _call(
+                /*is_raw_serializable<T>=*/std::true_type,
+                unsigned char const*& first, unsigned char const* last, F& f)
+            {
+                if (static_cast<std::size_t>(last - first) < sizeof(T))
+                    return decode_status::incomplete;
+
+                typename std::aligned_storage<
+                    sizeof(T), std::alignment_of<T>::value>::type buffer;
+                std::memcpy(&buffer, first, sizeof(T));
+                first += sizeof(T);
+                f(detail::move(*reinterpret_cast<T*>(&buffer)));
+                return decode_status::ok;
+            }
+
+            template <typename T>
+            static decode_status _call(
+                /*is_raw_serializable<T>=*/std::false_type,
+                unsigned char const*& first, unsigned char const* last, F& f)
+            {
+                T value;
+                decode_status const status =
+                    serialize<T>::decode(first, last, value);
+                if (status == decode_status::ok)
+                    f(detail::move(value));
+                return status;
+            }
+
+            template <typename T>
+            static decode_status call(
+                unsigned char const*& first, unsigned char const* const& last,
+                F& f)
+            {
+                using U = typename std::remove_const<T>::type;
+                return _call<U>(is_raw_serializable<U>{}, first, last, f);
+            }
+        };
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    //! template <class ...Ts>
+    //! class variant_decoder;
+    //!
+    //! A `variant_decoder` decodes a stream of `variant<Ts...>` records
+    //! encoded as if by `encode` that arrives in chunks of arbitrary size. A
+    //! record that spans chunks is kept until it completes, and every record
+    //! is delivered as soon as its last byte is fed. Records that lie within
+    //! a single chunk are decoded in place, without copying.
+    //!
+    //! \requires `serialize<T>` shall be enabled for all `T` in `Ts...`. All
+    //!  alternatives `T` for which `serialize<T>` is not a library provided
+    //!  specialization shall be default constructible.
+    template <typename ...Ts>
+    class variant_decoder
+    {
+        template <typename F>
+        struct _decode_variant
+        {
+            decode_status operator()(
+                unsigned char const*& first, unsigned char const* last) const
+            {
+                variant<Ts...> v;
+                decode_status const status =
+                    variants::try_decode(first, last, v);
+                if (status == decode_status::ok)
+                    f(detail::move(v));
+                return status;
+            }
+
+            F& f;
+        };
+
+        template <typename F>
+        struct _decode_apply
+        {
+            decode_status operator()(
+                unsigned char const*& first, unsigned char const* last) const
+            {
+                unsigned char const* it = first;
+                std::size_t which = 0;
+                decode_status status =
+                    detail::decode_which<Ts...>(it, last, which);
+                if (status == decode_status::ok && which != 0)
+                {
+                    status = detail::decode_apply_alternative<F>{}(
+                        detail::pack<Ts...>{}, which - 1, it, last, f);
+                }
+                if (status == decode_status::ok)
+                    first = it;
+                return status;
+            }
+
+            F& f;
+        };
+
+    public:
+        //! variant_decoder() noexcept;
+        //!
+        //! \postconditions `pending() == 0`.
+        variant_decoder() noexcept
+          : _buffer(), _malformed(false)
+        {}
+
+        //! template <class F>
+        //! decode_status feed(unsigned char const* first, unsigned char const* last, F&& f);
+        //!
+        //! \effects Consumes the bytes in `[first, last)`, and calls `f` with
+        //!  an rvalue of type `variant<Ts...>` for each record that completes,
+        //!  in order. Bytes of a trailing incomplete record are kept for
+        //!  subsequent calls.
+        //!
+        //! \returns `decode_status::malformed` if the stream does not hold a
+        //!  valid encoding, in which case no further records are delivered
+        //!  until `reset()` is called; otherwise, `decode_status::ok`.
+        //!
+        //! \remarks If `f` exits via an exception, the bytes in `[first,
+        //!  last)` past the record being delivered are not consumed, and no
+        //!  record spanning previous calls is kept.
+        template <typename F>
+        decode_status feed(
+            unsigned char const* first, unsigned char const* last, F&& f)
+        {
+            _decode_variant<F> decode = {f};
+            return _feed(first, last, decode);
+        }
+
+        //! template <class F>
+        //! decode_status feed_apply(unsigned char const* first, unsigned char const* last, F&& f);
+        //!
+        //! \effects Equivalent to `feed(first, last, g)`, where `g` is a
+        //!  function object that calls `f` with an rvalue of the active member
+        //!  of the `variant` it receives, if any, except that no `variant` is
+        //!  constructed. Records with no active member are skipped.
+        //!
+        //! \remarks The active member is decoded into a local object of its
+        //!  own type, dispatched through a table on the discriminator.
+        template <typename F>
+        decode_status feed_apply(
+            unsigned char const* first, unsigned char const* last, F&& f)
+        {
+            _decode_apply<F> decode = {f};
+            return _feed(first, last, decode);
+        }
+
+        //! std::size_t pending() const noexcept;
+        //!
+        //! \returns The number of bytes of an incomplete record kept from
+        //!  previous calls.
+        std::size_t pending() const noexcept
+        {
+            return _buffer.size();
+        }
+
+        //! void reset() noexcept;
+        //!
+        //! \effects Discards any incomplete record and any decoding error.
+        //!
+        //! \postconditions `pending() == 0`.
+        void reset() noexcept
+        {
+            _buffer.clear();
+            _malformed = false;
+        }
+
+    private:
+        template <typename Decode>
+        decode_status _feed(
+            unsigned char const* first, unsigned char const* last,
+            Decode const& decode)
+        {
+            if (_malformed)
+                return decode_status::malformed;
+
+            if (!_buffer.empty())
+            {
+                // complete the pending record, growing the buffer
+                // geometrically to bound the copies by the record size
+                std::vector<unsigned char> buffer;
+                buffer.swap(_buffer);
+                for (;;)
+                {
+                    std::size_t const count = (std::min)(
+                        static_cast<std::size_t>(last - first),
+                        (std::max)(buffer.size(), std::size_t(64)));
+                    buffer.insert(buffer.end(), first, first + count);
+                    first += count;
+
+                    unsigned char const* it = buffer.data();
+                    unsigned char const* end = buffer.data() + buffer.size();
+                    decode_status const status = decode(it, end);
+                    if (status == decode_status::ok)
+                    {
+                        first -= end - it;
+                        break;
+                    } else if (status == decode_status::malformed) {
+                        _malformed = true;
+                        return status;
+                    } else if (first == last) {
+                        _buffer.swap(buffer);
+                        return decode_status::ok;
+                    }
+                }
+            }
+
+            while (first != last)
+            {
+                unsigned char const* it = first;
+                decode_status const status = decode(it, last);
+                if (status == decode_status::ok)
+                {
+                    first = it;
+                } else if (status == decode_status::malformed) {
+                    _malformed = true;
+                    return status;
+                } else {
+                    _buffer.assign(first, last);
+                    break;
+                }
+            }
+            return decode_status::ok;
+        }
+
+    private:
+        std::vector<unsigned char> _buffer;
+        bool _malformed;
+    };
+}}
+
+#include "detail/config/suffix.hpp"
+
+#endif /*EGGS_VARIANT_SERIALIZATION_HPP*/
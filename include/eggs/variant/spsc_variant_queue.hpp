@@ -0,0 +1,186 @@
+//! \file eggs/variant/spsc_variant_queue.hpp
+// Eggs.Variant
+//
+// Copyright Agustin K-ballo Berge, Fusion Fenix 2014-2018
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef EGGS_VARIANT_SPSC_VARIANT_QUEUE_HPP
+#define EGGS_VARIANT_SPSC_VARIANT_QUEUE_HPP
+
+#include "detail/apply.hpp"
+#include "detail/concurrency.hpp"
+#include "detail/pack.hpp"
+#include "detail/storage.hpp"
+#include "detail/utility.hpp"
+
+#include "variant.hpp"
+
+#include <atomic>
+#include <cstddef>
+
+#include "detail/config/prefix.hpp"
+
+namespace eggs { namespace variants
+{
+    ///////////////////////////////////////////////////////////////////////////
+    //! template <class ...Ts>
+    //! class spsc_variant_queue;
+    //!
+    //! A `spsc_variant_queue` is a fixed-capacity ring of slots, each holding
+    //! the storage of a `variant<Ts...>`, shared by a single producer thread
+    //! and a single consumer thread. The producer constructs elements
+    //! directly in a slot, and the consumer visits them in place and then
+    //! destroys them, so an element is neither moved nor copied in transit.
+    //!
+    //! Each slot and each of the producer and consumer positions occupies its
+    //! own cache line, so that the producer and the consumer contend only on
+    //! slots they hand to each other.
+    template <typename ...Ts>
+    class spsc_variant_queue
+    {
+        struct alignas(detail::cache_line_size) _slot
+        {
+            detail::storage<Ts...> storage;
+        };
+
+        struct alignas(detail::cache_line_size) _position
+        {
+            std::atomic<std::size_t> value;
+            std::size_t cached; // last seen value of the other position
+        };
+
+    public:
+        //! explicit spsc_variant_queue(std::size_t capacity);
+        //!
+        //! \effects Constructs an empty queue that holds at least `capacity`
+        //!  elements.
+        explicit spsc_variant_queue(std::size_t capacity)
+          : _slots(detail::round_up_pow2(capacity > 0 ? capacity : 1))
+          , _mask(_slots.size() - 1)
+        {
+            _head.value = 0;
+            _head.cached = 0;
+            _tail.value = 0;
+            _tail.cached = 0;
+        }
+
+        spsc_variant_queue(spsc_variant_queue const&) = delete;
+        spsc_variant_queue& operator=(spsc_variant_queue const&) = delete;
+
+        //! std::size_t capacity() const noexcept;
+        //!
+        //! \returns The maximum number of elements the queue can hold.
+        std::size_t capacity() const noexcept
+        {
+            return _slots.size();
+        }
+
+        //! bool empty() const noexcept;
+        //!
+        //! \returns `true` if the queue held no elements at some point during
+        //!  the call; otherwise, `false`.
+        bool empty() const noexcept
+        {
+            return _head.value.load(std::memory_order_acquire)
+                == _tail.value.load(std::memory_order_acquire);
+        }
+
+        //! template <std::size_t I, class ...Args>
+        //! bool try_emplace(Args&&... args);
+        //!
+        //! \requires Only the producer thread shall call this function.
+        //!  `I < sizeof...(Ts)`; otherwise, the program is ill-formed.
+        //!
+        //! \effects If the queue is not full, constructs the `I`th member of
+        //!  a `variant<Ts...>` in the next slot with `std::forward<Args>(
+        //!  args)...` and makes it available to the consumer.
+        //!
+        //! \returns `true` if an element was constructed; otherwise, `false`.
+        //!
+        //! \remarks If the initialization of the member exits via an
+        //!  exception, the queue is unchanged.
+        template <
+            std::size_t I, typename ...Args
+          , typename T = typename detail::checked_at_index<
+                I, detail::pack<Ts...>>::type
+        >
+        bool try_emplace(Args&&... args)
+        {
+            std::size_t const tail = _tail.value.load(std::memory_order_relaxed);
+            if (tail - _tail.cached == _slots.size())
+            {
+                _tail.cached = _head.value.load(std::memory_order_acquire);
+                if (tail - _tail.cached == _slots.size())
+                    return false;
+            }
+
+            _slots[tail & _mask].storage.emplace(
+                detail::index<I + 1>{}, detail::forward<Args>(args)...);
+            _tail.value.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        //! template <class T, class ...Args>
+        //! bool try_emplace(Args&&... args);
+        //!
+        //! \requires Only the producer thread shall call this function. The
+        //!  type `T` occurs exactly once in `Ts...`; otherwise, the program is
+        //!  ill-formed.
+        //!
+        //! \effects Equivalent to `return try_emplace<I>(std::forward<Args>(
+        //!  args)...);` where `I` is the zero-based index of `T` in `Ts...`.
+        template <
+            typename T, typename ...Args
+          , std::size_t I = detail::checked_index_of<
+                T, detail::pack<Ts...>>::value
+        >
+        bool try_emplace(Args&&... args)
+        {
+            return try_emplace<I>(detail::forward<Args>(args)...);
+        }
+
+        //! template <class F>
+        //! bool try_consume(F&& f);
+        //!
+        //! \requires Only the consumer thread shall call this function.
+        //!
+        //! \effects If the queue is not empty, calls `INVOKE(std::forward<F>(
+        //!  f), m)`, where `m` is an lvalue that designates the active member
+        //!  of the oldest element in place, and then destroys the element.
+        //!  `f` may move from `m`.
+        //!
+        //! \returns `true` if an element was consumed; otherwise, `false`.
+        //!
+        //! \remarks If `f` exits via an exception, the element is not
+        //!  consumed.
+        template <typename F>
+        bool try_consume(F&& f)
+        {
+            std::size_t const head = _head.value.load(std::memory_order_relaxed);
+            if (head == _head.cached)
+            {
+                _head.cached = _tail.value.load(std::memory_order_acquire);
+                if (head == _head.cached)
+                    return false;
+            }
+
+            detail::storage<Ts...>& storage = _slots[head & _mask].storage;
+            detail::apply<void>(detail::forward<F>(f), storage);
+            storage.emplace(detail::index<0>{});
+            _head.value.store(head + 1, std::memory_order_release);
+            return true;
+        }
+
+    private:
+        detail::aligned_array<_slot> _slots;
+        std::size_t const _mask;
+        _position _head;
+        _position _tail;
+    };
+}}
+
+#include "detail/config/suffix.hpp"
+
+#endif /*EGGS_VARIANT_SPSC_VARIANT_QUEUE_HPP*/
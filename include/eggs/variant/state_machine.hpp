@@ -0,0 +1,334 @@
+//! \file eggs/variant/state_machine.hpp
+// Eggs.Variant
+//
+// Copyright Agustin K-ballo Berge, Fusion Fenix 2014-2018
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef EGGS_VARIANT_STATE_MACHINE_HPP
+#define EGGS_VARIANT_STATE_MACHINE_HPP
+
+#include "detail/pack.hpp"
+#include "detail/utility.hpp"
+#include "detail/visitor.hpp"
+
+#include "in_place.hpp"
+#include "variant.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "detail/config/prefix.hpp"
+
+namespace eggs { namespace variants
+{
+    ///////////////////////////////////////////////////////////////////////////
+    //! template <class S, class ...Args>
+    //! struct state_transition;
+    //!
+    //! A `state_transition` requests a `state_machine` to enter a state of
+    //! type `S`, constructed in place from the arguments it references.
+    template <typename S, typename ...Args>
+    struct state_transition
+    {
+        std::tuple<Args...> args;
+    };
+
+    //! template <class S, class ...Args>
+    //! constexpr state_transition<S, Args&&...> transition_to(Args&&... args) noexcept;
+    //!
+    //! \returns A `state_transition<S, Args&&...>` that references `args...`.
+    //!
+    //! \remarks The arguments are used after the current state has been
+    //!  destroyed, so they shall not refer to it.
+    template <typename S, typename ...Args>
+    EGGS_CXX11_CONSTEXPR state_transition<S, Args&&...> transition_to(
+        Args&&... args) noexcept
+    {
+        return {std::tuple<Args&&...>(detail::forward<Args>(args)...)};
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    namespace detail
+    {
+        template <typename F, typename S, typename E>
+        static auto _handles_transition(int) -> decltype(
+            void(std::declval<F&>()(std::declval<S&>(), std::declval<E const&>()))
+          , std::true_type{});
+
+        template <typename F, typename S, typename E>
+        static std::false_type _handles_transition(...);
+
+        template <typename F, typename S, typename E>
+        struct handles_transition
+          : decltype(detail::_handles_transition<F, S, E>(0))
+        {};
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    //! template <class States, class Events>
+    //! class state_machine;
+    //!
+    //! A `state_machine` holds the current state of a machine as a
+    //! `variant<Ss...>` and drives it with events of type `variant<Es...>`.
+    //! Transitions are the overloads of a function object `f` called as
+    //! `f(s, e)`, where `s` is an lvalue that designates the current state
+    //! and `e` is a const lvalue that designates the event:
+    //!
+    //! - if there is no such overload, the event is ignored;
+    //! - if it returns `void`, the machine remains in the current state,
+    //!   which the overload may have modified;
+    //! - if it returns a `state_transition<S, Args...>`, the current state
+    //!   is destroyed and then a state of type `S` is constructed in its
+    //!   place from the referenced arguments;
+    //! - otherwise, it shall return one of the state types `S`, and the
+    //!   current state is destroyed and replaced by the returned one.
+    //!
+    //! A pair of state and event is dispatched with a single jump through a
+    //! table of `sizeof...(Ss) * sizeof...(Es)` entries, indexed by the
+    //! `which()` of both.
+    template <typename States, typename Events>
+    class state_machine;
+
+    template <typename ...Ss, typename ...Es>
+    class state_machine<variant<Ss...>, variant<Es...>>
+    {
+        EGGS_CXX11_STATIC_CONSTEXPR std::size_t _states = sizeof...(Ss);
+        EGGS_CXX11_STATIC_CONSTEXPR std::size_t _events = sizeof...(Es);
+
+        using _table_indices = typename detail::_make_typed_pack<
+            detail::make_index_pack<_states * _events>>::type;
+
+        template <typename F>
+        struct _dispatch
+          : detail::visitor<
+                _dispatch<F>, bool(state_machine&, F&, void const*)>
+        {
+            template <typename I>
+            static bool call(state_machine& sm, F& f, void const* ptr)
+            {
+                using S = typename detail::at_index<
+                    I::value / _events, detail::pack<Ss...>>::type;
+                using E = typename detail::at_index<
+                    I::value % _events, detail::pack<Es...>>::type;
+                return sm.template _handle<I::value / _events>(
+                    f, *static_cast<S*>(sm._state.target())
+                  , *static_cast<E const*>(ptr)
+                  , detail::handles_transition<F, S, E>{});
+            }
+        };
+
+    public:
+        using state_type = variant<Ss...>;
+        using event_type = variant<Es...>;
+
+    public:
+        //! explicit state_machine(variant<Ss...> initial);
+        //!
+        //! \effects Initializes the current state with `std::move(initial)`.
+        //!
+        //! \postconditions `transition_count() == 0`.
+        explicit state_machine(state_type initial)
+          : _state(detail::move(initial))
+          , _transitions()
+        {}
+
+        //! template <std::size_t I, class ...Args>
+        //! explicit state_machine(in_place_index_t<I>, Args&&... args);
+        //!
+        //! \effects Initializes the current state as if by `variant<Ss...>(
+        //!  in_place<I>, std::forward<Args>(args)...)`.
+        //!
+        //! \postconditions `transition_count() == 0`.
+        template <std::size_t I, typename ...Args>
+        explicit state_machine(in_place_index_t<I> which, Args&&... args)
+          : _state(which, detail::forward<Args>(args)...)
+          , _transitions()
+        {}
+
+        //! template <class T, class ...Args>
+        //! explicit state_machine(in_place_type_t<T>, Args&&... args);
+        //!
+        //! \effects Initializes the current state as if by `variant<Ss...>(
+        //!  in_place<T>, std::forward<Args>(args)...)`.
+        //!
+        //! \postconditions `transition_count() == 0`.
+        template <typename T, typename ...Args>
+        explicit state_machine(in_place_type_t<T> which, Args&&... args)
+          : _state(which, detail::forward<Args>(args)...)
+          , _transitions()
+        {}
+
+        //! variant<Ss...> const& state() const noexcept;
+        //!
+        //! \returns The current state.
+        state_type const& state() const noexcept
+        {
+            return _state;
+        }
+
+        //! template <class F>
+        //! bool dispatch(F&& f, variant<Es...> const& event);
+        //!
+        //! \effects If both the current state and `event` have an active
+        //!  member, calls the overload of `f` that handles them, if any, and
+        //!  performs the transition it requests.
+        //!
+        //! \returns `true` if an overload of `f` was called; otherwise,
+        //!  `false`.
+        //!
+        //! \remarks If the construction of the next state exits via an
+        //!  exception, the previous state has already been destroyed and the
+        //!  machine has no current state; it ignores events until a new state
+        //!  is set with `reset`.
+        template <typename F>
+        bool dispatch(F&& f, event_type const& event)
+        {
+            std::size_t const state = _state.which();
+            std::size_t const which = event.which();
+            if (state == state_type::npos || which == event_type::npos)
+                return false;
+
+            return _dispatch<typename std::remove_reference<F>::type>{}(
+                _table_indices{}, state * _events + which
+              , *this, f, event.target());
+        }
+
+        //! template <class F, class InputIt>
+        //! std::size_t dispatch(F&& f, InputIt first, InputIt last);
+        //!
+        //! \requires The value type of `InputIt` shall be `variant<Es...>`.
+        //!
+        //! \effects Dispatches each event in `[first, last)`, in order.
+        //!
+        //! \returns The number of events for which an overload of `f` was
+        //!  called.
+        template <typename F, typename InputIt>
+        std::size_t dispatch(F&& f, InputIt first, InputIt last)
+        {
+            std::size_t handled = 0;
+            for (; first != last; ++first)
+            {
+                if (dispatch(f, *first))
+                    ++handled;
+            }
+            return handled;
+        }
+
+        //! template <std::size_t I, class ...Args>
+        //! void reset(Args&&... args);
+        //!
+        //! \effects Destroys the current state, if any, and then constructs
+        //!  the `I`th state type in its place with `std::forward<Args>(
+        //!  args)...`, without counting it as a transition.
+        template <std::size_t I, typename ...Args>
+        void reset(Args&&... args)
+        {
+            _state.template emplace<I>(detail::forward<Args>(args)...);
+        }
+
+        //! template <class T, class ...Args>
+        //! void reset(Args&&... args);
+        //!
+        //! \effects Equivalent to `reset<I>(std::forward<Args>(args)...)`
+        //!  where `I` is the zero-based index of `T` in `Ss...`.
+        template <typename T, typename ...Args>
+        void reset(Args&&... args)
+        {
+            _state.template emplace<T>(detail::forward<Args>(args)...);
+        }
+
+        //! std::uint64_t transition_count() const noexcept;
+        //!
+        //! \returns The number of transitions performed, including those
+        //!  from a state to another of the same type.
+        std::uint64_t transition_count() const noexcept
+        {
+            std::uint64_t count = 0;
+            for (std::uint64_t const edge : _transitions)
+                count += edge;
+            return count;
+        }
+
+        //! std::uint64_t transition_count(std::size_t from, std::size_t to) const noexcept;
+        //!
+        //! \returns The number of transitions performed from the state
+        //!  alternative at index `from` to the one at index `to`, or `0` if
+        //!  either is out of range.
+        std::uint64_t transition_count(
+            std::size_t from, std::size_t to) const noexcept
+        {
+            return from < _states && to < _states
+              ? _transitions[from * _states + to] : 0;
+        }
+
+    private:
+        template <std::size_t From, typename F, typename S, typename E>
+        bool _handle(F& /*f*/, S& /*s*/, E const& /*e*/, std::false_type)
+        {
+            return false;
+        }
+
+        template <std::size_t From, typename F, typename S, typename E>
+        bool _handle(F& f, S& s, E const& e, std::true_type)
+        {
+            using R = decltype(f(s, e));
+            _enter<From>(f, s, e, std::is_void<R>{});
+            return true;
+        }
+
+        template <std::size_t From, typename F, typename S, typename E>
+        void _enter(F& f, S& s, E const& e, std::true_type /*void*/)
+        {
+            f(s, e);
+        }
+
+        template <std::size_t From, typename F, typename S, typename E>
+        void _enter(F& f, S& s, E const& e, std::false_type /*void*/)
+        {
+            _enter<From>(f(s, e));
+        }
+
+        template <std::size_t From, typename S, typename ...Args>
+        void _enter(state_transition<S, Args...>&& next)
+        {
+            _enter<From, S>(
+                next.args, detail::make_index_pack<sizeof...(Args)>{});
+        }
+
+        template <
+            std::size_t From, typename S, typename Args, std::size_t ...Is
+        >
+        void _enter(Args& args, detail::pack_c<std::size_t, Is...>)
+        {
+            EGGS_CXX11_STATIC_CONSTEXPR std::size_t To =
+                detail::checked_index_of<S, detail::pack<Ss...>>::value;
+            _state.template emplace<To>(
+                std::forward<typename std::tuple_element<Is, Args>::type>(
+                    std::get<Is>(args))...);
+            ++_transitions[From * _states + To];
+        }
+
+        template <std::size_t From, typename T>
+        void _enter(T&& next)
+        {
+            EGGS_CXX11_STATIC_CONSTEXPR std::size_t To =
+                detail::checked_index_of<
+                    typename std::decay<T>::type, detail::pack<Ss...>>::value;
+            _state.template emplace<To>(detail::forward<T>(next));
+            ++_transitions[From * _states + To];
+        }
+
+    private:
+        state_type _state;
+        std::uint64_t _transitions[_states * _states];
+    };
+}}
+
+#include "detail/config/suffix.hpp"
+
+#endif /*EGGS_VARIANT_STATE_MACHINE_HPP*/
@@ -0,0 +1,197 @@
+//! \file eggs/variant/task_variant.hpp
+// Eggs.Variant
+//
+// Copyright Agustin K-ballo Berge, Fusion Fenix 2014-2018
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef EGGS_VARIANT_TASK_VARIANT_HPP
+#define EGGS_VARIANT_TASK_VARIANT_HPP
+
+#include "detail/pack.hpp"
+#include "detail/storage.hpp"
+#include "detail/utility.hpp"
+#include "detail/visitor.hpp"
+
+#include "bad_variant_access.hpp"
+#include "in_place.hpp"
+#include "variant.hpp"
+
+#include <cstddef>
+#include <type_traits>
+
+#include "detail/config/prefix.hpp"
+
+namespace eggs { namespace variants
+{
+    ///////////////////////////////////////////////////////////////////////////
+    //! template <class ...Fs>
+    //! class task_variant;
+    //!
+    //! A `task_variant` holds one callable object out of a closed set of
+    //! types `Fs...`, each of which shall be callable with no arguments. The
+    //! callable is stored inline, as the active member of a `variant<Fs...>`
+    //! would be, so constructing a `task_variant` never allocates, and it is
+    //! called through a jump table indexed by the type of the callable held.
+    //!
+    //! The result of calling the held callable, if any, is discarded.
+    template <typename ...Fs>
+    class task_variant
+    {
+        struct _call
+          : detail::visitor<_call, void(void*)>
+        {
+            template <typename F>
+            static void call(void* ptr)
+            {
+                (*static_cast<F*>(ptr))();
+            }
+        };
+
+    public:
+        //! static constexpr std::size_t npos = std::size_t(-1);
+        EGGS_CXX11_STATIC_CONSTEXPR std::size_t npos = std::size_t(-1);
+
+    public:
+        //! task_variant() noexcept;
+        //!
+        //! \postconditions `*this` holds no callable.
+        task_variant() noexcept
+          : _storage()
+        {}
+
+        //! task_variant(task_variant const& rhs);
+        //!
+        //! \effects If `rhs` holds a callable, initializes the held callable
+        //!  as if direct-non-list-initializing it with a copy of the one held
+        //!  by `rhs`.
+        task_variant(task_variant const& rhs) = default;
+
+        //! task_variant(task_variant&& rhs) noexcept(see below);
+        //!
+        //! \effects If `rhs` holds a callable, initializes the held callable
+        //!  as if direct-non-list-initializing it with the one held by `rhs`
+        //!  moved. `rhs` still holds a callable in a moved-from state.
+        task_variant(task_variant&& rhs) = default;
+
+        //! template <class F>
+        //! task_variant(F&& f);
+        //!
+        //! \effects Initializes the held callable as if direct-non-list-
+        //!  initializing an object of type `std::decay_t<F>` with
+        //!  `std::forward<F>(f)`.
+        //!
+        //! \remarks This constructor shall not participate in overload
+        //!  resolution unless `std::decay_t<F>` occurs exactly once in
+        //!  `Fs...`.
+        template <
+            typename F
+          , std::size_t I = detail::index_of<
+                typename std::decay<F>::type, detail::pack<Fs...>>::value
+        >
+        task_variant(F&& f)
+          : _storage()
+        {
+            _storage.emplace(detail::index<I + 1>{}, detail::forward<F>(f));
+        }
+
+        //! template <std::size_t I, class ...Args>
+        //! explicit task_variant(in_place_index_t<I>, Args&&... args);
+        //!
+        //! \effects Initializes the held callable as if direct-non-list-
+        //!  initializing an object of the `I`th type in `Fs...` with
+        //!  `std::forward<Args>(args)...`.
+        template <
+            std::size_t I, typename ...Args
+          , typename F = typename detail::checked_at_index<
+                I, detail::pack<Fs...>>::type
+        >
+        explicit task_variant(in_place_index_t<I>, Args&&... args)
+          : _storage()
+        {
+            _storage.emplace(
+                detail::index<I + 1>{}, detail::forward<Args>(args)...);
+        }
+
+        //! template <class F, class ...Args>
+        //! explicit task_variant(in_place_type_t<F>, Args&&... args);
+        //!
+        //! \effects Equivalent to `task_variant(in_place<I>,
+        //!  std::forward<Args>(args)...)` where `I` is the zero-based index of
+        //!  `F` in `Fs...`.
+        template <
+            typename F, typename ...Args
+          , std::size_t I = detail::checked_index_of<
+                F, detail::pack<Fs...>>::value
+        >
+        explicit task_variant(in_place_type_t<F>, Args&&... args)
+          : _storage()
+        {
+            _storage.emplace(
+                detail::index<I + 1>{}, detail::forward<Args>(args)...);
+        }
+
+        //! task_variant& operator=(task_variant const& rhs);
+        //!
+        //! \effects Equivalent to `variant<Fs...>` copy assignment.
+        task_variant& operator=(task_variant const& rhs) = default;
+
+        //! task_variant& operator=(task_variant&& rhs) noexcept(see below);
+        //!
+        //! \effects Equivalent to `variant<Fs...>` move assignment.
+        task_variant& operator=(task_variant&& rhs) = default;
+
+        //! explicit operator bool() const noexcept;
+        //!
+        //! \returns `true` if `*this` holds a callable; otherwise, `false`.
+        explicit operator bool() const noexcept
+        {
+            return _storage.which() != 0;
+        }
+
+        //! std::size_t which() const noexcept;
+        //!
+        //! \returns The zero-based index of the type of the held callable in
+        //!  `Fs...`, or `npos` if `*this` holds no callable.
+        std::size_t which() const noexcept
+        {
+            return _storage.which() != 0 ? _storage.which() - 1 : npos;
+        }
+
+        //! void operator()();
+        //!
+        //! \effects Calls the held callable with no arguments.
+        //!
+        //! \throws `bad_variant_access` if `*this` holds no callable, or any
+        //!  exception thrown by the call.
+        void operator()()
+        {
+            std::size_t const which = _storage.which();
+            if (which == 0)
+                return detail::throw_bad_variant_access<void>();
+
+            _call{}(detail::pack<Fs...>{}, which - 1, _storage.target());
+        }
+
+        //! void reset() noexcept;
+        //!
+        //! \effects Destroys the held callable, if any.
+        //!
+        //! \postconditions `*this` holds no callable.
+        void reset() noexcept
+        {
+            _storage.emplace(detail::index<0>{});
+        }
+
+    private:
+        detail::storage<Fs...> _storage;
+    };
+
+    template <typename ...Fs>
+    std::size_t const task_variant<Fs...>::npos;
+}}
+
+#include "detail/config/suffix.hpp"
+
+#endif /*EGGS_VARIANT_TASK_VARIANT_HPP*/
@@ -104,6 +104,11 @@ namespace eggs { namespace variants
             static_assert(count <= 1, "type occurs more than once in variant alternatives");
         };
 
+        // the types the alternatives are accessed as, see `unboxed`
+        template <typename ...Ts>
+        using unboxed_pack = pack<
+            typename unboxed<typename std::remove_cv<Ts>::type>::type...>;
+
         ///////////////////////////////////////////////////////////////////////
         namespace _best_match
         {
@@ -434,7 +439,8 @@ namespace eggs { namespace variants
 
             template <
                 typename ...Ts, size_t I
-              , typename T = typename at_index<I, pack<Ts...>>::type
+              , typename T = typename unboxed<
+                    typename at_index<I, pack<Ts...>>::type>::type
             >
             EGGS_CXX14_CONSTEXPR static T& get(
                 variant<Ts...>& v, index<I>) noexcept
@@ -444,7 +450,8 @@ namespace eggs { namespace variants
 
             template <
                 typename ...Ts, size_t I
-              , typename T = typename at_index<I, pack<Ts...>>::type
+              , typename T = typename unboxed<
+                    typename at_index<I, pack<Ts...>>::type>::type
             >
             EGGS_CXX11_CONSTEXPR static T const& get(
                 variant<Ts...> const& v, index<I>) noexcept
@@ -791,14 +798,16 @@ namespace eggs { namespace variants
         template <
             typename T, typename ...Args
           , std::size_t I = detail::index_of<
-                T, detail::pack<typename std::remove_cv<Ts>::type...>>::value
+                T, detail::unboxed_pack<Ts...>>::value
+          , typename M = typename detail::at_index<
+                I, detail::pack<Ts...>>::type
           , typename Enable = typename std::enable_if<std::is_constructible<
-                T, Args...>::value>::type
+                M, Args...>::value>::type
         >
         EGGS_CXX11_CONSTEXPR explicit variant(
             in_place_type_t<T>, Args&&... args)
 #if EGGS_CXX11_STD_HAS_IS_NOTHROW_TRAITS
-            noexcept(std::is_nothrow_constructible<T, Args...>::value)
+            noexcept(std::is_nothrow_constructible<M, Args...>::value)
 #endif
           : _storage{detail::index<I + 1>{}, detail::forward<Args>(args)...}
         {}
@@ -819,15 +828,17 @@ namespace eggs { namespace variants
         template <
             typename T, typename U, typename ...Args
           , std::size_t I = detail::index_of<
-                T, detail::pack<typename std::remove_cv<Ts>::type...>>::value
+                T, detail::unboxed_pack<Ts...>>::value
+          , typename M = typename detail::at_index<
+                I, detail::pack<Ts...>>::type
           , typename Enable = typename std::enable_if<std::is_constructible<
-                T, std::initializer_list<U>&, Args...>::value>::type
+                M, std::initializer_list<U>&, Args...>::value>::type
         >
         EGGS_CXX11_CONSTEXPR explicit variant(
             in_place_type_t<T>, std::initializer_list<U> il, Args&&... args)
 #if EGGS_CXX11_STD_HAS_IS_NOTHROW_TRAITS
             noexcept(std::is_nothrow_constructible<
-                T, std::initializer_list<U>&, Args...>::value)
+                M, std::initializer_list<U>&, Args...>::value)
 #endif
           : _storage{detail::index<I + 1>{}, il, detail::forward<Args>(args)...}
         {}
@@ -1014,7 +1025,8 @@ namespace eggs { namespace variants
           , typename Enable = typename std::enable_if<
                 std::is_constructible<T, Args...>::value>::type
         >
-        EGGS_CXX14_CONSTEXPR T& emplace(Args&&... args)
+        EGGS_CXX14_CONSTEXPR typename detail::unboxed<T>::type& emplace(
+            Args&&... args)
 #if EGGS_CXX11_STD_HAS_IS_NOTHROW_TRAITS
             noexcept(std::is_nothrow_constructible<T, Args...>::value)
 #endif
@@ -1057,7 +1069,8 @@ namespace eggs { namespace variants
           , typename Enable = typename std::enable_if<std::is_constructible<
                 T, std::initializer_list<U>&, Args...>::value>::type
         >
-        EGGS_CXX14_CONSTEXPR T& emplace(std::initializer_list<U> il, Args&&... args)
+        EGGS_CXX14_CONSTEXPR typename detail::unboxed<T>::type& emplace(
+            std::initializer_list<U> il, Args&&... args)
 #if EGGS_CXX11_STD_HAS_IS_NOTHROW_TRAITS
             noexcept(std::is_nothrow_constructible<
                 T, std::initializer_list<U>&, Args...>::value)
@@ -1084,13 +1097,15 @@ namespace eggs { namespace variants
         template <
             typename T, typename ...Args
           , std::size_t I = detail::checked_index_of<
-                T, detail::pack<typename std::remove_cv<Ts>::type...>>::value
+                T, detail::unboxed_pack<Ts...>>::value
+          , typename M = typename detail::at_index<
+                I, detail::pack<Ts...>>::type
           , typename Enable = typename std::enable_if<
-                std::is_constructible<T, Args...>::value>::type
+                std::is_constructible<M, Args...>::value>::type
         >
         EGGS_CXX14_CONSTEXPR T& emplace(Args&&... args)
 #if EGGS_CXX11_STD_HAS_IS_NOTHROW_TRAITS
-            noexcept(std::is_nothrow_constructible<T, Args...>::value)
+            noexcept(std::is_nothrow_constructible<M, Args...>::value)
 #endif
         {
             return _storage.emplace(
@@ -1114,14 +1129,16 @@ namespace eggs { namespace variants
         template <
             typename T, typename U, typename ...Args
           , std::size_t I = detail::checked_index_of<
-                T, detail::pack<typename std::remove_cv<Ts>::type...>>::value
+                T, detail::unboxed_pack<Ts...>>::value
+          , typename M = typename detail::at_index<
+                I, detail::pack<Ts...>>::type
           , typename Enable = typename std::enable_if<std::is_constructible<
-                T, std::initializer_list<U>&, Args...>::value>::type
+                M, std::initializer_list<U>&, Args...>::value>::type
         >
         EGGS_CXX14_CONSTEXPR T& emplace(std::initializer_list<U> il, Args&&... args)
 #if EGGS_CXX11_STD_HAS_IS_NOTHROW_TRAITS
             noexcept(std::is_nothrow_constructible<
-                T, std::initializer_list<U>&, Args...>::value)
+                M, std::initializer_list<U>&, Args...>::value)
 #endif
         {
             return _storage.emplace(
@@ -1227,7 +1244,10 @@ namespace eggs { namespace variants
         //!
         //! \returns If `*this` has an active member of type `T` or of a type
         //!  of which `T` is an unambiguous and accessible base class, a
-        //!  pointer to the active member; otherwise a null pointer.
+        //!  pointer to the active member; otherwise a null pointer. An active
+        //!  member of type `boxed<U>` or `recursive<U>` is accessed as the
+        //!  object of type `U` it holds, so `target<U>()` points to that
+        //!  object and `target<boxed<U>>()` is a null pointer.
         //!
         //! \remarks This function shall be a `constexpr` function.
         template <typename T>
@@ -1246,7 +1266,10 @@ namespace eggs { namespace variants
         //!
         //! \returns If `*this` has an active member of type `T` or of a type
         //!  of which `T` is an unambiguous and accessible base class, a
-        //!  pointer to the active member; otherwise a null pointer.
+        //!  pointer to the active member; otherwise a null pointer. An active
+        //!  member of type `boxed<U>` or `recursive<U>` is accessed as the
+        //!  object of type `U` it holds, so `target<U>()` points to that
+        //!  object and `target<boxed<U>>()` is a null pointer.
         //!
         //! \remarks This function shall be a `constexpr` function.
         template <typename T>
@@ -1392,8 +1415,8 @@ namespace eggs { namespace variants
     //! \remarks This function shall be a `constexpr` function.
     template <
         std::size_t I, typename ...Ts
-      , typename T = typename detail::checked_at_index<
-            I, detail::pack<Ts...>>::type
+      , typename T = typename detail::unboxed<typename detail::checked_at_index<
+            I, detail::pack<Ts...>>::type>::type
     >
     EGGS_CXX14_CONSTEXPR T& get(variant<Ts...>& v)
     {
@@ -1415,8 +1438,8 @@ namespace eggs { namespace variants
     //! \remarks This function shall be a `constexpr` function.
     template <
         std::size_t I, typename ...Ts
-      , typename T = typename detail::checked_at_index<
-            I, detail::pack<Ts...>>::type
+      , typename T = typename detail::unboxed<typename detail::checked_at_index<
+            I, detail::pack<Ts...>>::type>::type
     >
     EGGS_CXX11_CONSTEXPR T const& get(variant<Ts...> const& v)
     {
@@ -1436,8 +1459,8 @@ namespace eggs { namespace variants
     //! \remarks This function shall be a `constexpr` function.
     template <
         std::size_t I, typename ...Ts
-      , typename T = typename detail::checked_at_index<
-            I, detail::pack<Ts...>>::type
+      , typename T = typename detail::unboxed<typename detail::checked_at_index<
+            I, detail::pack<Ts...>>::type>::type
     >
     EGGS_CXX14_CONSTEXPR T&& get(variant<Ts...>&& v)
     {
@@ -1455,8 +1478,8 @@ namespace eggs { namespace variants
     //! \remarks This function shall be a `constexpr` function.
     template <
         std::size_t I, typename ...Ts
-      , typename T = typename detail::checked_at_index<
-            I, detail::pack<Ts...>>::type
+      , typename T = typename detail::unboxed<typename detail::checked_at_index<
+            I, detail::pack<Ts...>>::type>::type
     >
     EGGS_CXX14_CONSTEXPR T const&& get(variant<Ts...> const&& v)
     {
@@ -1478,7 +1501,7 @@ namespace eggs { namespace variants
     template <
         typename T, typename ...Ts
       , std::size_t I = detail::checked_index_of<
-            T, detail::pack<typename std::remove_cv<Ts>::type...>>::value
+            T, detail::unboxed_pack<Ts...>>::value
     >
     EGGS_CXX14_CONSTEXPR T& get(variant<Ts...>& v)
     {
@@ -1503,7 +1526,7 @@ namespace eggs { namespace variants
     template <
         typename T, typename ...Ts
       , std::size_t I = detail::checked_index_of<
-            T, detail::pack<typename std::remove_cv<Ts>::type...>>::value
+            T, detail::unboxed_pack<Ts...>>::value
     >
     EGGS_CXX11_CONSTEXPR T const& get(variant<Ts...> const& v)
     {
@@ -1524,7 +1547,7 @@ namespace eggs { namespace variants
     template <
         typename T, typename ...Ts
       , std::size_t I = detail::checked_index_of<
-            T, detail::pack<typename std::remove_cv<Ts>::type...>>::value
+            T, detail::unboxed_pack<Ts...>>::value
     >
     EGGS_CXX14_CONSTEXPR T&& get(variant<Ts...>&& v)
     {
@@ -1543,7 +1566,7 @@ namespace eggs { namespace variants
     template <
         typename T, typename ...Ts
       , std::size_t I = detail::checked_index_of<
-            T, detail::pack<typename std::remove_cv<Ts>::type...>>::value
+            T, detail::unboxed_pack<Ts...>>::value
     >
     EGGS_CXX14_CONSTEXPR T const&& get(variant<Ts...> const&& v)
     {
@@ -1562,8 +1585,8 @@ namespace eggs { namespace variants
     //! \remarks This function shall be a `constexpr` function.
     template <
         std::size_t I, typename ...Ts
-      , typename T = typename detail::checked_at_index<
-            I, detail::pack<Ts...>>::type
+      , typename T = typename detail::unboxed<typename detail::checked_at_index<
+            I, detail::pack<Ts...>>::type>::type
     >
     EGGS_CXX14_CONSTEXPR T* get_if(variant<Ts...>* v) noexcept
     {
@@ -1583,8 +1606,8 @@ namespace eggs { namespace variants
     //! \remarks This function shall be a `constexpr` function.
     template <
         std::size_t I, typename ...Ts
-      , typename T = typename detail::checked_at_index<
-            I, detail::pack<Ts...>>::type
+      , typename T = typename detail::unboxed<typename detail::checked_at_index<
+            I, detail::pack<Ts...>>::type>::type
     >
     EGGS_CXX11_CONSTEXPR T const* get_if(variant<Ts...> const* v) noexcept
     {
@@ -1606,7 +1629,7 @@ namespace eggs { namespace variants
     template <
         typename T, typename ...Ts
       , std::size_t I = detail::checked_index_of<
-            T, detail::pack<typename std::remove_cv<Ts>::type...>>::value
+            T, detail::unboxed_pack<Ts...>>::value
     >
     EGGS_CXX14_CONSTEXPR T* get_if(variant<Ts...>* v) noexcept
     {
@@ -1628,7 +1651,7 @@ namespace eggs { namespace variants
     template <
         typename T, typename ...Ts
       , std::size_t I = detail::checked_index_of<
-            T, detail::pack<typename std::remove_cv<Ts>::type...>>::value
+            T, detail::unboxed_pack<Ts...>>::value
     >
     EGGS_CXX11_CONSTEXPR T const* get_if(variant<Ts...> const* v) noexcept
     {
@@ -1888,27 +1911,28 @@ namespace eggs { namespace variants
     //! template <class ...Ts, class T>
     //! constexpr bool operator==(variant<Ts...> const& lhs, U const& rhs);
     //!
-    //! Let `T` be one of the types in `Ts...` for which `rhs` is
-    //!  unambiguously convertible to by overload resolution rules.
+    //! Let `T` be one of the types the alternatives `Ts...` are accessed as
+    //!  for which `rhs` is unambiguously convertible to by overload
+    //!  resolution rules, and `I` the zero-based index of its alternative.
     //!
-    //! \requires The expression `*lhs.target<T>() == rhs` shall be
-    //!  convertible to `bool`.
+    //! \requires The expression `get<I>(lhs) == rhs` shall be convertible to
+    //!  `bool`.
     //!
-    //! \returns If `lhs` has an active member of type `T`,
-    //!  `*lhs.target<T>() == rhs`; otherwise, `false`.
+    //! \returns If `lhs.which() == I`, `get<I>(lhs) == rhs`; otherwise,
+    //!  `false`.
     //!
     //! \remarks This function shall not participate in overload resolution
-    //!  unless there is a type `T` in `Ts...` for which `rhs` is
-    //!  unambiguously convertible to by overload resolution rules, and the
-    //!  expression `*lhs.target<T>() == rhs` is well-formed. This function
-    //!  shall be a `constexpr` function unless `lhs` has an active member of
-    //!  type `T` and `*lhs.target<T>() == rhs` is not a constant expression.
+    //!  unless there is such a type `T` for which `rhs` is unambiguously
+    //!  convertible to by overload resolution rules, and the expression
+    //!  `get<I>(lhs) == rhs` is well-formed. This function shall be a
+    //!  `constexpr` function unless `lhs.which() == I` and
+    //!  `get<I>(lhs) == rhs` is not a constant expression.
     template <
         typename ...Ts, typename U
       , std::size_t I = detail::index_of_best_match<
-            U const&, detail::pack<Ts...>>::value
+            U const&, detail::unboxed_pack<Ts...>>::value
       , typename T = typename detail::at_index<
-            I, detail::pack<Ts...>>::type
+            I, detail::unboxed_pack<Ts...>>::type
       , typename Enable = typename std::enable_if<
             detail::has_equal_to<T const&, U const&>::value>::type
     >
@@ -1916,34 +1940,35 @@ namespace eggs { namespace variants
         variant<Ts...> const& lhs, U const& rhs)
     {
         return lhs.which() == I
-          ? *lhs.template target<T>() == rhs
+          ? detail::access::get(lhs, detail::index<I>{}) == rhs
           : false;
     }
 
     //! template <class T, class ...Ts>
     //! constexpr bool operator==(U const& lhs, variant<Ts...> const& rhs);
     //!
-    //! Let `T` be one of the types in `Ts...` for which `lhs` is
-    //!  unambiguously convertible to by overload resolution rules.
+    //! Let `T` be one of the types the alternatives `Ts...` are accessed as
+    //!  for which `lhs` is unambiguously convertible to by overload
+    //!  resolution rules, and `I` the zero-based index of its alternative.
     //!
-    //! \requires The expression `lhs == *rhs.target<T>()` shall be
-    //!  convertible to `bool`.
+    //! \requires The expression `lhs == get<I>(rhs)` shall be convertible to
+    //!  `bool`.
     //!
-    //! \returns If `rhs` has an active member of type `T`,
-    //!  `lhs == *rhs.target<T>()`; otherwise, `false`.
+    //! \returns If `rhs.which() == I`, `lhs == get<I>(rhs)`; otherwise,
+    //!  `false`.
     //!
     //! \remarks This function shall not participate in overload resolution
-    //!  unless there is a type `T` in `Ts...` for which `lhs` is
-    //!  unambiguously convertible to by overload resolution rules, and the
-    //!  expression `lhs == *rhs.target<T>()' is well-formed. This function
-    //!  shall be a `constexpr` function unless `rhs` has an active member of
-    //!  type `T` and `lhs == *rhs.target<T>()` is not a constant expression.
+    //!  unless there is such a type `T` for which `lhs` is unambiguously
+    //!  convertible to by overload resolution rules, and the expression
+    //!  `lhs == get<I>(rhs)` is well-formed. This function shall be a
+    //!  `constexpr` function unless `rhs.which() == I` and
+    //!  `lhs == get<I>(rhs)` is not a constant expression.
     template <
         typename U, typename ...Ts
       , std::size_t I = detail::index_of_best_match<
-            U const&, detail::pack<Ts...>>::value
+            U const&, detail::unboxed_pack<Ts...>>::value
       , typename T = typename detail::at_index<
-            I, detail::pack<Ts...>>::type
+            I, detail::unboxed_pack<Ts...>>::type
       , typename Enable = typename std::enable_if<
             detail::has_equal_to<T const&, U const&>::value>::type
     >
@@ -1951,34 +1976,35 @@ namespace eggs { namespace variants
         U const& lhs, variant<Ts...> const& rhs)
     {
         return rhs.which() == I
-          ? lhs == *rhs.template target<T>()
+          ? lhs == detail::access::get(rhs, detail::index<I>{})
           : false;
     }
 
     //! template <class ...Ts, class T>
     //! constexpr bool operator!=(variant<Ts...> const& lhs, U const& rhs);
     //!
-    //! Let `T` be one of the types in `Ts...` for which `rhs` is
-    //!  unambiguously convertible to by overload resolution rules.
+    //! Let `T` be one of the types the alternatives `Ts...` are accessed as
+    //!  for which `rhs` is unambiguously convertible to by overload
+    //!  resolution rules, and `I` the zero-based index of its alternative.
     //!
-    //! \requires The expression `*lhs.target<T>() != rhs` shall be
-    //!  convertible to `bool`.
+    //! \requires The expression `get<I>(lhs) != rhs` shall be convertible to
+    //!  `bool`.
     //!
-    //! \returns If `lhs` has an active member of type `T`,
-    //!  `*lhs.target<T>() != rhs`; otherwise, `true`.
+    //! \returns If `lhs.which() == I`, `get<I>(lhs) != rhs`; otherwise,
+    //!  `true`.
     //!
     //! \remarks This function shall not participate in overload resolution
-    //!  unless there is a type `T` in `Ts...` for which `rhs` is
-    //!  unambiguously convertible to by overload resolution rules, and the
-    //!  expression `*lhs.target<T>() != rhs` is well-formed. This function
-    //!  shall be a `constexpr` function unless `lhs` has an active member of
-    //!  type `T` and `*lhs.target<T>() != rhs` is not a constant expression.
+    //!  unless there is such a type `T` for which `rhs` is unambiguously
+    //!  convertible to by overload resolution rules, and the expression
+    //!  `get<I>(lhs) != rhs` is well-formed. This function shall be a
+    //!  `constexpr` function unless `lhs.which() == I` and
+    //!  `get<I>(lhs) != rhs` is not a constant expression.
     template <
         typename ...Ts, typename U
       , std::size_t I = detail::index_of_best_match<
-            U const&, detail::pack<Ts...>>::value
+            U const&, detail::unboxed_pack<Ts...>>::value
       , typename T = typename detail::at_index<
-            I, detail::pack<Ts...>>::type
+            I, detail::unboxed_pack<Ts...>>::type
       , typename Enable = typename std::enable_if<
             detail::has_not_equal_to<T const&, U const&>::value>::type
     >
@@ -1986,34 +2012,35 @@ namespace eggs { namespace variants
         variant<Ts...> const& lhs, U const& rhs)
     {
         return lhs.which() == I
-          ? *lhs.template target<T>() != rhs
+          ? detail::access::get(lhs, detail::index<I>{}) != rhs
           : true;
     }
 
     //! template <class T, class ...Ts>
     //! constexpr bool operator!=(U const& lhs, variant<Ts...> const& rhs);
     //!
-    //! Let `T` be one of the types in `Ts...` for which `lhs` is
-    //!  unambiguously convertible to by overload resolution rules.
+    //! Let `T` be one of the types the alternatives `Ts...` are accessed as
+    //!  for which `lhs` is unambiguously convertible to by overload
+    //!  resolution rules, and `I` the zero-based index of its alternative.
     //!
-    //! \requires The expression `lhs != *rhs.target<T>()` shall be
-    //!  convertible to `bool`.
+    //! \requires The expression `lhs != get<I>(rhs)` shall be convertible to
+    //!  `bool`.
     //!
-    //! \returns If `rhs` has an active member of type `T`,
-    //!  `lhs != *rhs.target<T>()`; otherwise, `true`.
+    //! \returns If `rhs.which() == I`, `lhs != get<I>(rhs)`; otherwise,
+    //!  `true`.
     //!
     //! \remarks This function shall not participate in overload resolution
-    //!  unless there is a type `T` in `Ts...` for which `lhs` is
-    //!  unambiguously convertible to by overload resolution rules, and the
-    //!  expression `lhs != *rhs.target<T>()' is well-formed. This function
-    //!  shall be a `constexpr` function unless `rhs` has an active member of
-    //!  type `T` and `lhs != *rhs.target<T>()` is not a constant expression.
+    //!  unless there is such a type `T` for which `lhs` is unambiguously
+    //!  convertible to by overload resolution rules, and the expression
+    //!  `lhs != get<I>(rhs)` is well-formed. This function shall be a
+    //!  `constexpr` function unless `rhs.which() == I` and
+    //!  `lhs != get<I>(rhs)` is not a constant expression.
     template <
         typename U, typename ...Ts
       , std::size_t I = detail::index_of_best_match<
-            U const&, detail::pack<Ts...>>::value
+            U const&, detail::unboxed_pack<Ts...>>::value
       , typename T = typename detail::at_index<
-            I, detail::pack<Ts...>>::type
+            I, detail::unboxed_pack<Ts...>>::type
       , typename Enable = typename std::enable_if<
             detail::has_not_equal_to<T const&, U const&>::value>::type
     >
@@ -2021,35 +2048,35 @@ namespace eggs { namespace variants
         U const& lhs, variant<Ts...> const& rhs)
     {
         return rhs.which() == I
-          ? lhs != *rhs.template target<T>()
+          ? lhs != detail::access::get(rhs, detail::index<I>{})
           : true;
     }
 
     //! template <class ...Ts, class T>
     //! constexpr bool operator<(variant<Ts...> const& lhs, U const& rhs);
     //!
-    //! Let `T` be one of the types in `Ts...` for which `rhs` is
-    //!  unambiguously convertible to by overload resolution rules.
+    //! Let `T` be one of the types the alternatives `Ts...` are accessed as
+    //!  for which `rhs` is unambiguously convertible to by overload
+    //!  resolution rules, and `I` the zero-based index of its alternative.
     //!
-    //! \requires The expression `*lhs.target<T>() < rhs` shall be
-    //!  convertible to `bool`.
+    //! \requires The expression `get<I>(lhs) < rhs` shall be convertible to
+    //!  `bool`.
     //!
-    //! \returns If `!bool(lhs)`, `true`; otherwise, if `lhs` has an active
-    //!  member of type `T`, `*lhs.target<T>() < rhs`; otherwise,
-    //!  `lhs.which() < I` where `I` is the zero-based index of `T` in `Ts...`.
+    //! \returns If `!bool(lhs)`, `true`; otherwise, if `lhs.which() == I`,
+    //!  `get<I>(lhs) < rhs`; otherwise, `lhs.which() < I`.
     //!
     //! \remarks This function shall not participate in overload resolution
-    //!  unless there is a type `T` in `Ts...` for which `rhs` is
-    //!  unambiguously convertible to by overload resolution rules, and the
-    //!  expression `*lhs.target<T>() < rhs` is well-formed. This function
-    //!  shall be a `constexpr` function unless `lhs` has an active member of
-    //!  type `T` and `*lhs.target<T>() < rhs` is not a constant expression.
+    //!  unless there is such a type `T` for which `rhs` is unambiguously
+    //!  convertible to by overload resolution rules, and the expression
+    //!  `get<I>(lhs) < rhs` is well-formed. This function shall be a
+    //!  `constexpr` function unless `lhs.which() == I` and
+    //!  `get<I>(lhs) < rhs` is not a constant expression.
     template <
         typename ...Ts, typename U
       , std::size_t I = detail::index_of_best_match<
-            U const&, detail::pack<Ts...>>::value
+            U const&, detail::unboxed_pack<Ts...>>::value
       , typename T = typename detail::at_index<
-            I, detail::pack<Ts...>>::type
+            I, detail::unboxed_pack<Ts...>>::type
       , typename Enable = typename std::enable_if<
             detail::has_less<T const&, U const&>::value>::type
     >
@@ -2057,7 +2084,7 @@ namespace eggs { namespace variants
         variant<Ts...> const& lhs, U const& rhs)
     {
         return lhs.which() == I
-          ? *lhs.template target<T>() < rhs
+          ? detail::access::get(lhs, detail::index<I>{}) < rhs
           : bool(lhs)
               ? lhs.which() < I
               : true;
@@ -2066,28 +2093,28 @@ namespace eggs { namespace variants
     //! template <class T, class ...Ts>
     //! constexpr bool operator<(U const& lhs, variant<Ts...> const& rhs);
     //!
-    //! Let `T` be one of the types in `Ts...` for which `lhs` is
-    //!  unambiguously convertible to by overload resolution rules.
+    //! Let `T` be one of the types the alternatives `Ts...` are accessed as
+    //!  for which `lhs` is unambiguously convertible to by overload
+    //!  resolution rules, and `I` the zero-based index of its alternative.
     //!
-    //! \requires The expression `lhs < *rhs.target<T>()` shall be
-    //!  convertible to `bool`.
+    //! \requires The expression `lhs < get<I>(rhs)` shall be convertible to
+    //!  `bool`.
     //!
-    //! \returns If `!bool(rhs)`, `false`; otherwise, if `rhs` has an active
-    //!  member of type `T`, `lhs < *rhs.target<T>()`; otherwise,
-    //!  `I < rhs.which()` where `I` is the zero-based index of `T` in `Ts...`.
+    //! \returns If `!bool(rhs)`, `false`; otherwise, if `rhs.which() == I`,
+    //!  `lhs < get<I>(rhs)`; otherwise, `I < rhs.which()`.
     //!
     //! \remarks This function shall not participate in overload resolution
-    //!  unless there is a type `T` in `Ts...` for which `lhs` is
-    //!  unambiguously convertible to by overload resolution rules, and the
-    //!  expression `lhs < *rhs.target<T>()' is well-formed. This function
-    //!  shall be a `constexpr` function unless `rhs` has an active member of
-    //!  type `T` and `lhs < *rhs.target<T>()` is not a constant expression.
+    //!  unless there is such a type `T` for which `lhs` is unambiguously
+    //!  convertible to by overload resolution rules, and the expression
+    //!  `lhs < get<I>(rhs)` is well-formed. This function shall be a
+    //!  `constexpr` function unless `rhs.which() == I` and
+    //!  `lhs < get<I>(rhs)` is not a constant expression.
     template <
         typename U, typename ...Ts
       , std::size_t I = detail::index_of_best_match<
-            U const&, detail::pack<Ts...>>::value
+            U const&, detail::unboxed_pack<Ts...>>::value
       , typename T = typename detail::at_index<
-            I, detail::pack<Ts...>>::type
+            I, detail::unboxed_pack<Ts...>>::type
       , typename Enable = typename std::enable_if<
             detail::has_less<T const&, U const&>::value>::type
     >
@@ -2095,7 +2122,7 @@ namespace eggs { namespace variants
         U const& lhs, variant<Ts...> const& rhs)
     {
         return rhs.which() == I
-          ? lhs < *rhs.template target<T>()
+          ? lhs < detail::access::get(rhs, detail::index<I>{})
           : bool(rhs)
               ? I < rhs.which()
               : false;
@@ -2104,28 +2131,28 @@ namespace eggs { namespace variants
     //! template <class ...Ts, class T>
     //! constexpr bool operator>(variant<Ts...> const& lhs, U const& rhs);
     //!
-    //! Let `T` be one of the types in `Ts...` for which `rhs` is
-    //!  unambiguously convertible to by overload resolution rules.
+    //! Let `T` be one of the types the alternatives `Ts...` are accessed as
+    //!  for which `rhs` is unambiguously convertible to by overload
+    //!  resolution rules, and `I` the zero-based index of its alternative.
     //!
-    //! \requires The expression `*lhs.target<T>() > rhs` shall be
-    //!  convertible to `bool`.
+    //! \requires The expression `get<I>(lhs) > rhs` shall be convertible to
+    //!  `bool`.
     //!
-    //! \returns If `!bool(lhs)`, `false`; otherwise, if `lhs` has an active
-    //!  member of type `T`, `*lhs.target<T>() > rhs`; otherwise,
-    //!  `lhs.which() > I` where `I` is the zero-based index of `T` in `Ts...`.
+    //! \returns If `!bool(lhs)`, `false`; otherwise, if `lhs.which() == I`,
+    //!  `get<I>(lhs) > rhs`; otherwise, `lhs.which() > I`.
     //!
     //! \remarks This function shall not participate in overload resolution
-    //!  unless there is a type `T` in `Ts...` for which `rhs` is
-    //!  unambiguously convertible to by overload resolution rules, and the
-    //!  expression `*lhs.target<T>() > rhs` is well-formed. This function
-    //!  shall be a `constexpr` function unless `lhs` has an active member of
-    //!  type `T` and `*lhs.target<T>() > rhs` is not a constant expression.
+    //!  unless there is such a type `T` for which `rhs` is unambiguously
+    //!  convertible to by overload resolution rules, and the expression
+    //!  `get<I>(lhs) > rhs` is well-formed. This function shall be a
+    //!  `constexpr` function unless `lhs.which() == I` and
+    //!  `get<I>(lhs) > rhs` is not a constant expression.
     template <
         typename ...Ts, typename U
       , std::size_t I = detail::index_of_best_match<
-            U const&, detail::pack<Ts...>>::value
+            U const&, detail::unboxed_pack<Ts...>>::value
       , typename T = typename detail::at_index<
-            I, detail::pack<Ts...>>::type
+            I, detail::unboxed_pack<Ts...>>::type
       , typename Enable = typename std::enable_if<
             detail::has_greater<T const&, U const&>::value>::type
     >
@@ -2133,7 +2160,7 @@ namespace eggs { namespace variants
         variant<Ts...> const& lhs, U const& rhs)
     {
         return lhs.which() == I
-          ? *lhs.template target<T>() > rhs
+          ? detail::access::get(lhs, detail::index<I>{}) > rhs
           : bool(lhs)
               ? lhs.which() > I
               : false;
@@ -2142,28 +2169,28 @@ namespace eggs { namespace variants
     //! template <class T, class ...Ts>
     //! constexpr bool operator>(U const& lhs, variant<Ts...> const& rhs);
     //!
-    //! Let `T` be one of the types in `Ts...` for which `lhs` is
-    //!  unambiguously convertible to by overload resolution rules.
+    //! Let `T` be one of the types the alternatives `Ts...` are accessed as
+    //!  for which `lhs` is unambiguously convertible to by overload
+    //!  resolution rules, and `I` the zero-based index of its alternative.
     //!
-    //! \requires The expression `lhs > *rhs.target<T>()` shall be
-    //!  convertible to `bool`.
+    //! \requires The expression `lhs > get<I>(rhs)` shall be convertible to
+    //!  `bool`.
     //!
-    //! \returns If `!bool(rhs)`, `true`; otherwise, if `rhs` has an active
-    //!  member of type `T`, `lhs > *rhs.target<T>()`; otherwise,
-    //!  `I > rhs.which()` where `I` is the zero-based index of `T` in `Ts...`.
+    //! \returns If `!bool(rhs)`, `true`; otherwise, if `rhs.which() == I`,
+    //!  `lhs > get<I>(rhs)`; otherwise, `I > rhs.which()`.
     //!
     //! \remarks This function shall not participate in overload resolution
-    //!  unless there is a type `T` in `Ts...` for which `lhs` is
-    //!  unambiguously convertible to by overload resolution rules, and the
-    //!  expression `lhs > *rhs.target<T>()' is well-formed. This function
-    //!  shall be a `constexpr` function unless `rhs` has an active member of
-    //!  type `T` and `lhs > *rhs.target<T>()` is not a constant expression.
+    //!  unless there is such a type `T` for which `lhs` is unambiguously
+    //!  convertible to by overload resolution rules, and the expression
+    //!  `lhs > get<I>(rhs)` is well-formed. This function shall be a
+    //!  `constexpr` function unless `rhs.which() == I` and
+    //!  `lhs > get<I>(rhs)` is not a constant expression.
     template <
         typename U, typename ...Ts
       , std::size_t I = detail::index_of_best_match<
-            U const&, detail::pack<Ts...>>::value
+            U const&, detail::unboxed_pack<Ts...>>::value
       , typename T = typename detail::at_index<
-            I, detail::pack<Ts...>>::type
+            I, detail::unboxed_pack<Ts...>>::type
       , typename Enable = typename std::enable_if<
             detail::has_greater<T const&, U const&>::value>::type
     >
@@ -2171,7 +2198,7 @@ namespace eggs { namespace variants
         U const& lhs, variant<Ts...> const& rhs)
     {
         return rhs.which() == I
-          ? lhs > *rhs.template target<T>()
+          ? lhs > detail::access::get(rhs, detail::index<I>{})
           : bool(rhs)
               ? I > rhs.which()
               : true;
@@ -2180,28 +2207,28 @@ namespace eggs { namespace variants
     //! template <class ...Ts, class T>
     //! constexpr bool operator<=(variant<Ts...> const& lhs, U const& rhs);
     //!
-    //! Let `T` be one of the types in `Ts...` for which `rhs` is
-    //!  unambiguously convertible to by overload resolution rules.
+    //! Let `T` be one of the types the alternatives `Ts...` are accessed as
+    //!  for which `rhs` is unambiguously convertible to by overload
+    //!  resolution rules, and `I` the zero-based index of its alternative.
     //!
-    //! \requires The expression `*lhs.target<T>() <= rhs` shall be
-    //!  convertible to `bool`.
+    //! \requires The expression `get<I>(lhs) <= rhs` shall be convertible to
+    //!  `bool`.
     //!
-    //! \returns If `!bool(lhs)`, `true`; otherwise, if `lhs` has an active
-    //!  member of type `T`, `*lhs.target<T>() <= rhs`; otherwise,
-    //!  `lhs.which() < I` where `I` is the zero-based index of `T` in `Ts...`.
+    //! \returns If `!bool(lhs)`, `true`; otherwise, if `lhs.which() == I`,
+    //!  `get<I>(lhs) <= rhs`; otherwise, `lhs.which() < I`.
     //!
     //! \remarks This function shall not participate in overload resolution
-    //!  unless there is a type `T` in `Ts...` for which `rhs` is
-    //!  unambiguously convertible to by overload resolution rules, and the
-    //!  expression `*lhs.target<T>() <= rhs` is well-formed. This function
-    //!  shall be a `constexpr` function unless `lhs` has an active member of
-    //!  type `T` and `*lhs.target<T>() <= rhs` is not a constant expression.
+    //!  unless there is such a type `T` for which `rhs` is unambiguously
+    //!  convertible to by overload resolution rules, and the expression
+    //!  `get<I>(lhs) <= rhs` is well-formed. This function shall be a
+    //!  `constexpr` function unless `lhs.which() == I` and
+    //!  `get<I>(lhs) <= rhs` is not a constant expression.
     template <
         typename ...Ts, typename U
       , std::size_t I = detail::index_of_best_match<
-            U const&, detail::pack<Ts...>>::value
+            U const&, detail::unboxed_pack<Ts...>>::value
       , typename T = typename detail::at_index<
-            I, detail::pack<Ts...>>::type
+            I, detail::unboxed_pack<Ts...>>::type
       , typename Enable = typename std::enable_if<
             detail::has_less_equal<T const&, U const&>::value>::type
     >
@@ -2209,7 +2236,7 @@ namespace eggs { namespace variants
         variant<Ts...> const& lhs, U const& rhs)
     {
         return lhs.which() == I
-          ? *lhs.template target<T>() <= rhs
+          ? detail::access::get(lhs, detail::index<I>{}) <= rhs
           : bool(lhs)
               ? lhs.which() < I
               : true;
@@ -2218,28 +2245,28 @@ namespace eggs { namespace variants
     //! template <class T, class ...Ts>
     //! constexpr bool operator<=(U const& lhs, variant<Ts...> const& rhs);
     //!
-    //! Let `T` be one of the types in `Ts...` for which `lhs` is
-    //!  unambiguously convertible to by overload resolution rules.
+    //! Let `T` be one of the types the alternatives `Ts...` are accessed as
+    //!  for which `lhs` is unambiguously convertible to by overload
+    //!  resolution rules, and `I` the zero-based index of its alternative.
     //!
-    //! \requires The expression `lhs <= *rhs.target<T>()` shall be
-    //!  convertible to `bool`.
+    //! \requires The expression `lhs <= get<I>(rhs)` shall be convertible to
+    //!  `bool`.
     //!
-    //! \returns If `!bool(rhs)`, `false`; otherwise, if `rhs` has an active
-    //!  member of type `T`, `lhs <= *rhs.target<T>()`; otherwise,
-    //!  `I < rhs.which()` where `I` is the zero-based index of `T` in `Ts...`.
+    //! \returns If `!bool(rhs)`, `false`; otherwise, if `rhs.which() == I`,
+    //!  `lhs <= get<I>(rhs)`; otherwise, `I < rhs.which()`.
     //!
     //! \remarks This function shall not participate in overload resolution
-    //!  unless there is a type `T` in `Ts...` for which `lhs` is
-    //!  unambiguously convertible to by overload resolution rules, and the
-    //!  expression `lhs <= *rhs.target<T>()' is well-formed. This function
-    //!  shall be a `constexpr` function unless `rhs` has an active member of
-    //!  type `T` and `lhs <= *rhs.target<T>()` is not a constant expression.
+    //!  unless there is such a type `T` for which `lhs` is unambiguously
+    //!  convertible to by overload resolution rules, and the expression
+    //!  `lhs <= get<I>(rhs)` is well-formed. This function shall be a
+    //!  `constexpr` function unless `rhs.which() == I` and
+    //!  `lhs <= get<I>(rhs)` is not a constant expression.
     template <
         typename U, typename ...Ts
       , std::size_t I = detail::index_of_best_match<
-            U const&, detail::pack<Ts...>>::value
+            U const&, detail::unboxed_pack<Ts...>>::value
       , typename T = typename detail::at_index<
-            I, detail::pack<Ts...>>::type
+            I, detail::unboxed_pack<Ts...>>::type
       , typename Enable = typename std::enable_if<
             detail::has_less_equal<T const&, U const&>::value>::type
     >
@@ -2247,7 +2274,7 @@ namespace eggs { namespace variants
         U const& lhs, variant<Ts...> const& rhs)
     {
         return rhs.which() == I
-          ? lhs <= *rhs.template target<T>()
+          ? lhs <= detail::access::get(rhs, detail::index<I>{})
           : bool(rhs)
               ? I < rhs.which()
               : false;
@@ -2256,28 +2283,28 @@ namespace eggs { namespace variants
     //! template <class ...Ts, class T>
     //! constexpr bool operator>=(variant<Ts...> const& lhs, U const& rhs);
     //!
-    //! Let `T` be one of the types in `Ts...` for which `rhs` is
-    //!  unambiguously convertible to by overload resolution rules.
+    //! Let `T` be one of the types the alternatives `Ts...` are accessed as
+    //!  for which `rhs` is unambiguously convertible to by overload
+    //!  resolution rules, and `I` the zero-based index of its alternative.
     //!
-    //! \requires The expression `*lhs.target<T>() >= rhs` shall be
-    //!  convertible to `bool`.
+    //! \requires The expression `get<I>(lhs) >= rhs` shall be convertible to
+    //!  `bool`.
     //!
-    //! \returns If `!bool(lhs)`, `false`; otherwise, if `lhs` has an active
-    //!  member of type `T`, `*lhs.target<T>() >= rhs`; otherwise,
-    //!  `lhs.which() > I` where `I` is the zero-based index of `T` in `Ts...`.
+    //! \returns If `!bool(lhs)`, `false`; otherwise, if `lhs.which() == I`,
+    //!  `get<I>(lhs) >= rhs`; otherwise, `lhs.which() > I`.
     //!
     //! \remarks This function shall not participate in overload resolution
-    //!  unless there is a type `T` in `Ts...` for which `rhs` is
-    //!  unambiguously convertible to by overload resolution rules, and the
-    //!  expression `*lhs.target<T>() >= rhs` is well-formed. This function
-    //!  shall be a `constexpr` function unless `lhs` has an active member of
-    //!  type `T` and `*lhs.target<T>() >= rhs` is not a constant expression.
+    //!  unless there is such a type `T` for which `rhs` is unambiguously
+    //!  convertible to by overload resolution rules, and the expression
+    //!  `get<I>(lhs) >= rhs` is well-formed. This function shall be a
+    //!  `constexpr` function unless `lhs.which() == I` and
+    //!  `get<I>(lhs) >= rhs` is not a constant expression.
     template <
         typename ...Ts, typename U
       , std::size_t I = detail::index_of_best_match<
-            U const&, detail::pack<Ts...>>::value
+            U const&, detail::unboxed_pack<Ts...>>::value
       , typename T = typename detail::at_index<
-            I, detail::pack<Ts...>>::type
+            I, detail::unboxed_pack<Ts...>>::type
       , typename Enable = typename std::enable_if<
             detail::has_greater_equal<T const&, U const&>::value>::type
     >
@@ -2285,7 +2312,7 @@ namespace eggs { namespace variants
         variant<Ts...> const& lhs, U const& rhs)
     {
         return lhs.which() == I
-          ? *lhs.template target<T>() >= rhs
+          ? detail::access::get(lhs, detail::index<I>{}) >= rhs
           : bool(lhs)
               ? lhs.which() > I
               : false;
@@ -2294,28 +2321,28 @@ namespace eggs { namespace variants
     //! template <class T, class ...Ts>
     //! constexpr bool operator>=(U const& lhs, variant<Ts...> const& rhs);
     //!
-    //! Let `T` be one of the types in `Ts...` for which `lhs` is
-    //!  unambiguously convertible to by overload resolution rules.
+    //! Let `T` be one of the types the alternatives `Ts...` are accessed as
+    //!  for which `lhs` is unambiguously convertible to by overload
+    //!  resolution rules, and `I` the zero-based index of its alternative.
     //!
-    //! \requires The expression `lhs >= *rhs.target<T>()` shall be
-    //!  convertible to `bool`.
+    //! \requires The expression `lhs >= get<I>(rhs)` shall be convertible to
+    //!  `bool`.
     //!
-    //! \returns If `!bool(rhs)`, `true`; otherwise, if `rhs` has an active
-    //!  member of type `T`, `lhs >= *rhs.target<T>()`; otherwise,
-    //!  `I > rhs.which()` where `I` is the zero-based index of `T` in `Ts...`.
+    //! \returns If `!bool(rhs)`, `true`; otherwise, if `rhs.which() == I`,
+    //!  `lhs >= get<I>(rhs)`; otherwise, `I > rhs.which()`.
     //!
     //! \remarks This function shall not participate in overload resolution
-    //!  unless there is a type `T` in `Ts...` for which `lhs` is
-    //!  unambiguously convertible to by overload resolution rules, and the
-    //!  expression `lhs >= *rhs.target<T>()' is well-formed. This function
-    //!  shall be a `constexpr` function unless `rhs` has an active member of
-    //!  type `T` and `lhs >= *rhs.target<T>()` is not a constant expression.
+    //!  unless there is such a type `T` for which `lhs` is unambiguously
+    //!  convertible to by overload resolution rules, and the expression
+    //!  `lhs >= get<I>(rhs)` is well-formed. This function shall be a
+    //!  `constexpr` function unless `rhs.which() == I` and
+    //!  `lhs >= get<I>(rhs)` is not a constant expression.
     template <
         typename U, typename ...Ts
       , std::size_t I = detail::index_of_best_match<
-            U const&, detail::pack<Ts...>>::value
+            U const&, detail::unboxed_pack<Ts...>>::value
       , typename T = typename detail::at_index<
-            I, detail::pack<Ts...>>::type
+            I, detail::unboxed_pack<Ts...>>::type
       , typename Enable = typename std::enable_if<
             detail::has_greater_equal<T const&, U const&>::value>::type
     >
@@ -2323,7 +2350,7 @@ namespace eggs { namespace variants
         U const& lhs, variant<Ts...> const& rhs)
     {
         return rhs.which() == I
-          ? lhs >= *rhs.template target<T>()
+          ? lhs >= detail::access::get(rhs, detail::index<I>{})
           : bool(rhs)
               ? I > rhs.which()
               : true;
@@ -0,0 +1,438 @@
+//! \file eggs/variant/variant_ref.hpp
+// Eggs.Variant
+//
+// Copyright Agustin K-ballo Berge, Fusion Fenix 2014-2018
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef EGGS_VARIANT_VARIANT_REF_HPP
+#define EGGS_VARIANT_VARIANT_REF_HPP
+
+#include "detail/apply.hpp"
+#include "detail/pack.hpp"
+#include "detail/utility.hpp"
+#include "detail/visitor.hpp"
+
+#include "bad_variant_access.hpp"
+#include "variant.hpp"
+
+#include <cstddef>
+#include <functional>
+#include <type_traits>
+
+#include "detail/config/prefix.hpp"
+
+namespace eggs { namespace variants
+{
+    ///////////////////////////////////////////////////////////////////////////
+    namespace detail
+    {
+        // the index of `T` in `Ts`, or else of `T const`, so that a
+        // reference to a const alternative binds to a non-const object
+        template <
+            typename T, typename Ts
+          , bool Empty = std::is_base_of<empty, index_of<T, Ts>>::value
+        >
+        struct ref_index_of
+          : index_of<T, Ts>
+        {};
+
+        template <typename T, typename Ts>
+        struct ref_index_of<T, Ts, /*Empty=*/true>
+          : index_of<T const, Ts>
+        {};
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    //! template <class ...Ts>
+    //! class variant_ref;
+    //!
+    //! A `variant_ref` refers to an object of one of the types `Ts...` that
+    //! lives elsewhere, either on its own or as the active member of a
+    //! `variant`, and keeps a pointer to it together with the zero-based
+    //! index of its type. It offers `apply`, `get`, `get_if` and the
+    //! relational operators of `variant<Ts...>`, dispatched through the same
+    //! kind of jump tables, without copying or moving the object referred
+    //! to. An alternative `T const` in `Ts...` refers to an object of type
+    //! `T` through a const access path.
+    //!
+    //! A `variant_ref` is trivially copyable; assigning to it rebinds it.
+    //!
+    //! \remarks The object referred to shall outlive its uses through the
+    //!  `variant_ref`, and for a `variant` it shall remain its active
+    //!  member.
+    template <typename ...Ts>
+    class variant_ref
+    {
+        template <typename R, typename F>
+        struct _apply
+          : detail::visitor<_apply<R, F>, R(F&, void*)>
+        {
+            template <typename T>
+            static R call(F& f, void* ptr)
+            {
+                return f(*static_cast<T*>(ptr));
+            }
+        };
+
+        template <typename V>
+        struct _address
+          : detail::visitor<_address<V>, void*(V&)>
+        {
+            template <typename I>
+            static void* call(V& v)
+            {
+                return const_cast<void*>(static_cast<void const*>(
+                    detail::addressof(variants::get<I::value>(v))));
+            }
+        };
+
+        template <typename V>
+        static void* _target(V& v)
+        {
+            return v.which() != npos
+              ? _address<V>{}(
+                    detail::typed_index_pack<detail::pack<Ts...>>{}
+                  , v.which(), v)
+              : nullptr;
+        }
+
+    public:
+        //! static constexpr std::size_t npos = std::size_t(-1);
+        EGGS_CXX11_STATIC_CONSTEXPR std::size_t npos = std::size_t(-1);
+
+    public:
+        //! constexpr variant_ref() noexcept;
+        //!
+        //! \postconditions `*this` refers to no object.
+        EGGS_CXX11_CONSTEXPR variant_ref() noexcept
+          : _ptr(nullptr), _which(npos)
+        {}
+
+        //! template <class T>
+        //! variant_ref(T& t) noexcept;
+        //!
+        //! \effects Refers to `t`, as the alternative `T`, or else `T const`.
+        //!
+        //! \remarks This constructor shall not participate in overload
+        //!  resolution unless `T`, or else `T const`, occurs exactly once in
+        //!  `Ts...`.
+        template <
+            typename T
+          , std::size_t I = detail::ref_index_of<T, detail::pack<Ts...>>::value
+        >
+        variant_ref(T& t) noexcept
+          : _ptr(const_cast<void*>(static_cast<void const*>(
+                detail::addressof(t))))
+          , _which(I)
+        {}
+
+        //! template <class ...Us>
+        //! variant_ref(variant<Us...>& v) noexcept;
+        //!
+        //! \effects Refers to the active member of `v`, if any; otherwise,
+        //!  refers to no object.
+        //!
+        //! \remarks This constructor shall not participate in overload
+        //!  resolution unless `std::remove_const_t<Ts>...` are the types an
+        //!  alternative of each of `Us...` is accessed as.
+        template <
+            typename ...Us
+          , typename Enable = typename std::enable_if<std::is_same<
+                detail::pack<typename std::remove_const<Ts>::type...>
+              , detail::unboxed_pack<Us...>
+            >::value>::type
+        >
+        variant_ref(variant<Us...>& v) noexcept
+          : _ptr(_target(v)), _which(v.which())
+        {}
+
+        //! template <class ...Us>
+        //! variant_ref(variant<Us...> const& v) noexcept;
+        //!
+        //! \effects Refers to the active member of `v`, if any; otherwise,
+        //!  refers to no object.
+        //!
+        //! \remarks This constructor shall not participate in overload
+        //!  resolution unless every type in `Ts...` is const, and
+        //!  `std::remove_const_t<Ts>...` are the types an alternative of each
+        //!  of `Us...` is accessed as.
+        template <
+            typename ...Us
+          , typename Enable = typename std::enable_if<std::is_same<
+                detail::pack<Ts...>
+              , detail::pack<typename std::add_const<
+                    typename detail::unboxed<Us>::type>::type...>
+            >::value>::type
+        >
+        variant_ref(variant<Us...> const& v) noexcept
+          : _ptr(_target(v)), _which(v.which())
+        {}
+
+        //! explicit operator bool() const noexcept;
+        //!
+        //! \returns `true` if `*this` refers to an object; otherwise, `false`.
+        explicit operator bool() const noexcept
+        {
+            return _which != npos;
+        }
+
+        //! std::size_t which() const noexcept;
+        //!
+        //! \returns The zero-based index of the type of the object referred
+        //!  to in `Ts...`, or `npos` if `*this` refers to no object.
+        std::size_t which() const noexcept
+        {
+            return _which;
+        }
+
+        //! void* target() const noexcept;
+        //!
+        //! \returns A pointer to the object referred to, or a null pointer if
+        //!  `*this` refers to no object.
+        void* target() const noexcept
+        {
+            return _ptr;
+        }
+
+        //! template <class T>
+        //! T* target() const noexcept;
+        //!
+        //! \returns If `*this` refers to an object as the alternative `T`, a
+        //!  pointer to it; otherwise, a null pointer.
+        template <typename T>
+        T* target() const noexcept
+        {
+            using I = detail::checked_index_of<T, detail::pack<Ts...>>;
+            return _which == I::value ? static_cast<T*>(_ptr) : nullptr;
+        }
+
+        //! template <class R, class F>
+        //! R apply(F&& f) const;
+        //!
+        //! \effects Calls `std::forward<F>(f)(t)`, where `t` is an lvalue
+        //!  that designates the object referred to, as its alternative type.
+        //!
+        //! \throws `bad_variant_access` if `*this` refers to no object.
+        template <typename R, typename F>
+        R apply(F&& f) const
+        {
+            if (_which == npos)
+                return detail::throw_bad_variant_access<R>();
+
+            return _apply<R, typename std::remove_reference<F>::type>{}(
+                detail::pack<Ts...>{}, _which, f, target());
+        }
+
+        //! template <class F>
+        //! R apply(F&& f) const;
+        //!
+        //! Let `R` be the common return type of every potentially evaluated
+        //!  `INVOKE` expression.
+        //!
+        //! \effects Equivalent to `apply<R>(std::forward<F>(f))`.
+        template <
+            int DeductionGuard = 0, typename F
+          , typename R = typename detail::_apply_result_combine<
+                typename detail::_result_of<
+                    typename std::remove_reference<F>::type&
+                  , detail::pack<Ts&>>::type...>::type
+        >
+        R apply(F&& f) const
+        {
+            return apply<R>(detail::forward<F>(f));
+        }
+
+    private:
+        void* _ptr;
+        std::size_t _which;
+    };
+
+    template <typename ...Ts>
+    std::size_t const variant_ref<Ts...>::npos;
+
+    ///////////////////////////////////////////////////////////////////////////
+    //! template <std::size_t I, class ...Ts>
+    //! variant_element_t<I, variant<Ts...>>& get(variant_ref<Ts...> r);
+    //!
+    //! \returns A reference to the object `r` refers to.
+    //!
+    //! \throws `bad_variant_access` if `r.which() != I`.
+    template <
+        std::size_t I, typename ...Ts
+      , typename T = typename detail::checked_at_index<
+            I, detail::pack<Ts...>>::type
+    >
+    T& get(variant_ref<Ts...> r)
+    {
+        return r.which() == I
+          ? *static_cast<T*>(r.target())
+          : detail::throw_bad_variant_access<T&>();
+    }
+
+    //! template <class T, class ...Ts>
+    //! T& get(variant_ref<Ts...> r);
+    //!
+    //! \effects Equivalent to `return get<I>(r);` where `I` is the
+    //!  zero-based index of `T` in `Ts...`.
+    template <
+        typename T, typename ...Ts
+      , std::size_t I = detail::checked_index_of<
+            T, detail::pack<Ts...>>::value
+    >
+    T& get(variant_ref<Ts...> r)
+    {
+        return variants::get<I>(r);
+    }
+
+    //! template <std::size_t I, class ...Ts>
+    //! variant_element_t<I, variant<Ts...>>* get_if(variant_ref<Ts...> const* r) noexcept;
+    //! template <class T, class ...Ts>
+    //! T* get_if(variant_ref<Ts...> const* r) noexcept;
+    //!
+    //! \returns If `r` is not a null pointer and `*r` refers to an object
+    //!  as the requested alternative, a pointer to it; otherwise, a null
+    //!  pointer.
+    template <
+        std::size_t I, typename ...Ts
+      , typename T = typename detail::checked_at_index<
+            I, detail::pack<Ts...>>::type
+    >
+    T* get_if(variant_ref<Ts...> const* r) noexcept
+    {
+        return r != nullptr && r->which() == I
+          ? static_cast<T*>(r->target()) : nullptr;
+    }
+
+    template <
+        typename T, typename ...Ts
+      , std::size_t I = detail::checked_index_of<
+            T, detail::pack<Ts...>>::value
+    >
+    T* get_if(variant_ref<Ts...> const* r) noexcept
+    {
+        return variants::get_if<I>(r);
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    namespace detail
+    {
+        struct ref_equal_to
+          : visitor<ref_equal_to, bool(void const*, void const*)>
+        {
+            template <typename T>
+            static bool call(void const* lhs, void const* rhs)
+            {
+                return *static_cast<T const*>(lhs) == *static_cast<T const*>(rhs);
+            }
+        };
+
+        struct ref_less
+          : visitor<ref_less, bool(void const*, void const*)>
+        {
+            template <typename T>
+            static bool call(void const* lhs, void const* rhs)
+            {
+                return *static_cast<T const*>(lhs) < *static_cast<T const*>(rhs);
+            }
+        };
+    }
+
+    //! template <class ...Ts>
+    //! bool operator==(variant_ref<Ts...> lhs, variant_ref<Ts...> rhs);
+    //!
+    //! \returns If `lhs.which() != rhs.which()`, `false`; otherwise, if
+    //!  `!bool(lhs)`, `true`; otherwise, `*lhs.target<T>() ==
+    //!  *rhs.target<T>()` where `T` is the alternative both refer to.
+    template <typename ...Ts>
+    bool operator==(variant_ref<Ts...> lhs, variant_ref<Ts...> rhs)
+    {
+        return lhs.which() == rhs.which()
+          && (!bool(lhs) || detail::ref_equal_to{}(
+                detail::pack<Ts...>{}, lhs.which()
+              , lhs.target(), rhs.target()));
+    }
+
+    //! template <class ...Ts>
+    //! bool operator!=(variant_ref<Ts...> lhs, variant_ref<Ts...> rhs);
+    //!
+    //! \returns `!(lhs == rhs)`.
+    template <typename ...Ts>
+    bool operator!=(variant_ref<Ts...> lhs, variant_ref<Ts...> rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+    //! template <class ...Ts>
+    //! bool operator<(variant_ref<Ts...> lhs, variant_ref<Ts...> rhs);
+    //!
+    //! \returns If `!bool(rhs)`, `false`; otherwise, if `!bool(lhs)`,
+    //!  `true`; otherwise, if `lhs.which() != rhs.which()`, `lhs.which() <
+    //!  rhs.which()`; otherwise, `*lhs.target<T>() < *rhs.target<T>()` where
+    //!  `T` is the alternative both refer to.
+    template <typename ...Ts>
+    bool operator<(variant_ref<Ts...> lhs, variant_ref<Ts...> rhs)
+    {
+        return bool(rhs) && (!bool(lhs)
+          || (lhs.which() != rhs.which()
+              ? lhs.which() < rhs.which()
+              : detail::ref_less{}(
+                    detail::pack<Ts...>{}, lhs.which()
+                  , lhs.target(), rhs.target())));
+    }
+
+    //! template <class ...Ts>
+    //! bool operator>(variant_ref<Ts...> lhs, variant_ref<Ts...> rhs);
+    //! template <class ...Ts>
+    //! bool operator<=(variant_ref<Ts...> lhs, variant_ref<Ts...> rhs);
+    //! template <class ...Ts>
+    //! bool operator>=(variant_ref<Ts...> lhs, variant_ref<Ts...> rhs);
+    //!
+    //! \returns `rhs < lhs`, `!(rhs < lhs)` and `!(lhs < rhs)`,
+    //!  respectively.
+    template <typename ...Ts>
+    bool operator>(variant_ref<Ts...> lhs, variant_ref<Ts...> rhs)
+    {
+        return rhs < lhs;
+    }
+
+    template <typename ...Ts>
+    bool operator<=(variant_ref<Ts...> lhs, variant_ref<Ts...> rhs)
+    {
+        return !(rhs < lhs);
+    }
+
+    template <typename ...Ts>
+    bool operator>=(variant_ref<Ts...> lhs, variant_ref<Ts...> rhs)
+    {
+        return !(lhs < rhs);
+    }
+}}
+
+namespace std
+{
+    //! template <class ...Ts>
+    //! struct hash<::eggs::variants::variant_ref<Ts...>>;
+    //!
+    //! For an object `r` of type `variant_ref<Ts...>` that refers to an
+    //!  object as the alternative `T`, `std::hash<variant_ref<Ts...>>()(r)`
+    //!  evaluates to the same value as `std::hash<std::remove_const_t<T>>()(
+    //!  *r.target<T>())`; otherwise, to an unspecified value.
+    template <typename ...Ts>
+    struct hash< ::eggs::variants::variant_ref<Ts...>>
+    {
+        std::size_t operator()(::eggs::variants::variant_ref<Ts...> r) const
+        {
+            return bool(r)
+              ? ::eggs::variants::detail::hash{}(
+                    ::eggs::variants::detail::pack<Ts...>{}, r.which()
+                  , static_cast<void const*>(r.target()))
+              : 0;
+        }
+    };
+}
+
+#include "detail/config/suffix.hpp"
+
+#endif /*EGGS_VARIANT_VARIANT_REF_HPP*/
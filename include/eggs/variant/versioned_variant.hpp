@@ -0,0 +1,257 @@
+//! \file eggs/variant/versioned_variant.hpp
+// Eggs.Variant
+//
+// Copyright Agustin K-ballo Berge, Fusion Fenix 2014-2018
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef EGGS_VARIANT_VERSIONED_VARIANT_HPP
+#define EGGS_VARIANT_VERSIONED_VARIANT_HPP
+
+#include "detail/utility.hpp"
+
+#include "in_place.hpp"
+#include "variant.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#include "detail/config/prefix.hpp"
+
+namespace eggs { namespace variants
+{
+    ///////////////////////////////////////////////////////////////////////////
+    //! template <class ...Ts>
+    //! class versioned_variant;
+    //!
+    //! A `versioned_variant` holds a `variant<Ts...>` that is read often and
+    //! replaced rarely, for alternatives of any type. Each value is an
+    //! immutable snapshot on the heap, published through an atomic pointer.
+    //! Readers access the current snapshot in place in a bounded number of
+    //! steps, without locks or retries. Writers publish a new snapshot, then
+    //! wait for the readers that may still access the previous one before
+    //! reclaiming it.
+    //!
+    //! Readers are tracked by a pair of counters, selected by the parity of
+    //! a grace period. After publishing, a writer flips the parity twice,
+    //! each time waiting for the counter that new readers no longer use to
+    //! drop to zero, so the wait is bounded by the readers already in
+    //! progress. Writers are serialized among themselves by a mutex.
+    //!
+    //! \remarks A writer waits for readers in progress, so a thread shall not
+    //!  write while it is reading.
+    template <typename ...Ts>
+    class versioned_variant
+    {
+        using _variant = variant<Ts...>;
+
+        struct _snapshot
+        {
+            std::uint64_t version;
+            _variant const value;
+        };
+
+        class _read_guard
+        {
+        public:
+            explicit _read_guard(versioned_variant const& vv) noexcept
+              : _readers(vv._readers[vv._parity.load() & 1u])
+            {
+                _readers.fetch_add(1);
+            }
+
+            _read_guard(_read_guard const&) = delete;
+            _read_guard& operator=(_read_guard const&) = delete;
+
+            ~_read_guard()
+            {
+                _readers.fetch_sub(1, std::memory_order_release);
+            }
+
+        private:
+            std::atomic<std::size_t>& _readers;
+        };
+
+    public:
+        using value_type = _variant;
+
+    public:
+        //! versioned_variant();
+        //!
+        //! \effects Publishes a first snapshot holding a `variant<Ts...>`
+        //!  that has no active member.
+        //!
+        //! \postconditions `version() == 0`.
+        versioned_variant()
+          : _current(new _snapshot{0, _variant()})
+          , _parity(0)
+        {
+            _readers[0] = 0;
+            _readers[1] = 0;
+        }
+
+        //! explicit versioned_variant(variant<Ts...> v);
+        //!
+        //! \effects Publishes a first snapshot holding `std::move(v)`.
+        //!
+        //! \postconditions `version() == 0`.
+        explicit versioned_variant(_variant v)
+          : _current(new _snapshot{0, detail::move(v)})
+          , _parity(0)
+        {
+            _readers[0] = 0;
+            _readers[1] = 0;
+        }
+
+        versioned_variant(versioned_variant const&) = delete;
+        versioned_variant& operator=(versioned_variant const&) = delete;
+
+        //! ~versioned_variant();
+        //!
+        //! \requires No thread shall be reading or writing `*this`.
+        //!
+        //! \effects Destroys the current snapshot.
+        ~versioned_variant()
+        {
+            delete _current.load(std::memory_order_relaxed);
+        }
+
+        //! template <class R, class F>
+        //! R apply(F&& f) const;
+        //!
+        //! \effects Equivalent to `return variants::apply<R>(std::forward<F>(
+        //!  f), s);`, where `s` is a `variant<Ts...> const` lvalue that
+        //!  designates the value of the current snapshot, which remains valid
+        //!  until `f` returns even if a writer publishes another.
+        template <typename R, typename F>
+        R apply(F&& f) const
+        {
+            _read_guard guard(*this);
+            return variants::apply<R>(
+                detail::forward<F>(f), _current.load()->value);
+        }
+
+        //! template <class F>
+        //! R apply(F&& f) const;
+        //!
+        //! \effects Equivalent to `return variants::apply(std::forward<F>(
+        //!  f), s);`, where `s` is as above.
+        template <
+            int DeductionGuard = 0, typename F
+          , typename R = decltype(variants::apply(
+                std::declval<F>(), std::declval<_variant const&>()))
+        >
+        R apply(F&& f) const
+        {
+            _read_guard guard(*this);
+            return variants::apply(
+                detail::forward<F>(f), _current.load()->value);
+        }
+
+        //! variant<Ts...> load() const;
+        //!
+        //! \returns A copy of the value of the current snapshot.
+        _variant load() const
+        {
+            _read_guard guard(*this);
+            return _current.load()->value;
+        }
+
+        //! std::uint64_t version() const noexcept;
+        //!
+        //! \returns The number of snapshots published after the first one,
+        //!  as of the current snapshot.
+        std::uint64_t version() const noexcept
+        {
+            _read_guard guard(*this);
+            return _current.load()->version;
+        }
+
+        //! void store(variant<Ts...> v);
+        //!
+        //! \effects Publishes a snapshot holding `std::move(v)`, then
+        //!  reclaims the previous snapshot once no reader may access it.
+        void store(_variant v)
+        {
+            std::unique_lock<std::mutex> lock(_writer);
+            _publish(lock, detail::move(v));
+        }
+
+        //! template <std::size_t I, class ...Args>
+        //! void emplace(Args&&... args);
+        //!
+        //! \effects Equivalent to `store(variant<Ts...>(in_place<I>,
+        //!  std::forward<Args>(args)...))`.
+        template <std::size_t I, typename ...Args>
+        void emplace(Args&&... args)
+        {
+            store(_variant(in_place<I>, detail::forward<Args>(args)...));
+        }
+
+        //! template <class T, class ...Args>
+        //! void emplace(Args&&... args);
+        //!
+        //! \effects Equivalent to `store(variant<Ts...>(in_place<T>,
+        //!  std::forward<Args>(args)...))`.
+        template <typename T, typename ...Args>
+        void emplace(Args&&... args)
+        {
+            store(_variant(in_place<T>, detail::forward<Args>(args)...));
+        }
+
+        //! template <class F>
+        //! void update(F&& f);
+        //!
+        //! \requires `std::forward<F>(f)(s)`, where `s` is a `variant<Ts...>
+        //!  const` lvalue, shall be a valid expression convertible to
+        //!  `variant<Ts...>`.
+        //!
+        //! \effects Publishes a snapshot holding `std::forward<F>(f)(s)`,
+        //!  where `s` designates the value of the current snapshot, with no
+        //!  other writer intervening.
+        template <typename F>
+        void update(F&& f)
+        {
+            std::unique_lock<std::mutex> lock(_writer);
+            _publish(lock, _variant(detail::forward<F>(f)(
+                _current.load(std::memory_order_relaxed)->value)));
+        }
+
+    private:
+        void _publish(std::unique_lock<std::mutex>& lock, _variant&& v)
+        {
+            _snapshot* const previous = _current.load(std::memory_order_relaxed);
+            _current.store(
+                new _snapshot{previous->version + 1, detail::move(v)});
+
+            // a reader that may hold the previous snapshot registered under
+            // either parity, as it may have read a stale one; flip twice,
+            // waiting each time for the counter new readers no longer use
+            for (int i = 0; i < 2; ++i)
+            {
+                unsigned const parity = _parity.fetch_add(1) & 1u;
+                while (_readers[parity].load() != 0)
+                    std::this_thread::yield();
+            }
+            lock.unlock();
+
+            delete previous;
+        }
+
+    private:
+        std::atomic<_snapshot*> _current;
+        std::atomic<unsigned> _parity;
+        mutable std::atomic<std::size_t> _readers[2];
+        std::mutex _writer;
+    };
+}}
+
+#include "detail/config/suffix.hpp"
+
+#endif /*EGGS_VARIANT_VERSIONED_VARIANT_HPP*/
@@ -0,0 +1,226 @@
+//! \file eggs/variant/work_stealing_pool.hpp
+// Eggs.Variant
+//
+// Copyright Agustin K-ballo Berge, Fusion Fenix 2014-2018
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef EGGS_VARIANT_WORK_STEALING_POOL_HPP
+#define EGGS_VARIANT_WORK_STEALING_POOL_HPP
+
+#include "detail/utility.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "detail/config/prefix.hpp"
+
+namespace eggs { namespace variants
+{
+    ///////////////////////////////////////////////////////////////////////////
+    //! template <class Task>
+    //! class work_stealing_pool;
+    //!
+    //! A `work_stealing_pool` runs tasks of type `Task` on a fixed set of
+    //! worker threads. Each worker owns a deque that holds tasks by value;
+    //! a worker takes the task it submitted most recently from the back of
+    //! its own deque, and when that is empty it steals the oldest task from
+    //! the front of the deque of another worker. Tasks submitted from
+    //! outside the pool are distributed among the workers in turn.
+    //!
+    //! `Task` shall be default constructible, move constructible and move
+    //! assignable, and callable with no arguments; `task_variant<Fs...>` is
+    //! such a type that never allocates.
+    //!
+    //! \remarks If a task exits via an exception, `std::terminate` is called.
+    template <typename Task>
+    class work_stealing_pool
+    {
+        struct _worker
+        {
+            std::mutex mutex;
+            std::deque<Task> tasks;
+        };
+
+        struct _this_thread_worker
+        {
+            work_stealing_pool const* pool;
+            std::size_t index;
+        };
+
+        static _this_thread_worker& _this_thread() noexcept
+        {
+            static thread_local _this_thread_worker current = {nullptr, 0};
+            return current;
+        }
+
+    public:
+        using task_type = Task;
+
+    public:
+        //! explicit work_stealing_pool(std::size_t threads = std::thread::hardware_concurrency());
+        //!
+        //! \effects Starts `threads` worker threads, or one if `threads` is
+        //!  `0`.
+        explicit work_stealing_pool(
+            std::size_t threads = std::thread::hardware_concurrency())
+          : _queued(0), _unfinished(0), _next(0), _stop(false)
+        {
+            std::size_t const size = threads > 0 ? threads : 1;
+            _workers.reserve(size);
+            for (std::size_t i = 0; i < size; ++i)
+                _workers.emplace_back(new _worker());
+
+            _threads.reserve(size);
+            for (std::size_t i = 0; i < size; ++i)
+                _threads.emplace_back(&work_stealing_pool::_run, this, i);
+        }
+
+        work_stealing_pool(work_stealing_pool const&) = delete;
+        work_stealing_pool& operator=(work_stealing_pool const&) = delete;
+
+        //! ~work_stealing_pool();
+        //!
+        //! \requires No thread shall be submitting tasks to `*this`.
+        //!
+        //! \effects Runs the tasks that are still queued, then stops and
+        //!  joins the worker threads.
+        ~work_stealing_pool()
+        {
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _stop = true;
+            }
+            _wake.notify_all();
+
+            for (std::thread& thread : _threads)
+                thread.join();
+        }
+
+        //! std::size_t size() const noexcept;
+        //!
+        //! \returns The number of worker threads.
+        std::size_t size() const noexcept
+        {
+            return _workers.size();
+        }
+
+        //! void submit(Task task);
+        //!
+        //! \effects Queues `std::move(task)` to be run by a worker thread. If
+        //!  called from a worker thread of `*this`, the task is queued on the
+        //!  deque of that worker.
+        void submit(Task task)
+        {
+            _this_thread_worker const& current = _this_thread();
+            std::size_t const index = current.pool == this
+              ? current.index
+              : _next.fetch_add(1, std::memory_order_relaxed) % _workers.size();
+
+            _unfinished.fetch_add(1);
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _queued.fetch_add(1);
+            }
+            {
+                _worker& worker = *_workers[index];
+                std::lock_guard<std::mutex> lock(worker.mutex);
+                worker.tasks.push_back(detail::move(task));
+            }
+            _wake.notify_one();
+        }
+
+        //! void wait();
+        //!
+        //! \requires Shall not be called from a worker thread of `*this`.
+        //!
+        //! \effects Blocks until every task submitted to `*this` has run,
+        //!  including those submitted by the tasks themselves.
+        void wait()
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _done.wait(lock, [this] { return _unfinished.load() == 0; });
+        }
+
+    private:
+        bool _pop(std::size_t index, Task& task)
+        {
+            _worker& worker = *_workers[index];
+            std::lock_guard<std::mutex> lock(worker.mutex);
+            if (worker.tasks.empty())
+                return false;
+
+            task = detail::move(worker.tasks.back());
+            worker.tasks.pop_back();
+            return true;
+        }
+
+        bool _steal(std::size_t index, Task& task)
+        {
+            for (std::size_t i = 1; i < _workers.size(); ++i)
+            {
+                _worker& victim = *_workers[(index + i) % _workers.size()];
+                std::lock_guard<std::mutex> lock(victim.mutex);
+                if (!victim.tasks.empty())
+                {
+                    task = detail::move(victim.tasks.front());
+                    victim.tasks.pop_front();
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        void _run(std::size_t index)
+        {
+            _this_thread_worker& current = _this_thread();
+            current.pool = this;
+            current.index = index;
+
+            Task task;
+            for (;;)
+            {
+                if (_pop(index, task) || _steal(index, task))
+                {
+                    _queued.fetch_sub(1);
+                    task();
+                    task = Task();
+
+                    if (_unfinished.fetch_sub(1) == 1)
+                    {
+                        std::lock_guard<std::mutex> lock(_mutex);
+                        _done.notify_all();
+                    }
+                    continue;
+                }
+
+                std::unique_lock<std::mutex> lock(_mutex);
+                _wake.wait(lock, [this] { return _queued.load() != 0 || _stop; });
+                if (_stop && _queued.load() == 0)
+                    return;
+            }
+        }
+
+    private:
+        std::vector<std::unique_ptr<_worker>> _workers;
+        std::vector<std::thread> _threads;
+        std::atomic<std::size_t> _queued;
+        std::atomic<std::size_t> _unfinished;
+        std::atomic<std::size_t> _next;
+        std::mutex _mutex;
+        std::condition_variable _wake;
+        std::condition_variable _done;
+        bool _stop;
+    };
+}}
+
+#include "detail/config/suffix.hpp"
+
+#endif /*EGGS_VARIANT_WORK_STEALING_POOL_HPP*/
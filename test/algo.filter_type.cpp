@@ -0,0 +1,115 @@
+// Eggs.Variant
+//
+// Copyright Agustin K-ballo Berge, Fusion Fenix 2014-2018
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <eggs/variant.hpp>
+#include <eggs/variant/algorithm.hpp>
+#include <eggs/variant/boxed.hpp>
+#include <list>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <eggs/variant/detail/config/prefix.hpp>
+
+#include "catch.hpp"
+
+TEST_CASE("filter_type<T>(Range&)", "[variant.algo]")
+{
+    using variant = eggs::variant<int, std::string>;
+
+    // random access
+    {
+        std::vector<variant> vs;
+        for (int i = 0; i < 200; ++i)
+        {
+            if (i % 3 == 0)
+                vs.push_back(i);
+            else if (i % 3 == 1)
+                vs.push_back(std::string("x"));
+            else
+                vs.push_back(variant());
+        }
+
+        auto view = eggs::variants::filter_type<int>(vs);
+
+        using reference = decltype(*view.begin());
+        CHECK(std::is_same<reference, int&>::value);
+
+        int count = 0;
+        int expected = 0;
+        for (int& i : view)
+        {
+            CHECK(i == expected);
+            expected += 3;
+            ++count;
+        }
+        CHECK(count == 67);
+
+        for (int& i : view)
+            i = -i;
+        CHECK(*vs[3].target<int>() == -3);
+    }
+
+    // const
+    {
+        std::vector<variant> const vs = {variant(1), variant(std::string("a"))};
+
+        auto view = eggs::variants::filter_type<std::string>(vs);
+
+        using reference = decltype(*view.begin());
+        CHECK(std::is_same<reference, std::string const&>::value);
+
+        auto it = view.begin();
+        REQUIRE(it != view.end());
+        CHECK(*it == "a");
+        CHECK(it.base() == vs.begin() + 1);
+        CHECK(++it == view.end());
+    }
+
+    // forward
+    {
+        std::list<variant> vs;
+        vs.push_back(std::string("a"));
+        vs.push_back(42);
+        vs.push_back(std::string("b"));
+
+        auto view = eggs::variants::filter_type<std::string>(vs);
+
+        std::string concat;
+        for (std::string const& s : view)
+            concat += s;
+        CHECK(concat == "ab");
+    }
+
+    // boxed alternative, found as the type it holds
+    {
+        using boxed_variant = eggs::variant<int, eggs::variants::boxed<std::string>>;
+        std::vector<boxed_variant> vs;
+        vs.push_back(std::string("a"));
+        vs.push_back(42);
+        vs.push_back(std::string("b"));
+
+        auto view = eggs::variants::filter_type<std::string>(vs);
+
+        using reference = decltype(*view.begin());
+        CHECK(std::is_same<reference, std::string&>::value);
+
+        std::string concat;
+        for (std::string const& s : view)
+            concat += s;
+        CHECK(concat == "ab");
+    }
+
+    // no match
+    {
+        std::vector<variant> vs(100, variant(std::string("a")));
+
+        auto view = eggs::variants::filter_type<int>(vs);
+
+        CHECK(view.begin() == view.end());
+    }
+}
@@ -0,0 +1,139 @@
+// Eggs.Variant
+//
+// Copyright Agustin K-ballo Berge, Fusion Fenix 2014-2018
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <eggs/variant.hpp>
+#include <eggs/variant/boxed.hpp>
+#include <eggs/variant/parallel_algorithm.hpp>
+#include <atomic>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include <eggs/variant/detail/config/prefix.hpp>
+
+#include "catch.hpp"
+
+namespace
+{
+    struct Count
+    {
+        std::atomic<std::size_t>* ints;
+        std::atomic<std::size_t>* strings;
+
+        void operator()(int& i) const { ++i; ints->fetch_add(1); }
+        void operator()(std::string& s) const { s += '!'; strings->fetch_add(1); }
+    };
+
+    struct Observe
+    {
+        std::atomic<long>* sum;
+
+        void operator()(int const& i) const { sum->fetch_add(i); }
+        void operator()(std::string const&) const {}
+    };
+}
+
+TEST_CASE("parallel_apply_each(F&&, Range&, std::size_t)", "[algorithm]")
+{
+    std::vector<eggs::variant<int, std::string>> v;
+    for (int i = 0; i < 100000; ++i)
+    {
+        if (i % 7 == 0)
+            v.emplace_back(std::string("s"));
+        else if (i % 11 == 0)
+            v.emplace_back();
+        else
+            v.emplace_back(i);
+    }
+
+    for (std::size_t threads : {1u, 4u})
+    {
+        std::vector<eggs::variant<int, std::string>> w = v;
+        std::atomic<std::size_t> ints(0), strings(0);
+        eggs::variants::parallel_apply_each(Count{&ints, &strings}, w, threads);
+
+        CHECK(ints.load() + strings.load() + 7792 == w.size());
+        bool all_visited = true;
+        for (std::size_t i = 0; i < w.size(); ++i)
+        {
+            if (int const* p = v[i].target<int>())
+                all_visited = all_visited && *w[i].target<int>() == *p + 1;
+            else if (v[i].which() == 1)
+                all_visited = all_visited && *w[i].target<std::string>() == "s!";
+            else
+                all_visited = all_visited && w[i].which() == eggs::variant<int, std::string>::npos;
+        }
+        CHECK(all_visited);
+    }
+
+    // const elements
+    {
+        std::vector<eggs::variant<int, std::string>> const& cv = v;
+        std::atomic<long> sum(0);
+        eggs::variants::parallel_apply_each(Observe{&sum}, cv, 3);
+
+        long expected = 0;
+        for (auto const& e : v)
+            if (int const* p = e.target<int>())
+                expected += *p;
+        CHECK(sum.load() == expected);
+    }
+
+    // empty range
+    {
+        std::vector<eggs::variant<int, std::string>> e;
+        std::atomic<std::size_t> ints(0), strings(0);
+        eggs::variants::parallel_apply_each(Count{&ints, &strings}, e, 4);
+        CHECK(ints.load() == 0u);
+    }
+}
+
+TEST_CASE("parallel_apply_each(F&&, Range&, parallel_pool&)", "[algorithm]")
+{
+    std::vector<eggs::variant<int, std::string>> v(50000, 1);
+    eggs::variants::parallel_pool pool(4);
+
+    // the pool is reused across calls
+    for (int round = 0; round < 3; ++round)
+    {
+        std::atomic<std::size_t> ints(0), strings(0);
+        eggs::variants::parallel_apply_each(Count{&ints, &strings}, v, pool);
+        CHECK(ints.load() == v.size());
+    }
+    CHECK(pool.size() == 4u);
+
+    bool all_visited = true;
+    for (auto const& e : v)
+        all_visited = all_visited && *e.target<int>() == 4;
+    CHECK(all_visited);
+}
+
+TEST_CASE("parallel_apply_each(F&&, Range&, std::size_t) with a boxed<T> alternative", "[algorithm]")
+{
+    using Variant = eggs::variant<int, eggs::variants::boxed<std::string>>;
+
+    // boxed members are passed as the type they hold
+    std::vector<Variant> v;
+    for (int i = 0; i < 40000; ++i)
+    {
+        if (i % 2 == 0)
+            v.emplace_back(std::string("s"));
+        else
+            v.emplace_back(i);
+    }
+
+    std::atomic<std::size_t> ints(0), strings(0);
+    eggs::variants::parallel_apply_each(Count{&ints, &strings}, v, 4);
+    CHECK(ints.load() == 20000u);
+    CHECK(strings.load() == 20000u);
+    CHECK(eggs::variants::get<std::string>(v[0]) == "s!");
+
+    std::vector<Variant> const& cv = v;
+    std::atomic<long> sum(0);
+    eggs::variants::parallel_apply_each(Observe{&sum}, cv, 2);
+    CHECK(sum.load() == 20000L * 20000L + 20000L);
+}
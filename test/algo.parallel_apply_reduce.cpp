@@ -0,0 +1,86 @@
+// Eggs.Variant
+//
+// Copyright Agustin K-ballo Berge, Fusion Fenix 2014-2018
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <eggs/variant.hpp>
+#include <eggs/variant/parallel_algorithm.hpp>
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+#include <eggs/variant/detail/config/prefix.hpp>
+
+#include "catch.hpp"
+
+namespace
+{
+    struct Value
+    {
+        double operator()(int i) const { return 1.0 / (i + 1); }
+        double operator()(double d) const { return d; }
+    };
+}
+
+TEST_CASE("parallel_apply_reduce(F&&, Range&, R, Op, std::size_t)", "[algorithm]")
+{
+    std::vector<eggs::variant<int, double>> v;
+    for (int i = 0; i < 100000; ++i)
+    {
+        if (i % 3 == 0)
+            v.emplace_back(0.1 * i);
+        else if (i % 5 == 0)
+            v.emplace_back();
+        else
+            v.emplace_back(i);
+    }
+
+    double const sequential = eggs::variants::parallel_apply_reduce(
+        Value{}, v, 0.0, std::plus<double>{}, 1);
+
+    double expected = 0.0;
+    for (auto const& e : v)
+    {
+        if (e.which() != eggs::variant<int, double>::npos)
+            expected += eggs::variants::apply<double>(Value{}, e);
+    }
+    CHECK(sequential == Approx(expected));
+
+    // the grouping does not depend on the number of threads
+    for (std::size_t threads : {2u, 3u, 8u})
+    {
+        double const parallel = eggs::variants::parallel_apply_reduce(
+            Value{}, v, 0.0, std::plus<double>{}, threads);
+        CHECK(parallel == sequential);
+    }
+
+    std::vector<eggs::variant<int, double>> const e;
+    CHECK(eggs::variants::parallel_apply_reduce(
+        Value{}, e, 42.0, std::plus<double>{}, 4) == 42.0);
+}
+
+TEST_CASE("parallel_apply_reduce(F&&, Range&, R, Op, parallel_pool&)", "[algorithm]")
+{
+    std::vector<eggs::variant<int, double>> v;
+    for (int i = 0; i < 100000; ++i)
+    {
+        if (i % 3 == 0)
+            v.emplace_back(0.1 * i);
+        else
+            v.emplace_back(i);
+    }
+
+    double const sequential = eggs::variants::parallel_apply_reduce(
+        Value{}, v, 0.0, std::plus<double>{}, 1);
+
+    // the pool is reused across calls
+    eggs::variants::parallel_pool pool(3);
+    for (int round = 0; round < 3; ++round)
+    {
+        double const parallel = eggs::variants::parallel_apply_reduce(
+            Value{}, v, 0.0, std::plus<double>{}, pool);
+        CHECK(parallel == sequential);
+    }
+}
@@ -0,0 +1,90 @@
+// Eggs.Variant
+//
+// Copyright Agustin K-ballo Berge, Fusion Fenix 2014-2018
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <eggs/variant.hpp>
+#include <eggs/variant/algorithm.hpp>
+#include <list>
+#include <string>
+#include <vector>
+
+#include <eggs/variant/detail/config/prefix.hpp>
+
+#include "catch.hpp"
+
+TEST_CASE("partition_by_which(ForwardIt, ForwardIt)", "[variant.algo]")
+{
+    using variant = eggs::variant<int, std::string, double>;
+
+    // random access
+    {
+        std::vector<variant> vs;
+        vs.push_back(42);
+        vs.push_back(std::string("a"));
+        vs.push_back(variant());
+        vs.push_back(4.2);
+        vs.push_back(43);
+        vs.push_back(std::string("b"));
+        vs.push_back(4.3);
+        vs.push_back(44);
+
+        eggs::variants::which_partition<
+            std::vector<variant>::iterator, 3
+        > parts = eggs::variants::partition_by_which(vs.begin(), vs.end());
+
+        CHECK(parts.begin() == vs.begin());
+        CHECK(parts.end() == vs.end());
+
+        CHECK(parts[eggs::variant_npos].size() == 1u);
+        CHECK(parts[eggs::variant_npos].begin() == vs.begin());
+        CHECK(parts[0].size() == 3u);
+        CHECK(parts[1].size() == 2u);
+        CHECK(parts[2].size() == 2u);
+        CHECK(parts[2].end() == vs.end());
+
+        for (std::size_t i = 0; i < 3; ++i)
+        {
+            for (variant const& v : parts[i])
+                CHECK(v.which() == i);
+        }
+
+        int sum = 0;
+        for (variant const& v : parts[0])
+            sum += *v.target<int>();
+        CHECK(sum == 42 + 43 + 44);
+    }
+
+    // forward
+    {
+        std::list<variant> vs;
+        vs.push_back(std::string("a"));
+        vs.push_back(42);
+        vs.push_back(std::string("b"));
+        vs.push_back(43);
+
+        auto parts = eggs::variants::partition_by_which(vs.begin(), vs.end());
+
+        CHECK(parts[eggs::variant_npos].empty());
+        CHECK(parts[0].size() == 2u);
+        CHECK(parts[1].size() == 2u);
+        CHECK(parts[2].empty());
+
+        for (variant const& v : parts[1])
+            CHECK(v.which() == 1u);
+    }
+
+    // empty range
+    {
+        std::vector<variant> vs;
+
+        auto parts = eggs::variants::partition_by_which(vs.begin(), vs.end());
+
+        CHECK(parts[eggs::variant_npos].empty());
+        CHECK(parts[0].empty());
+        CHECK(parts[1].empty());
+        CHECK(parts[2].empty());
+    }
+}
@@ -0,0 +1,99 @@
+// Eggs.Variant
+//
+// Copyright Agustin K-ballo Berge, Fusion Fenix 2014-2018
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <eggs/variant.hpp>
+#include <eggs/variant/algorithm.hpp>
+#include <eggs/variant/boxed.hpp>
+#include <eggs/variant/parallel_algorithm.hpp>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <eggs/variant/detail/config/prefix.hpp>
+
+#include "catch.hpp"
+
+namespace
+{
+    struct Weight
+    {
+        long operator()(int i) const { return i; }
+        long operator()(std::string const& s) const { return static_cast<long>(s.size()) * 1000; }
+    };
+}
+
+TEST_CASE("transform_reduce_by_type(which_partition<Iterator, N> const&, F&&, R, Op, std::size_t)", "[algorithm]")
+{
+    std::vector<eggs::variant<int, std::string>> v;
+    long expected = 0;
+    for (int i = 0; i < 60000; ++i)
+    {
+        if (i % 4 == 0)
+        {
+            v.emplace_back(std::string(std::size_t(i % 5), 'x'));
+            expected += (i % 5) * 1000;
+        } else if (i % 13 == 0) {
+            v.emplace_back();
+        } else {
+            v.emplace_back(i);
+            expected += i;
+        }
+    }
+
+    auto const partition = eggs::variants::partition_by_which(v.begin(), v.end());
+
+    for (std::size_t threads : {1u, 2u, 5u})
+    {
+        long const result = eggs::variants::transform_reduce_by_type(
+            partition, Weight{}, 7L, std::plus<long>{}, threads);
+        CHECK(result == expected + 7);
+    }
+
+    // the pool is reused across calls
+    eggs::variants::parallel_pool pool(3);
+    for (int round = 0; round < 2; ++round)
+    {
+        CHECK(eggs::variants::transform_reduce_by_type(
+            partition, Weight{}, 7L, std::plus<long>{}, pool) == expected + 7);
+    }
+
+    // no element has an active member
+    {
+        std::vector<eggs::variant<int, std::string>> e(10);
+        auto const p = eggs::variants::partition_by_which(e.begin(), e.end());
+        CHECK(eggs::variants::transform_reduce_by_type(
+            p, Weight{}, 7L, std::plus<long>{}, 4) == 7);
+    }
+}
+
+TEST_CASE("transform_reduce_by_type(which_partition<Iterator, N> const&, F&&, R, Op, std::size_t) with a boxed<T> alternative", "[algorithm]")
+{
+    using Variant = eggs::variant<int, eggs::variants::boxed<std::string>>;
+
+    // boxed members are passed as the type they hold
+    std::vector<Variant> v;
+    long expected = 0;
+    for (int i = 0; i < 40000; ++i)
+    {
+        if (i % 3 == 0)
+        {
+            v.emplace_back(std::string(std::size_t(i % 4), 'x'));
+            expected += (i % 4) * 1000;
+        } else {
+            v.emplace_back(i);
+            expected += i;
+        }
+    }
+
+    auto const partition = eggs::variants::partition_by_which(v.begin(), v.end());
+    for (std::size_t threads : {1u, 3u})
+    {
+        CHECK(eggs::variants::transform_reduce_by_type(
+            partition, Weight{}, 0L, std::plus<long>{}, threads) == expected);
+    }
+}
@@ -0,0 +1,113 @@
+// Eggs.Variant
+//
+// Copyright Agustin K-ballo Berge, Fusion Fenix 2014-2018
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <eggs/variant.hpp>
+#include <eggs/variant/algorithm.hpp>
+#include <eggs/variant/boxed.hpp>
+#include <array>
+#include <cstddef>
+#include <list>
+#include <string>
+#include <vector>
+
+#include <eggs/variant/detail/config/prefix.hpp>
+
+#include "catch.hpp"
+
+TEST_CASE("count_by_type<T>(Range const&)", "[variant.algo]")
+{
+    using variant = eggs::variant<int, std::string>;
+
+    std::vector<variant> vs;
+    for (int i = 0; i < 10; ++i)
+        vs.push_back(i);
+    vs.push_back(std::string("a"));
+    vs.push_back(variant());
+
+    CHECK(eggs::variants::count_by_type<int>(vs) == 10u);
+    CHECK(eggs::variants::count_by_type<std::string>(vs) == 1u);
+
+    std::vector<variant> const empty;
+    CHECK(eggs::variants::count_by_type<int>(empty) == 0u);
+
+    // a boxed alternative is counted as the type it holds
+    using boxed_variant = eggs::variant<int, eggs::variants::boxed<std::string>>;
+    std::vector<boxed_variant> bs(3, boxed_variant(std::string("a")));
+    bs.push_back(1);
+    CHECK(eggs::variants::count_by_type<std::string>(bs) == 3u);
+    CHECK(eggs::variants::count_by_type<int>(bs) == 1u);
+}
+
+TEST_CASE("which_histogram(Range const&)", "[variant.algo]")
+{
+    using variant = eggs::variant<int, std::string, double>;
+
+    // random access
+    {
+        std::vector<variant> vs;
+        for (int i = 0; i < 11; ++i)
+            vs.push_back(i);
+        for (int i = 0; i < 5; ++i)
+            vs.push_back(4.2);
+        vs.push_back(variant());
+        vs.push_back(std::string("a"));
+
+        std::array<std::size_t, 3> counts =
+            eggs::variants::which_histogram(vs);
+
+        CHECK(counts[0] == 11u);
+        CHECK(counts[1] == 1u);
+        CHECK(counts[2] == 5u);
+    }
+
+    // forward
+    {
+        std::list<variant> vs;
+        vs.push_back(std::string("a"));
+        vs.push_back(42);
+        vs.push_back(std::string("b"));
+
+        std::array<std::size_t, 3> counts =
+            eggs::variants::which_histogram(vs);
+
+        CHECK(counts[0] == 1u);
+        CHECK(counts[1] == 2u);
+        CHECK(counts[2] == 0u);
+    }
+}
+
+TEST_CASE("which_histogram<N>(T const*, T const*)", "[variant.algo]")
+{
+    // small
+    {
+        unsigned char const tags[] = {0, 1, 1, 2, 2, 2, 255};
+
+        std::array<std::size_t, 3> counts =
+            eggs::variants::which_histogram<3>(tags, tags + 7);
+
+        CHECK(counts[0] == 1u);
+        CHECK(counts[1] == 2u);
+        CHECK(counts[2] == 3u);
+    }
+
+    // large
+    {
+        std::vector<int> tags;
+        for (int i = 0; i < 40; ++i)
+            tags.push_back(i);
+        tags.push_back(-1);
+        tags.push_back(39);
+
+        std::array<std::size_t, 40> counts =
+            eggs::variants::which_histogram<40>(
+                tags.data(), tags.data() + tags.size());
+
+        CHECK(counts[0] == 1u);
+        CHECK(counts[20] == 1u);
+        CHECK(counts[39] == 2u);
+    }
+}
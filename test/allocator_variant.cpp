@@ -0,0 +1,180 @@
+// Eggs.Variant
+//
+// Copyright Agustin K-ballo Berge, Fusion Fenix 2014-2018
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <eggs/variant.hpp>
+#include <eggs/variant/allocator_variant.hpp>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if __cplusplus >= 201703L && defined(__has_include)
+#  if __has_include(<memory_resource>)
+#    include <memory_resource>
+#    define TEST_HAS_MEMORY_RESOURCE 1
+#  endif
+#endif
+
+#include <eggs/variant/detail/config/prefix.hpp>
+
+#include "catch.hpp"
+
+struct Arena
+{
+    std::size_t allocations;
+};
+
+template <typename T>
+struct ArenaAllocator
+{
+    using value_type = T;
+
+    explicit ArenaAllocator(Arena* arena = nullptr) noexcept : arena(arena) {}
+
+    template <typename U>
+    ArenaAllocator(ArenaAllocator<U> const& other) noexcept : arena(other.arena) {}
+
+    T* allocate(std::size_t n)
+    {
+        if (arena) ++arena->allocations;
+        return std::allocator<T>().allocate(n);
+    }
+
+    void deallocate(T* ptr, std::size_t n) noexcept
+    {
+        std::allocator<T>().deallocate(ptr, n);
+    }
+
+    Arena* arena;
+};
+
+template <typename T, typename U>
+bool operator==(ArenaAllocator<T> const& lhs, ArenaAllocator<U> const& rhs) noexcept
+{
+    return lhs.arena == rhs.arena;
+}
+
+template <typename T, typename U>
+bool operator!=(ArenaAllocator<T> const& lhs, ArenaAllocator<U> const& rhs) noexcept
+{
+    return lhs.arena != rhs.arena;
+}
+
+using String = std::basic_string<char, std::char_traits<char>, ArenaAllocator<char>>;
+using Vector = std::vector<int, ArenaAllocator<int>>;
+using Variant = eggs::variants::allocator_variant<ArenaAllocator<char>, int, String, Vector>;
+
+struct Size
+{
+    std::size_t operator()(int) const { return 0; }
+    std::size_t operator()(String const& s) const { return s.size(); }
+    std::size_t operator()(Vector const& v) const { return v.size(); }
+};
+
+static char const long_text[] = "a string too long for the small buffer";
+
+TEST_CASE("allocator_variant<Allocator, Ts...>::emplace<I>(Args&&...)", "[allocator_variant]")
+{
+    Arena arena = {0};
+    Variant v(std::allocator_arg, ArenaAllocator<char>(&arena));
+
+    CHECK_FALSE(bool(v));
+    CHECK(v.which() == Variant::npos);
+    CHECK(v.get_allocator().arena == &arena);
+
+    v.emplace<1>(long_text);
+    REQUIRE(v.which() == 1u);
+    CHECK(*v.target<String>() == long_text);
+    CHECK(v.target<String>()->get_allocator().arena == &arena);
+    CHECK(arena.allocations == 1u);
+
+    // the allocator is kept across alternative switches
+    v.emplace<Vector>(std::size_t(100), 7);
+    REQUIRE(v.which() == 2u);
+    CHECK(v.target<Vector>()->get_allocator().arena == &arena);
+    CHECK(arena.allocations == 2u);
+
+    v.emplace<int>(42);
+    CHECK(*v.target<int>() == 42);
+    CHECK(v.get_allocator().arena == &arena);
+
+    Variant w(std::allocator_arg, ArenaAllocator<char>(&arena), eggs::variants::in_place<1>, long_text);
+    CHECK(w.target<String>()->get_allocator().arena == &arena);
+    CHECK(arena.allocations == 3u);
+}
+
+TEST_CASE("allocator_variant<Allocator, Ts...>::allocator_variant(allocator_variant const&)", "[allocator_variant]")
+{
+    Arena arena = {0};
+    Arena other = {0};
+    Variant v(std::allocator_arg, ArenaAllocator<char>(&arena), eggs::variants::in_place<String>, long_text);
+
+    Variant c1(v);
+    CHECK(c1.get_allocator().arena == &arena);
+    CHECK(c1.target<String>()->get_allocator().arena == &arena);
+    CHECK(arena.allocations == 2u);
+
+    Variant c2(std::allocator_arg, ArenaAllocator<char>(&other), v);
+    CHECK(c2.get_allocator().arena == &other);
+    CHECK(c2.target<String>()->get_allocator().arena == &other);
+    CHECK(*c2.target<String>() == long_text);
+    CHECK(other.allocations == 1u);
+
+    Variant m(std::move(c1));
+    CHECK(m.get_allocator().arena == &arena);
+    CHECK(m.target<String>()->get_allocator().arena == &arena);
+
+    Variant e(std::allocator_arg, ArenaAllocator<char>(&other), Variant());
+    CHECK_FALSE(bool(e));
+}
+
+TEST_CASE("allocator_variant<Allocator, Ts...>::operator=(allocator_variant const&)", "[allocator_variant]")
+{
+    Arena arena = {0};
+    Arena other = {0};
+    Variant v(std::allocator_arg, ArenaAllocator<char>(&arena), eggs::variants::in_place<String>, long_text);
+    Variant w(std::allocator_arg, ArenaAllocator<char>(&other), eggs::variants::in_place<int>, 3);
+
+    // the allocator is not propagated on assignment
+    w = v;
+    CHECK(w.get_allocator().arena == &other);
+    REQUIRE(w.which() == 1u);
+    CHECK(w.target<String>()->get_allocator().arena == &other);
+    CHECK(other.allocations == 1u);
+
+    Variant x(std::allocator_arg, ArenaAllocator<char>(&other));
+    x = std::move(v);
+    CHECK(x.target<String>()->get_allocator().arena == &other);
+    CHECK(*x.target<String>() == long_text);
+
+    w = Variant();
+    CHECK_FALSE(bool(w));
+    CHECK(w.get_allocator().arena == &other);
+
+    CHECK(x.apply<std::size_t>(Size{}) == sizeof(long_text) - 1);
+}
+
+#if TEST_HAS_MEMORY_RESOURCE
+TEST_CASE("allocator_variant<std::pmr::polymorphic_allocator<>, Ts...>", "[allocator_variant]")
+{
+    using PmrVariant = eggs::variants::allocator_variant<
+        std::pmr::polymorphic_allocator<char>, std::pmr::string, std::pmr::vector<int>>;
+
+    char buffer[1024];
+    std::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer), std::pmr::null_memory_resource());
+
+    PmrVariant v(std::allocator_arg, &arena, eggs::variants::in_place<0>, long_text);
+    CHECK(v.target<std::pmr::string>()->get_allocator().resource() == &arena);
+
+    v.emplace<1>(std::size_t(10), 1);
+    CHECK(v.target<std::pmr::vector<int>>()->get_allocator().resource() == &arena);
+
+    PmrVariant w(std::allocator_arg, &arena, v);
+    CHECK(w.target<std::pmr::vector<int>>()->get_allocator().resource() == &arena);
+}
+#endif
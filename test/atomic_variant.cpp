@@ -0,0 +1,116 @@
+// Eggs.Variant
+//
+// Copyright Agustin K-ballo Berge, Fusion Fenix 2014-2018
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <eggs/variant.hpp>
+#include <eggs/variant/atomic_variant.hpp>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+#include <eggs/variant/detail/config/prefix.hpp>
+
+#include "catch.hpp"
+
+struct Idle {};
+struct Running { int progress; };
+struct Failed { short code; };
+
+using status = eggs::variant<Idle, Running, Failed>;
+
+TEST_CASE("atomic_variant<Ts...>::atomic_variant()", "[atomic_variant]")
+{
+    eggs::variants::atomic_variant<Idle, Running, Failed> av;
+
+    CHECK(av.load().which() == eggs::variant_npos);
+}
+
+TEST_CASE("atomic_variant<Ts...>::store(variant<Ts...> const&)", "[atomic_variant]")
+{
+    eggs::variants::atomic_variant<Idle, Running, Failed> av(Idle{});
+    REQUIRE(av.load().which() == 0u);
+
+    Running const r = {42};
+    av.store(r);
+
+    status const s = av.load();
+    REQUIRE(s.which() == 1u);
+    CHECK(s.target<Running>()->progress == 42);
+
+    Failed const f = {-1};
+    av = f;
+
+    status const s2 = av;
+    REQUIRE(s2.which() == 2u);
+    CHECK(s2.target<Failed>()->code == -1);
+
+    (void)av.is_lock_free();
+}
+
+TEST_CASE("atomic_variant<Ts...>::exchange(variant<Ts...> const&)", "[atomic_variant]")
+{
+    Running const r = {1};
+    eggs::variants::atomic_variant<Idle, Running, Failed> av(r);
+
+    status const prev = av.exchange(Idle{});
+    REQUIRE(prev.which() == 1u);
+    CHECK(prev.target<Running>()->progress == 1);
+    CHECK(av.load().which() == 0u);
+}
+
+TEST_CASE("atomic_variant<Ts...>::compare_exchange_strong(variant<Ts...>&, variant<Ts...> const&)", "[atomic_variant]")
+{
+    Running const r = {1};
+    eggs::variants::atomic_variant<Idle, Running, Failed> av(r);
+
+    // the representation of inactive bytes is irrelevant
+    {
+        status expected = Failed{7};
+        expected = r;
+
+        Running const r2 = {2};
+        CHECK(av.compare_exchange_strong(expected, r2));
+        CHECK(av.load().target<Running>()->progress == 2);
+    }
+
+    // failure loads the stored value
+    {
+        status expected = Idle{};
+        CHECK_FALSE(av.compare_exchange_strong(expected, Failed{3}));
+        REQUIRE(expected.which() == 1u);
+        CHECK(expected.target<Running>()->progress == 2);
+    }
+
+    // concurrent increments
+    {
+        av.store(Running{0});
+
+        std::size_t const threads = 4;
+        int const increments = 1000;
+        std::vector<std::thread> workers;
+        for (std::size_t t = 0; t < threads; ++t)
+        {
+            workers.emplace_back([&av, increments]
+            {
+                for (int i = 0; i < increments; ++i)
+                {
+                    status expected = av.load(std::memory_order_relaxed);
+                    Running next;
+                    do
+                    {
+                        next.progress = expected.target<Running>()->progress + 1;
+                    } while (!av.compare_exchange_weak(expected, next));
+                }
+            });
+        }
+        for (std::size_t t = 0; t < threads; ++t)
+            workers[t].join();
+
+        status const s = av.load();
+        REQUIRE(s.which() == 1u);
+        CHECK(s.target<Running>()->progress == int(threads) * increments);
+    }
+}
@@ -0,0 +1,320 @@
+// Eggs.Variant
+//
+// Copyright Agustin K-ballo Berge, Fusion Fenix 2014-2018
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <eggs/variant.hpp>
+#include <eggs/variant/boxed.hpp>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <eggs/variant/detail/config/prefix.hpp>
+
+#include "catch.hpp"
+
+struct Large
+{
+    Large(int x = 0) : x(x) { data[0] = 0; }
+
+    int x;
+    char data[2048];
+};
+
+bool operator==(Large const& lhs, Large const& rhs) { return lhs.x == rhs.x; }
+bool operator!=(Large const& lhs, Large const& rhs) { return lhs.x != rhs.x; }
+bool operator<(Large const& lhs, Large const& rhs) { return lhs.x < rhs.x; }
+bool operator>(Large const& lhs, Large const& rhs) { return lhs.x > rhs.x; }
+bool operator<=(Large const& lhs, Large const& rhs) { return lhs.x <= rhs.x; }
+bool operator>=(Large const& lhs, Large const& rhs) { return lhs.x >= rhs.x; }
+
+namespace std
+{
+    template <>
+    struct hash<Large>
+    {
+        std::size_t operator()(Large const& l) const noexcept
+        {
+            return std::size_t(l.x);
+        }
+    };
+}
+
+using Variant = eggs::variants::variant<int, eggs::variants::boxed<Large>>;
+
+struct Value
+{
+    int operator()(int i) const { return i; }
+    int operator()(Large const& l) const { return l.x; }
+};
+
+TEST_CASE("boxed<T>", "[boxed]")
+{
+    static_assert(std::is_nothrow_move_constructible<eggs::variants::boxed<Large>>::value, "");
+    static_assert(std::is_nothrow_move_assignable<eggs::variants::boxed<Large>>::value, "");
+    static_assert(std::is_nothrow_move_constructible<Variant>::value, "");
+
+    eggs::variants::boxed<Large> b(42);
+    CHECK(bool(b));
+    CHECK(b->x == 42);
+    CHECK(b.get().x == 42);
+
+    eggs::variants::boxed<Large> c(b);
+    CHECK(c->x == 42);
+    CHECK(&*c != &*b);
+
+    // moves transfer the boxed object
+    Large* ptr = &*b;
+    eggs::variants::boxed<Large> m(std::move(b));
+    CHECK(&*m == ptr);
+    CHECK_FALSE(bool(b));
+    CHECK(b.operator->() == nullptr);
+
+    eggs::variants::boxed<Large> n(Large(7));
+    n = std::move(m);
+    CHECK(&*n == ptr);
+    CHECK(m->x == 7);
+
+    CHECK(n == c);
+    CHECK(m < n);
+    CHECK(std::hash<eggs::variants::boxed<std::string>>()(std::string("text"))
+        == std::hash<std::string>()("text"));
+
+    // a moved-from boxed<T> can be copied, compared and hashed
+    eggs::variants::boxed<Large> e(b);
+    CHECK_FALSE(bool(e));
+    CHECK(e == b);
+    CHECK(e != n);
+    CHECK(e < n);
+    CHECK_FALSE(n <= e);
+    CHECK(std::hash<eggs::variants::boxed<Large>>()(e) == 0u);
+
+    e = n;
+    CHECK(e == n);
+    CHECK(&*e != &*n);
+    e = b;
+    CHECK_FALSE(bool(e));
+}
+
+TEST_CASE("variant<Ts...> with a boxed<T> alternative", "[boxed]")
+{
+    CHECK(sizeof(Variant) < sizeof(Large));
+
+    Variant v(Large(42));
+    REQUIRE(v.which() == 1u);
+
+    // accessed as the boxed type
+    Large& l = eggs::variants::get<1>(v);
+    CHECK(l.x == 42);
+    CHECK(eggs::variants::get<Large>(v).x == 42);
+    CHECK(eggs::variants::get_if<Large>(&v) == &l);
+    CHECK(eggs::variants::get_if<int>(&v) == nullptr);
+    CHECK(v.target<Large>() == &l);
+    CHECK(v.target<eggs::variants::boxed<Large>>() == nullptr);
+    CHECK(eggs::variants::apply<int>(Value{}, v) == 42);
+
+    Variant const& cv = v;
+    CHECK(eggs::variants::get<Large>(cv).x == 42);
+    CHECK(cv.target<Large>() == &l);
+    CHECK(cv.target<eggs::variants::boxed<Large>>() == nullptr);
+
+    // moves do not move the boxed object
+    Variant m(std::move(v));
+    CHECK(m.target<Large>() == &l);
+
+    Variant w(eggs::variants::in_place<Large>, 7);
+    CHECK(eggs::variants::get<Large>(w).x == 7);
+    w.emplace<Large>(3);
+    CHECK(eggs::variants::get<1>(w).x == 3);
+
+    CHECK(m != w);
+    CHECK(w < m);
+    CHECK(Variant(1) < w);
+    CHECK(std::hash<Variant>()(w) == std::hash<eggs::variants::boxed<Large>>()(Large(3)));
+
+    w = m;
+    CHECK(w == m);
+    CHECK(w.target<Large>() != m.target<Large>());
+}
+
+TEST_CASE("variant<Ts...> with a boxed<T> alternative relational operators", "[boxed]")
+{
+    Variant const v(Large(3));
+
+    // compares against the boxed type
+    CHECK(v == Large(3));
+    CHECK(Large(3) == v);
+    CHECK(v != Large(4));
+    CHECK(Large(4) != v);
+    CHECK(v < Large(4));
+    CHECK(Large(2) < v);
+    CHECK(v > Large(2));
+    CHECK(Large(4) > v);
+    CHECK(v <= Large(3));
+    CHECK(Large(3) <= v);
+    CHECK(v >= Large(3));
+    CHECK(Large(3) >= v);
+
+    CHECK_FALSE(Variant{} == Large{});
+    CHECK(Variant{} != Large{});
+    CHECK(Variant{} < Large{});
+    CHECK_FALSE(Variant(1) == Large(1));
+    CHECK(Variant(1) < Large(1));
+    CHECK(Large(1) > Variant(1));
+}
+
+TEST_CASE("variant<Ts...> with a moved-from boxed<T> alternative", "[boxed]")
+{
+    using Text = eggs::variants::variant<int, eggs::variants::boxed<std::string>>;
+
+    Text v(std::string("text"));
+    Text m(std::move(v));
+    CHECK(eggs::variants::get<std::string>(m) == "text");
+
+    // a moved-from variant can be copied, compared, hashed and assigned to
+    REQUIRE(v.which() == 1u);
+
+    Text c(v);
+    REQUIRE(c.which() == 1u);
+    CHECK(c == v);
+    CHECK(c != m);
+    CHECK(c < m);
+    CHECK(m > c);
+    CHECK(Text(1) < c);
+    CHECK(std::hash<Text>()(v) == std::hash<Text>()(c));
+
+    v = m;
+    CHECK(v == m);
+    CHECK(eggs::variants::get<std::string>(v) == "text");
+}
+
+TEST_CASE("std::vector<variant<Ts...>> with a boxed<T> alternative", "[boxed]")
+{
+    using Pool = eggs::variants::box_pool<Large>;
+    Pool::release();
+
+    // growing the vector moves the elements, which does not box new objects
+    Pool::statistics const before = Pool::stats();
+    {
+        std::vector<Variant> vs;
+        for (int i = 0; i < 1000; ++i)
+            vs.emplace_back(Large(i));
+        CHECK(eggs::variants::get<Large>(vs.back()).x == 999);
+    }
+    Pool::statistics const after = Pool::stats();
+    CHECK((after.allocated + after.reused) - (before.allocated + before.reused) == 1000u);
+
+    Pool::release();
+}
+
+TEST_CASE("box_pool<T>", "[boxed]")
+{
+    using Pool = eggs::variants::box_pool<Large>;
+    Pool::release();
+
+    Pool::statistics const before = Pool::stats();
+    CHECK(before.cached == 0u);
+
+    {
+        Variant v(Large(1));
+        Variant w(Large(2));
+    }
+    Pool::statistics const after = Pool::stats();
+    CHECK(after.allocated - before.allocated == 2u);
+    CHECK(after.cached == 2u);
+
+    // deallocated blocks are reused
+    Large const* ptr;
+    {
+        Variant v(Large(3));
+        ptr = v.target<Large>();
+        Variant w(v);
+        CHECK(w.target<Large>() != ptr);
+    }
+    Pool::statistics const reused = Pool::stats();
+    CHECK(reused.allocated == after.allocated);
+    CHECK(reused.reused - after.reused == 2u);
+    CHECK(reused.cached == 2u);
+
+    Pool::release();
+    CHECK(Pool::stats().cached == 0u);
+    CHECK(Pool::stats().released - reused.released == 2u);
+
+    CHECK(Pool::max_cached >= 1u);
+    CHECK(Pool::max_cached * sizeof(Large) <= 65536u);
+}
+
+// a thread local object constructed before the free list is first used, so
+// that it is destroyed after it is released
+struct LateHolder
+{
+    ~LateHolder()
+    {
+        using Pool = eggs::variants::box_pool<Large>;
+        std::size_t const released = Pool::stats().released;
+        box.reset();
+        *cached = Pool::stats().cached;
+        *deallocated = Pool::stats().released - released;
+    }
+
+    std::unique_ptr<eggs::variants::boxed<Large>> box;
+    std::size_t* cached;
+    std::size_t* deallocated;
+};
+
+TEST_CASE("box_pool<T> on thread exit", "[boxed]")
+{
+    std::size_t cached = std::size_t(-1);
+    std::size_t deallocated = 0;
+    std::thread([&]
+    {
+        static thread_local LateHolder holder;
+        holder.cached = &cached;
+        holder.deallocated = &deallocated;
+        holder.box.reset(new eggs::variants::boxed<Large>(1));
+
+        eggs::variants::boxed<Large>(2);
+        CHECK(eggs::variants::box_pool<Large>::stats().cached == 1u);
+    }).join();
+
+    CHECK(cached == 0u);
+    CHECK(deallocated == 1u);
+}
+
+TEST_CASE("threshold_variant<Threshold, Ts...>", "[boxed]")
+{
+    using Small = std::pair<int, int>;
+    using V = eggs::variants::threshold_variant<64, Small, std::string, Large>;
+
+    static_assert(
+        std::is_same<V, eggs::variants::variant<
+            Small, std::string, eggs::variants::boxed<Large>>>::value, "");
+    static_assert(
+        std::is_same<eggs::variants::compact_variant<int, Large>, Variant>::value, "");
+
+    CHECK(sizeof(V) <= 64u);
+
+    V v(Large(42));
+    CHECK(eggs::variants::get<2>(v).x == 42);
+    CHECK(eggs::variants::get<Large>(v).x == 42);
+    CHECK(v.target<Large>()->x == 42);
+
+    // conversions to a boxed type
+    eggs::variants::threshold_variant<16, int, std::string> s("text");
+    CHECK(s.which() == 1u);
+    CHECK(eggs::variants::get<std::string>(s) == "text");
+
+    Large& l = v.emplace<Large>(7);
+    CHECK(l.x == 7);
+    CHECK(&l == eggs::variants::get_if<2>(&v));
+
+    V e(eggs::variants::in_place<Large>, 3);
+    CHECK(eggs::variants::get<Large>(e).x == 3);
+}
@@ -0,0 +1,129 @@
+// Eggs.Variant
+//
+// Copyright Agustin K-ballo Berge, Fusion Fenix 2014-2018
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <eggs/variant.hpp>
+#include <eggs/variant/cow_variant.hpp>
+#include <cstddef>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <eggs/variant/detail/config/prefix.hpp>
+
+#include "catch.hpp"
+
+struct Payload
+{
+    static std::size_t copies;
+
+    Payload(std::size_t size) : data(size, 1) {}
+    Payload(Payload const& rhs) : data(rhs.data) { ++copies; }
+
+    std::vector<int> data;
+};
+
+std::size_t Payload::copies = 0;
+
+bool operator==(Payload const& lhs, Payload const& rhs) { return lhs.data == rhs.data; }
+bool operator!=(Payload const& lhs, Payload const& rhs) { return lhs.data != rhs.data; }
+
+struct Size
+{
+    std::size_t operator()(int) const { return 0; }
+    std::size_t operator()(Payload const& p) const { return p.data.size(); }
+};
+
+struct Grow
+{
+    void operator()(int& i) const { ++i; }
+    void operator()(Payload& p) const { p.data.push_back(2); }
+};
+
+template <typename RefCount>
+void check_copy_on_write()
+{
+    using Cow = eggs::variants::basic_cow_variant<RefCount, int, Payload>;
+    Payload::copies = 0;
+
+    Cow v(eggs::variants::in_place<Payload>, std::size_t(1000));
+    REQUIRE(v.which() == 1u);
+    CHECK(v.use_count() == 1u);
+
+    // copies share the value
+    std::vector<Cow> copies(8, v);
+    CHECK(v.use_count() == 9u);
+    CHECK(Payload::copies == 0u);
+
+    Cow const& cv = copies[0];
+    Cow const& cv0 = v;
+    CHECK(eggs::variants::get<Payload>(cv).data.size() == 1000u);
+    CHECK(cv.template target<Payload>() == cv0.template target<Payload>());
+    CHECK(cv.template apply<std::size_t>(Size{}) == 1000u);
+    CHECK(copies[0] == v);
+    CHECK(Payload::copies == 0u);
+
+    // mutable access copies a shared value once
+    copies[0].template apply<void>(Grow{});
+    CHECK(Payload::copies == 1u);
+    CHECK(copies[0].use_count() == 1u);
+    CHECK(v.use_count() == 8u);
+    CHECK(eggs::variants::get<1>(copies[0]).data.size() == 1001u);
+    CHECK(Payload::copies == 1u);
+    CHECK(copies[0] != v);
+
+    CHECK(eggs::variants::get_if<int>(&copies[1]) == nullptr);
+    CHECK(Payload::copies == 1u);
+    CHECK(eggs::variants::get_if<Payload>(&copies[1]) != nullptr);
+    CHECK(Payload::copies == 2u);
+
+    // emplace does not copy the value it replaces
+    copies[2].template emplace<int>(42);
+    CHECK(Payload::copies == 2u);
+    CHECK(eggs::variants::get<int>(copies[2]) == 42);
+    CHECK(v.use_count() == 6u);
+
+    copies.clear();
+    CHECK(v.use_count() == 1u);
+
+    Cow m(std::move(v));
+    CHECK_FALSE(bool(v));
+    CHECK(v.which() == Cow::npos);
+    CHECK(m.use_count() == 1u);
+
+    v = m;
+    CHECK(v.use_count() == 2u);
+}
+
+TEST_CASE("cow_variant<Ts...>", "[cow_variant]")
+{
+    check_copy_on_write<eggs::variants::atomic_refcount>();
+
+    eggs::variants::cow_variant<int, std::string> v(std::string("text"));
+    eggs::variants::cow_variant<int, std::string> w;
+    CHECK_FALSE(bool(w));
+    CHECK(w.use_count() == 0u);
+    CHECK(v != w);
+
+    w = v;
+    CHECK(w == v);
+    *w.target<std::string>() += "!";
+    CHECK(eggs::variants::get<std::string>(v) == "text");
+    CHECK(eggs::variants::get<std::string>(w) == "text!");
+
+    // compares as variant does, even when the value is shared
+    eggs::variants::cow_variant<int, double> nan(std::numeric_limits<double>::quiet_NaN());
+    eggs::variants::cow_variant<int, double> shared = nan;
+    CHECK(shared.use_count() == 2u);
+    CHECK_FALSE(shared == nan);
+    CHECK(shared != nan);
+}
+
+TEST_CASE("basic_cow_variant<local_refcount, Ts...>", "[cow_variant]")
+{
+    check_copy_on_write<eggs::variants::local_refcount>();
+}
@@ -0,0 +1,88 @@
+// Eggs.Variant
+//
+// Copyright Agustin K-ballo Berge, Fusion Fenix 2014-2018
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <eggs/variant.hpp>
+#include <eggs/variant/event_bus.hpp>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include <eggs/variant/detail/config/prefix.hpp>
+
+#include "catch.hpp"
+
+struct Connected { int id; };
+struct Disconnected { int id; };
+
+using event = eggs::variant<Connected, Disconnected, std::string>;
+
+TEST_CASE("event_bus<Ts...>::publish(variant<Ts...> const&)", "[event_bus]")
+{
+    eggs::variants::event_bus<Connected, Disconnected, std::string> bus;
+    std::vector<std::string> log;
+
+    bus.subscribe<Connected>([&log](Connected const& e) { log.push_back("c" + std::to_string(e.id)); });
+    bus.subscribe<0>([&log](Connected const&) { log.push_back("c"); });
+    bus.subscribe<std::string>([&log](std::string const& s) { log.push_back(s); });
+
+    CHECK(bus.subscribers(0) == 2u);
+    CHECK(bus.subscribers(1) == 0u);
+    CHECK(bus.subscribers(2) == 1u);
+    CHECK(bus.subscribers(3) == 0u);
+
+    bus.publish(event(Connected{1}));
+    bus.publish(event(Disconnected{1}));
+    bus.publish(event(std::string("hello")));
+    bus.publish(event());
+
+    REQUIRE(log.size() == 3u);
+    CHECK(log[0] == "c1");
+    CHECK(log[1] == "c");
+    CHECK(log[2] == "hello");
+}
+
+TEST_CASE("event_bus<Ts...>::publish(InputIt, InputIt)", "[event_bus]")
+{
+    eggs::variants::event_bus<Connected, Disconnected, std::string> bus;
+    int balance = 0;
+
+    bus.subscribe<Connected>([&balance](Connected const&) { ++balance; });
+    bus.subscribe<Disconnected>([&balance](Disconnected const&) { --balance; });
+
+    std::vector<event> events;
+    events.push_back(Connected{1});
+    events.push_back(Connected{2});
+    events.push_back(std::string("noise"));
+    events.push_back(Disconnected{1});
+    events.push_back(Connected{3});
+
+    bus.publish(events.begin(), events.end());
+    CHECK(balance == 2);
+}
+
+TEST_CASE("event_bus<Ts...>::unsubscribe(subscription)", "[event_bus]")
+{
+    eggs::variants::event_bus<Connected, Disconnected, std::string> bus;
+    int first = 0, second = 0;
+
+    auto s1 = bus.subscribe<Connected>([&first](Connected const&) { ++first; });
+    auto s2 = bus.subscribe<Connected>([&second](Connected const&) { ++second; });
+
+    bus.publish(event(Connected{1}));
+    CHECK(bus.unsubscribe(s1));
+    CHECK_FALSE(bus.unsubscribe(s1));
+    bus.publish(event(Connected{2}));
+
+    CHECK(first == 1);
+    CHECK(second == 2);
+
+    CHECK(bus.unsubscribe(s2));
+    CHECK(bus.subscribers(0) == 0u);
+
+    decltype(s1) const invalid = {7, 0};
+    CHECK_FALSE(bus.unsubscribe(invalid));
+}
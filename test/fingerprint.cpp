@@ -0,0 +1,83 @@
+// Eggs.Variant
+//
+// Copyright Agustin K-ballo Berge, Fusion Fenix 2014-2018
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <eggs/variant.hpp>
+#include <eggs/variant/fingerprint.hpp>
+#include <cstdint>
+#include <type_traits>
+
+#include <eggs/variant/detail/config/prefix.hpp>
+
+#include "catch.hpp"
+
+struct Celsius { float value; };
+struct Fahrenheit { float value; };
+
+namespace eggs { namespace variants
+{
+    template <>
+    struct type_name<Celsius>
+    {
+        EGGS_CXX11_STATIC_CONSTEXPR char const* value = "Celsius";
+    };
+
+    template <>
+    struct type_name<Fahrenheit>
+    {
+        EGGS_CXX11_STATIC_CONSTEXPR char const* value = "Fahrenheit";
+    };
+}}
+
+TEST_CASE("variant_fingerprint<variant<Ts...>>", "[variant.helper]")
+{
+    using eggs::variants::variant_fingerprint;
+
+    CHECK((std::is_base_of<
+        std::integral_constant<std::uint64_t,
+            variant_fingerprint<eggs::variant<int, float>>::value>,
+        variant_fingerprint<eggs::variant<int, float>>>::value));
+
+    // stable for the same list of alternatives
+    CHECK(variant_fingerprint<eggs::variant<int, float>>::value
+       == variant_fingerprint<eggs::variant<int, float>>::value);
+
+    // sensitive to order and count
+    CHECK(variant_fingerprint<eggs::variant<int, double>>::value
+       != variant_fingerprint<eggs::variant<double, int>>::value);
+    CHECK(variant_fingerprint<eggs::variant<int>>::value
+       != variant_fingerprint<eggs::variant<int, int>>::value);
+    CHECK(variant_fingerprint<eggs::variant<>>::value
+       != variant_fingerprint<eggs::variant<int>>::value);
+
+    // sensitive to layout
+    CHECK(variant_fingerprint<eggs::variant<int, char>>::value
+       != variant_fingerprint<eggs::variant<int, short>>::value);
+
+    // sensitive to names, when given
+    CHECK(variant_fingerprint<eggs::variant<int, Celsius>>::value
+       != variant_fingerprint<eggs::variant<int, Fahrenheit>>::value);
+    CHECK(variant_fingerprint<eggs::variant<int, Celsius>>::value
+       != variant_fingerprint<eggs::variant<int, float>>::value);
+
+    // sensitive to nested variants
+    CHECK(variant_fingerprint<eggs::variant<int, eggs::variant<Celsius, Fahrenheit>>>::value
+       != variant_fingerprint<eggs::variant<int, eggs::variant<Fahrenheit, Celsius>>>::value);
+
+    // cv-qualified variants
+    CHECK(variant_fingerprint<eggs::variant<int, float> const>::value
+       == variant_fingerprint<eggs::variant<int, float>>::value);
+
+#if EGGS_CXX11_HAS_CONSTEXPR
+    constexpr std::uint64_t fp = variant_fingerprint<eggs::variant<int, Celsius>>::value;
+    static_assert(fp == variant_fingerprint<eggs::variant<int, Celsius>>::value, "");
+#endif
+
+#if EGGS_CXX14_HAS_VARIABLE_TEMPLATES
+    CHECK(eggs::variants::variant_fingerprint_v<eggs::variant<int, float>>
+       == variant_fingerprint<eggs::variant<int, float>>::value);
+#endif
+}
@@ -0,0 +1,100 @@
+// Eggs.Variant
+//
+// Copyright Agustin K-ballo Berge, Fusion Fenix 2014-2018
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <eggs/variant.hpp>
+#include <eggs/variant/interned_variant.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <eggs/variant/detail/config/prefix.hpp>
+
+#include "catch.hpp"
+
+using Interned = eggs::variants::interned_variant<std::int64_t, double, std::string>;
+
+TEST_CASE("interned_variant<Ts...>::interned_variant()", "[interned_variant]")
+{
+    Interned i;
+
+    CHECK_FALSE(bool(i));
+    CHECK(i.which() == Interned::npos);
+    CHECK_FALSE(bool(*i));
+    CHECK(i == Interned(eggs::variants::variant<std::int64_t, double, std::string>()));
+}
+
+TEST_CASE("interned_variant<Ts...>::interned_variant(U&&)", "[interned_variant]")
+{
+    std::size_t const size = Interned::pool_size();
+
+    Interned a(std::string("rule"));
+    Interned b(std::string("rule"));
+    Interned c(std::int64_t(42));
+    Interned d(42.0);
+
+    REQUIRE(a.which() == 2u);
+    CHECK(*a.target<std::string>() == "rule");
+    CHECK(eggs::variants::get<std::string>(*a) == "rule");
+
+    // equal values share an entry
+    CHECK(a == b);
+    CHECK(&*a == &*b);
+    CHECK(a != c);
+    CHECK(c != d);
+    CHECK(Interned::pool_size() - size == 3u);
+
+    CHECK(a.hash() == std::hash<Interned::value_type>()(*a));
+    CHECK(std::hash<Interned>()(a) == a.hash());
+    CHECK(sizeof(Interned) == sizeof(void*));
+}
+
+TEST_CASE("interned_variant<Ts...> with a NaN", "[interned_variant]")
+{
+    double const nan = std::numeric_limits<double>::quiet_NaN();
+    std::size_t const size = Interned::pool_size();
+
+    // a value that does not compare equal to itself is interned once
+    Interned a(nan);
+    bool same = true;
+    for (int i = 0; i < 1000; ++i)
+        same = same && Interned(nan) == a;
+    CHECK(same);
+    CHECK(Interned::pool_size() - size == 1u);
+
+    REQUIRE(a.which() == 1u);
+    CHECK(*a != *a);
+    CHECK(a != Interned(0.0));
+}
+
+TEST_CASE("interned_variant<Ts...> concurrent interning", "[interned_variant]")
+{
+    std::size_t const values = 256;
+    std::vector<std::vector<Interned>> interned(4);
+
+    std::vector<std::thread> threads;
+    for (std::size_t t = 0; t < interned.size(); ++t)
+    {
+        threads.emplace_back([&interned, t, values] {
+            for (std::size_t i = 0; i < values; ++i)
+                interned[t].push_back(Interned(std::to_string(i % 64) + "/concurrent"));
+        });
+    }
+    for (std::thread& thread : threads)
+        thread.join();
+
+    for (std::size_t t = 1; t < interned.size(); ++t)
+    {
+        for (std::size_t i = 0; i < values; ++i)
+            CHECK(interned[t][i] == interned[0][i]);
+    }
+    CHECK(interned[0][0] == interned[0][64]);
+    CHECK(interned[0][0] == Interned(std::string("0/concurrent")));
+}
@@ -0,0 +1,209 @@
+// Eggs.Variant
+//
+// Copyright Agustin K-ballo Berge, Fusion Fenix 2014-2018
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <eggs/variant.hpp>
+#include <eggs/variant/mapped_variant_array.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <vector>
+
+#include <eggs/variant/detail/config/prefix.hpp>
+
+#include "catch.hpp"
+
+struct Point
+{
+    int x, y;
+};
+
+struct Sum
+{
+    double operator()(int i) const { return i; }
+    double operator()(double d) const { return d; }
+    double operator()(Point p) const { return p.x + p.y; }
+};
+
+// an image buffer, aligned for any of the alternatives
+
+struct Image
+{
+    explicit Image(std::size_t size)
+      : words((size + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t) + 1)
+      , size(size)
+    {}
+
+    unsigned char* data()
+    {
+        return reinterpret_cast<unsigned char*>(words.data());
+    }
+
+    std::vector<std::uint64_t> words;
+    std::size_t size;
+};
+
+TEST_CASE("mapped_variant_array<Ts...>::write(ForwardIt, ForwardIt, OutputIt)", "[mapped_variant_array]")
+{
+    using array = eggs::variants::mapped_variant_array<int, double, Point>;
+    std::vector<eggs::variant<int, double, Point>> vs;
+    vs.push_back(42);
+    vs.push_back(eggs::variant<int, double, Point>{});
+    vs.push_back(4.f);
+    Point const p = {1, 2};
+    vs.push_back(p);
+
+    std::vector<unsigned char> bytes;
+    array::write(vs.begin(), vs.end(), std::back_inserter(bytes));
+
+    CHECK(bytes.size() == array::image_size(vs.size()));
+
+    Image image(bytes.size());
+    std::memcpy(image.data(), bytes.data(), bytes.size());
+
+    array a(image.data(), image.size);
+
+    REQUIRE(a.size() == 4u);
+    CHECK(a.which(0) == 0u);
+    CHECK(a.which(1) == array::npos);
+    CHECK(a.which(2) == 1u);
+    CHECK(a.which(3) == 2u);
+
+    REQUIRE(a.get_if<0>(0) != nullptr);
+    CHECK(*a.get_if<0>(0) == 42);
+    CHECK(a.get_if<1>(0) == nullptr);
+    CHECK(a.get_if<int>(1) == nullptr);
+    CHECK(a.target(1) == nullptr);
+    REQUIRE(a.get_if<double>(2) != nullptr);
+    CHECK(*a.get_if<double>(2) == 4.);
+    REQUIRE(a.get_if<Point>(3) != nullptr);
+    CHECK(a.get_if<Point>(3)->x == 1);
+    CHECK(a.get_if<Point>(3)->y == 2);
+
+    // zero-copy access
+    CHECK(a.target(3) == a.get_if<Point>(3));
+    CHECK(static_cast<void const*>(a.get_if<int>(0)) >= image.data());
+    CHECK(static_cast<void const*>(a.get_if<int>(0)) < image.data() + image.size);
+
+    // deterministic images
+    std::vector<unsigned char> again;
+    array::write(vs.begin(), vs.end(), std::back_inserter(again));
+    CHECK(bytes == again);
+}
+
+TEST_CASE("mapped_variant_array<Ts...>::apply(F&&, std::size_t)", "[mapped_variant_array]")
+{
+    using array = eggs::variants::mapped_variant_array<int, double, Point>;
+    std::vector<eggs::variant<int, double, Point>> vs;
+    vs.push_back(42);
+    vs.push_back(4.5);
+    Point const p = {1, 2};
+    vs.push_back(p);
+    vs.push_back(eggs::variant<int, double, Point>{});
+
+    Image image(array::image_size(vs.size()));
+    unsigned char* end = array::write(vs.begin(), vs.end(), image.data());
+    CHECK(std::size_t(end - image.data()) == image.size);
+
+    array a(image.data(), image.size);
+
+    CHECK(a.apply(Sum{}, 0) == 42.);
+    CHECK(a.apply(Sum{}, 1) == 4.5);
+    CHECK(a.apply(Sum{}, 2) == 3.);
+    CHECK(a.apply<int>(Sum{}, 1) == 4);
+
+#if EGGS_CXX98_HAS_EXCEPTIONS
+    CHECK_THROWS_AS(a.apply(Sum{}, 3), eggs::variants::bad_variant_access);
+#endif
+}
+
+TEST_CASE("mapped_variant_array<Ts...>::map(void const*, std::size_t)", "[mapped_variant_array]")
+{
+    using array = eggs::variants::mapped_variant_array<int, double>;
+    std::vector<eggs::variant<int, double>> vs;
+    vs.push_back(1);
+    vs.push_back(2.);
+
+    Image image(array::image_size(vs.size()));
+    array::write(vs.begin(), vs.end(), image.data());
+
+    // truncated
+    {
+        array a;
+        CHECK(a.map(image.data(), 8) == eggs::variants::decode_status::incomplete);
+        CHECK(a.map(image.data(), image.size - 1) == eggs::variants::decode_status::incomplete);
+        CHECK(a.empty());
+    }
+
+    // misaligned
+    {
+        Image misaligned(image.size + 1);
+        std::memcpy(misaligned.data() + 1, image.data(), image.size);
+
+        array a;
+        CHECK(a.map(misaligned.data() + 1, image.size) == eggs::variants::decode_status::malformed);
+    }
+
+    // different alternatives
+    {
+        using other = eggs::variants::mapped_variant_array<double, int>;
+        CHECK(other::fingerprint != array::fingerprint);
+
+        other a;
+        CHECK(a.map(image.data(), image.size) == eggs::variants::decode_status::malformed);
+    }
+
+    // different byte order
+    {
+        Image swapped(image.size);
+        std::memcpy(swapped.data(), image.data(), image.size);
+        std::reverse(swapped.data() + 8, swapped.data() + 12);
+
+        array a;
+        CHECK(a.map(swapped.data(), image.size) == eggs::variants::decode_status::malformed);
+    }
+
+    // out of range discriminator
+    {
+        Image corrupt(image.size);
+        std::memcpy(corrupt.data(), image.data(), image.size);
+        corrupt.data()[40 + 1] = 3;
+
+        array a;
+        CHECK(a.map(corrupt.data(), image.size) == eggs::variants::decode_status::malformed);
+    }
+
+    // forged count, header only
+    {
+        Image forged(40);
+        std::memcpy(forged.data(), image.data(), forged.size);
+
+        array a;
+        std::uint64_t count = 40;
+        std::uint64_t payload_offset = 80;
+        std::memcpy(forged.data() + 24, &count, sizeof(count));
+        std::memcpy(forged.data() + 32, &payload_offset, sizeof(payload_offset));
+        CHECK(a.map(forged.data(), forged.size) == eggs::variants::decode_status::incomplete);
+
+        payload_offset = 1024;
+        std::memcpy(forged.data() + 32, &payload_offset, sizeof(payload_offset));
+        CHECK(a.map(forged.data(), forged.size) == eggs::variants::decode_status::malformed);
+        CHECK(a.empty());
+    }
+
+    // valid
+    {
+        array a;
+        CHECK(a.map(image.data(), image.size) == eggs::variants::decode_status::ok);
+        CHECK(a.size() == 2u);
+    }
+
+#if EGGS_CXX98_HAS_EXCEPTIONS
+    CHECK_THROWS_AS(array(image.data(), 8), eggs::variants::bad_variant_decode);
+#endif
+}
@@ -0,0 +1,159 @@
+// Eggs.Variant
+//
+// Copyright Agustin K-ballo Berge, Fusion Fenix 2014-2018
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <eggs/variant.hpp>
+#include <eggs/variant/mpmc_variant_queue.hpp>
+#include <atomic>
+#include <cstddef>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <eggs/variant/detail/config/prefix.hpp>
+
+#include "catch.hpp"
+
+struct Counted
+{
+    static std::size_t instances;
+
+    explicit Counted(int value, bool fail = false) : value(value)
+    {
+#if EGGS_CXX98_HAS_EXCEPTIONS
+        if (fail)
+            throw value;
+#endif
+        ++instances;
+    }
+    Counted(Counted const& rhs) : value(rhs.value) { ++instances; }
+    ~Counted() { --instances; }
+
+    int value;
+};
+
+std::size_t Counted::instances = 0;
+
+struct Record
+{
+    void operator()(int& i) { total += i; }
+    void operator()(Counted& c) { total += c.value; }
+
+    int total;
+};
+
+TEST_CASE("mpmc_variant_queue<Ts...>::try_emplace(Args&&...)", "[mpmc_variant_queue]")
+{
+    Counted::instances = 0;
+    {
+        eggs::variants::mpmc_variant_queue<int, Counted> q(3);
+        CHECK(q.capacity() == 4u);
+
+        CHECK(q.try_emplace<0>(1));
+        CHECK(q.try_emplace<Counted>(2));
+        CHECK(q.try_emplace<int>(3));
+        CHECK(q.try_emplace<Counted>(4));
+        CHECK_FALSE(q.try_emplace<int>(5));
+        CHECK(Counted::instances == 2u);
+
+        Record r = {0};
+        CHECK(q.try_consume(r));
+        CHECK(q.try_consume(r));
+        CHECK(r.total == 3);
+        CHECK(Counted::instances == 1u);
+
+        // wraps around
+        CHECK(q.try_emplace<int>(5));
+        CHECK(q.try_consume(r));
+        CHECK(q.try_consume(r));
+        CHECK(q.try_consume(r));
+        CHECK_FALSE(q.try_consume(r));
+        CHECK(r.total == 15);
+        CHECK(Counted::instances == 0u);
+
+#if EGGS_CXX98_HAS_EXCEPTIONS
+        // failed constructions are skipped
+        CHECK_THROWS(q.try_emplace<Counted>(6, true));
+        CHECK(q.try_emplace<int>(7));
+        CHECK(q.try_consume(r));
+        CHECK(r.total == 22);
+        CHECK_FALSE(q.try_consume(r));
+#endif
+
+        // destroys remaining elements
+        CHECK(q.try_emplace<Counted>(8));
+        CHECK(Counted::instances == 1u);
+    }
+    CHECK(Counted::instances == 0u);
+}
+
+TEST_CASE("mpmc_variant_queue<Ts...>::try_consume(F&&)", "[mpmc_variant_queue]")
+{
+    eggs::variants::mpmc_variant_queue<int, std::string> q(16);
+
+    std::size_t const producers = 3;
+    std::size_t const consumers = 3;
+    int const count = 20000;
+
+    std::atomic<long long> ints(0);
+    std::atomic<std::size_t> chars(0);
+    std::atomic<int> consumed(0);
+
+    struct Sum
+    {
+        void operator()(int& i) const { *ints += i; }
+        void operator()(std::string& s) const { *chars += s.size(); }
+
+        std::atomic<long long>* ints;
+        std::atomic<std::size_t>* chars;
+    } const sum = {&ints, &chars};
+
+    std::vector<std::thread> threads;
+    for (std::size_t t = 0; t < producers; ++t)
+    {
+        threads.emplace_back([&q, count]
+        {
+            for (int i = 0; i < count; ++i)
+            {
+                if (i % 2 == 0)
+                {
+                    while (!q.try_emplace<int>(i))
+                        std::this_thread::yield();
+                } else {
+                    while (!q.try_emplace<std::string>(std::size_t(i % 5), 'x'))
+                        std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (std::size_t t = 0; t < consumers; ++t)
+    {
+        threads.emplace_back([&]
+        {
+            while (consumed.load() < int(producers) * count)
+            {
+                if (q.try_consume(sum))
+                    ++consumed;
+                else
+                    std::this_thread::yield();
+            }
+        });
+    }
+    for (std::size_t t = 0; t < threads.size(); ++t)
+        threads[t].join();
+
+    long long expected_ints = 0;
+    std::size_t expected_chars = 0;
+    for (int i = 0; i < count; ++i)
+    {
+        if (i % 2 == 0)
+            expected_ints += i;
+        else
+            expected_chars += std::size_t(i % 5);
+    }
+    CHECK(ints.load() == expected_ints * long(producers));
+    CHECK(chars.load() == expected_chars * producers);
+}
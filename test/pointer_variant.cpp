@@ -0,0 +1,128 @@
+// Eggs.Variant
+//
+// Copyright Agustin K-ballo Berge, Fusion Fenix 2014-2018
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <eggs/variant.hpp>
+#include <eggs/variant/pointer_variant.hpp>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <type_traits>
+
+#include <eggs/variant/detail/config/prefix.hpp>
+
+#include "catch.hpp"
+
+struct Node
+{
+    int value;
+};
+
+struct Leaf
+{
+    std::string text;
+};
+
+using Pointer = eggs::variants::pointer_variant<Node*, Leaf const*, int*>;
+
+struct Describe
+{
+    std::string operator()(Node* n) const { return "node " + std::to_string(n->value); }
+    std::string operator()(Leaf const* l) const { return "leaf " + l->text; }
+    std::string operator()(int* i) const { return "int " + std::to_string(*i); }
+};
+
+TEST_CASE("pointer_variant<Ts...>", "[pointer_variant]")
+{
+    static_assert(sizeof(Pointer) == sizeof(void*), "");
+    static_assert(std::is_trivially_copyable<Pointer>::value, "");
+
+    Node node = {42};
+    Leaf const leaf = {"text"};
+    int i = 7;
+
+    Pointer e;
+    CHECK_FALSE(bool(e));
+    CHECK(e.which() == Pointer::npos);
+    CHECK(e.bits() == 0u);
+    CHECK(e.target() == nullptr);
+
+    Pointer p(&node);
+    REQUIRE(p.which() == 0u);
+    CHECK(p.target() == &node);
+    CHECK(p.target<Node>() == &node);
+    CHECK(p.target<int>() == nullptr);
+    CHECK(eggs::variants::get<0>(p) == &node);
+    CHECK(eggs::variants::get<Node*>(p) == &node);
+    CHECK(eggs::variants::get_if<Leaf const*>(&p) == nullptr);
+    CHECK(p.apply<std::string>(Describe{}) == "node 42");
+
+    Pointer q(&leaf);
+    REQUIRE(q.which() == 1u);
+    CHECK(eggs::variants::get<1>(q) == &leaf);
+    CHECK(q.apply<std::string>(Describe{}) == "leaf text");
+
+    q.emplace<2>(&i);
+    REQUIRE(q.which() == 2u);
+    CHECK(eggs::variants::get_if<2>(&q) == &i);
+    CHECK(q.apply<std::string>(Describe{}) == "int 7");
+    CHECK(q.apply(Describe{}) == "int 7");
+
+    // a null pointer is still held
+    Pointer n(eggs::variants::in_place<Node*>, nullptr);
+    CHECK(bool(n));
+    CHECK(n.which() == 0u);
+    CHECK(n.target() == nullptr);
+
+    CHECK(p == Pointer(&node));
+    CHECK(p != n);
+    CHECK(e < n);
+    CHECK(p < q);
+    CHECK(q > p);
+    CHECK(p <= q);
+    CHECK(p <= Pointer(&node));
+    CHECK(q >= p);
+    CHECK_FALSE(e >= n);
+    CHECK(Pointer::from_bits(p.bits()) == p);
+    CHECK(std::hash<Pointer>()(p) == std::hash<std::uintptr_t>()(p.bits()));
+
+#if EGGS_CXX98_HAS_EXCEPTIONS
+    CHECK_THROWS_AS(eggs::variants::get<1>(p), eggs::variants::bad_variant_access);
+    CHECK_THROWS_AS(e.apply<std::string>(Describe{}), eggs::variants::bad_variant_access);
+#endif
+}
+
+TEST_CASE("basic_pointer_variant<high_bits_tag, Ts...>", "[pointer_variant]")
+{
+    using Bytes = eggs::variants::basic_pointer_variant<
+        eggs::variants::high_bits_tag, char*, signed char*, unsigned char*>;
+
+    char c = 'c';
+    unsigned char u = 'u';
+
+    Bytes b(&c);
+    CHECK(b.which() == 0u);
+    CHECK(eggs::variants::get<char*>(b) == &c);
+
+    b = Bytes(&u);
+    CHECK(b.which() == 2u);
+    CHECK(eggs::variants::get<2>(b) == &u);
+    CHECK(b.target<unsigned char>() == &u);
+}
+
+TEST_CASE("std::atomic<pointer_variant<Ts...>>", "[pointer_variant]")
+{
+    Node node = {1};
+    int i = 2;
+
+    std::atomic<Pointer> a{Pointer(&node)};
+    Pointer expected(&node);
+    CHECK(a.compare_exchange_strong(expected, Pointer(&i)));
+    CHECK(a.load().which() == 2u);
+    CHECK_FALSE(a.compare_exchange_strong(expected, Pointer()));
+    CHECK(expected == Pointer(&i));
+}
@@ -0,0 +1,171 @@
+// Eggs.Variant
+//
+// Copyright Agustin K-ballo Berge, Fusion Fenix 2014-2018
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <eggs/variant.hpp>
+#include <eggs/variant/recursive.hpp>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <utility>
+
+#include <eggs/variant/detail/config/prefix.hpp>
+
+#include "catch.hpp"
+
+struct Add;
+struct Mul;
+
+using Expr = eggs::variants::variant<
+    int, eggs::variants::recursive<Add>, eggs::variants::recursive<Mul>>;
+
+struct Add
+{
+    Expr lhs;
+    Expr rhs;
+};
+
+struct Mul
+{
+    Expr lhs;
+    Expr rhs;
+};
+
+bool operator==(Add const& lhs, Add const& rhs) { return lhs.lhs == rhs.lhs && lhs.rhs == rhs.rhs; }
+bool operator!=(Add const& lhs, Add const& rhs) { return !(lhs == rhs); }
+bool operator==(Mul const& lhs, Mul const& rhs) { return lhs.lhs == rhs.lhs && lhs.rhs == rhs.rhs; }
+bool operator!=(Mul const& lhs, Mul const& rhs) { return !(lhs == rhs); }
+
+struct Eval
+{
+    int operator()(int i) const
+    {
+        return i;
+    }
+
+    int operator()(Add const& e) const
+    {
+        return eggs::variants::apply<int>(*this, e.lhs)
+             + eggs::variants::apply<int>(*this, e.rhs);
+    }
+
+    int operator()(Mul const& e) const
+    {
+        return eggs::variants::apply<int>(*this, e.lhs)
+             * eggs::variants::apply<int>(*this, e.rhs);
+    }
+};
+
+// (1 + 2) * (3 + 4)
+static Expr make_expr()
+{
+    return Mul{Add{1, 2}, Add{3, 4}};
+}
+
+TEST_CASE("variant<Ts...> with a recursive<T> alternative", "[recursive]")
+{
+    Expr e = make_expr();
+    REQUIRE(e.which() == 2u);
+
+    // accessed as the held type
+    Mul& m = eggs::variants::get<Mul>(e);
+    CHECK(eggs::variants::get_if<2>(&e) == &m);
+    CHECK(e.target<Mul>() == &m);
+    CHECK(e.target<eggs::variants::recursive<Mul>>() == nullptr);
+    CHECK(eggs::variants::get<1>(m.lhs).lhs == Expr(1));
+    CHECK(eggs::variants::apply<int>(Eval{}, e) == 21);
+
+    Expr c(e);
+    CHECK(c == e);
+    CHECK(c.target<Mul>() != e.target<Mul>());
+
+    eggs::variants::get<Add>(eggs::variants::get<Mul>(c).rhs).rhs = 5;
+    CHECK(c != e);
+    CHECK(eggs::variants::apply<int>(Eval{}, c) == 24);
+
+    // moves do not move the held object
+    Expr m2(std::move(e));
+    CHECK(m2.target<Mul>() == &m);
+
+    e.emplace<Add>(Add{1, 1});
+    CHECK(eggs::variants::apply<int>(Eval{}, e) == 2);
+}
+
+TEST_CASE("variant<Ts...> with a moved-from recursive<T> alternative", "[recursive]")
+{
+    Expr e = make_expr();
+    Expr m(std::move(e));
+    CHECK(eggs::variants::apply<int>(Eval{}, m) == 21);
+
+    // a moved-from variant can be copied, compared and assigned to
+    REQUIRE(e.which() == 2u);
+
+    Expr c(e);
+    REQUIRE(c.which() == 2u);
+    CHECK(c == e);
+    CHECK(c != m);
+
+    e = m;
+    CHECK(e == m);
+    CHECK(eggs::variants::apply<int>(Eval{}, e) == 21);
+
+    using Text = eggs::variants::variant<int, eggs::variants::recursive<std::string>>;
+
+    Text t(std::string("text"));
+    Text n(std::move(t));
+    REQUIRE(t.which() == 1u);
+
+    Text d(t);
+    CHECK(d == t);
+    CHECK(d != n);
+    CHECK(d < n);
+    CHECK(Text(1) < d);
+    CHECK(std::hash<Text>()(t) == std::hash<Text>()(d));
+    CHECK(std::hash<Text>()(n) == std::hash<Text>()(Text(std::string("text"))));
+}
+
+TEST_CASE("recursive_arena", "[recursive]")
+{
+    CHECK(eggs::variants::get_recursive_resource() == nullptr);
+
+    eggs::variants::recursive_arena arena(256);
+    CHECK(arena.allocated() == 0u);
+    CHECK(arena.blocks() == 0u);
+    {
+        eggs::variants::recursive_resource* previous =
+            eggs::variants::set_recursive_resource(&arena);
+        CHECK(previous == nullptr);
+        CHECK(eggs::variants::get_recursive_resource() == &arena);
+
+        Expr e = make_expr();
+        eggs::variants::set_recursive_resource(previous);
+
+        CHECK(arena.allocated() >= 3 * sizeof(Add));
+        CHECK(arena.blocks() >= 1u);
+        CHECK(eggs::variants::apply<int>(Eval{}, e) == 21);
+
+        // copies are allocated from the current resource
+        std::size_t const allocated = arena.allocated();
+        Expr c(e);
+        CHECK(arena.allocated() == allocated);
+        CHECK(c == e);
+    }
+
+    // nodes are not returned one by one
+    CHECK(arena.allocated() != 0u);
+    arena.release();
+    CHECK(arena.allocated() == 0u);
+    CHECK(arena.blocks() == 0u);
+
+    std::string const text(300, 'x');
+    eggs::variants::set_recursive_resource(&arena);
+    {
+        eggs::variants::recursive<std::string> r(text);
+        CHECK(*r == text);
+        CHECK(arena.blocks() == 1u);
+    }
+    eggs::variants::set_recursive_resource(nullptr);
+}
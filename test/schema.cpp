@@ -0,0 +1,219 @@
+// Eggs.Variant
+//
+// Copyright Agustin K-ballo Berge, Fusion Fenix 2014-2018
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <eggs/variant.hpp>
+#include <eggs/variant/schema.hpp>
+#include <cstddef>
+#include <iterator>
+#include <vector>
+
+#include <eggs/variant/detail/config/prefix.hpp>
+
+#include "catch.hpp"
+
+struct Celsius { float value; };
+struct Fahrenheit { float value; };
+
+namespace eggs { namespace variants
+{
+    template <>
+    struct type_name<Celsius>
+    {
+        EGGS_CXX11_STATIC_CONSTEXPR char const* value = "Celsius";
+    };
+
+    template <>
+    struct type_name<Fahrenheit>
+    {
+        EGGS_CXX11_STATIC_CONSTEXPR char const* value = "Fahrenheit";
+    };
+}}
+
+using nested = eggs::variant<char, int>;
+using writer = eggs::variant<int, Celsius, nested, Fahrenheit>;
+using reader = eggs::variant<Fahrenheit, nested, int, double>;
+
+TEST_CASE("encode_framed(variant<Ts...> const&, OutputIt)", "[variant.schema]")
+{
+    // trivially copyable
+    {
+        std::vector<unsigned char> bytes;
+        eggs::variants::encode_framed(writer(42), std::back_inserter(bytes));
+
+        REQUIRE(bytes.size() == 2u + sizeof(int));
+        CHECK(bytes[0] == 1u);
+        CHECK(bytes[1] == sizeof(int));
+    }
+
+    // nested variant
+    {
+        std::vector<unsigned char> bytes;
+        eggs::variants::encode_framed(writer(nested('x')), std::back_inserter(bytes));
+
+        REQUIRE(bytes.size() == 4u);
+        CHECK(bytes[0] == 3u);
+        CHECK(bytes[1] == 2u);
+    }
+
+    // empty
+    {
+        std::vector<unsigned char> bytes;
+        eggs::variants::encode_framed(writer(), std::back_inserter(bytes));
+
+        REQUIRE(bytes.size() == 2u);
+        CHECK(bytes[0] == 0u);
+        CHECK(bytes[1] == 0u);
+    }
+}
+
+TEST_CASE("schema_decoder<Ts...>", "[variant.schema]")
+{
+    std::vector<unsigned char> bytes;
+    auto out = std::back_inserter(bytes);
+    out = eggs::variants::encode_schema<writer>(out);
+    out = eggs::variants::encode_framed(writer(42), out);
+    Celsius const c = {36.6f};
+    out = eggs::variants::encode_framed(writer(c), out);
+    out = eggs::variants::encode_framed(writer(nested(43)), out);
+    Fahrenheit const f = {97.9f};
+    out = eggs::variants::encode_framed(writer(f), out);
+    out = eggs::variants::encode_framed(writer(), out);
+
+    unsigned char const* first = bytes.data();
+    unsigned char const* last = bytes.data() + bytes.size();
+
+    eggs::variants::schema_decoder<int, Celsius, nested, Fahrenheit> same;
+    CHECK(same.remap(1) == 1u);
+
+    eggs::variants::schema_decoder<Fahrenheit, nested, int, double> decoder;
+    REQUIRE(decoder.read_schema(first, last) == eggs::variants::decode_status::ok);
+    CHECK(decoder.remap(0) == 2u);
+    CHECK(decoder.remap(1) == decoder.npos);
+    CHECK(decoder.remap(2) == 1u);
+    CHECK(decoder.remap(3) == 0u);
+    CHECK(decoder.remap(4) == decoder.npos);
+
+    reader v;
+    REQUIRE(decoder.try_decode(first, last, v) == eggs::variants::decode_status::ok);
+    REQUIRE(v.which() == 2u);
+    CHECK(*v.target<int>() == 42);
+
+    // unknown alternatives are skipped
+    REQUIRE(decoder.try_decode(first, last, v) == eggs::variants::decode_status::ok);
+    CHECK(v.which() == eggs::variant_npos);
+
+    REQUIRE(decoder.try_decode(first, last, v) == eggs::variants::decode_status::ok);
+    REQUIRE(v.which() == 1u);
+    CHECK(*v.target<nested>() == 43);
+
+    REQUIRE(decoder.try_decode(first, last, v) == eggs::variants::decode_status::ok);
+    REQUIRE(v.which() == 0u);
+    CHECK(v.target<Fahrenheit>()->value == 97.9f);
+
+    REQUIRE(decoder.try_decode(first, last, v) == eggs::variants::decode_status::ok);
+    CHECK(v.which() == eggs::variant_npos);
+
+    CHECK(std::size_t(last - first) == 0u);
+}
+
+TEST_CASE("schema_decoder<Ts...>::try_decode(unsigned char const*&, unsigned char const*, variant<Ts...>&)", "[variant.schema]")
+{
+    eggs::variants::schema_decoder<Fahrenheit, nested, int, double> decoder;
+    {
+        std::vector<unsigned char> schema;
+        eggs::variants::encode_schema<writer>(std::back_inserter(schema));
+
+        unsigned char const* first = schema.data();
+        CHECK(decoder.read_schema(first, first + schema.size() - 1)
+            == eggs::variants::decode_status::incomplete);
+        REQUIRE(decoder.read_schema(first, first + schema.size())
+            == eggs::variants::decode_status::ok);
+    }
+
+    // incomplete
+    {
+        std::vector<unsigned char> bytes;
+        eggs::variants::encode_framed(writer(42), std::back_inserter(bytes));
+
+        reader v(1.);
+        for (std::size_t n = 0; n < bytes.size(); ++n)
+        {
+            unsigned char const* first = bytes.data();
+            CHECK(decoder.try_decode(first, bytes.data() + n, v)
+                == eggs::variants::decode_status::incomplete);
+            CHECK(std::size_t(first - bytes.data()) == 0u);
+            CHECK(v.which() == eggs::variant_npos);
+        }
+    }
+
+    // discriminator out of range
+    {
+        unsigned char const bytes[] = {5, 0};
+
+        unsigned char const* first = bytes;
+        reader v;
+        CHECK(decoder.try_decode(first, bytes + sizeof(bytes), v)
+            == eggs::variants::decode_status::malformed);
+    }
+
+    // framed size mismatch
+    {
+        unsigned char const bytes[] = {1, 5, 0, 0, 0, 0, 0};
+
+        unsigned char const* first = bytes;
+        reader v;
+        CHECK(decoder.try_decode(first, bytes + sizeof(bytes), v)
+            == eggs::variants::decode_status::malformed);
+        CHECK(std::size_t(first - bytes) == 0u);
+    }
+}
+
+TEST_CASE("schema_decoder<Ts...>::read_schema(unsigned char const*&, unsigned char const*)", "[variant.schema]")
+{
+    // alternatives that share a layout are told apart
+    {
+        static_assert(
+            eggs::variants::alternative_id<int>::value
+         != eggs::variants::alternative_id<float>::value, "");
+
+        using same_layout = eggs::variant<int, char>;
+        std::vector<unsigned char> bytes;
+        auto out = std::back_inserter(bytes);
+        out = eggs::variants::encode_schema<same_layout>(out);
+        out = eggs::variants::encode_framed(same_layout(7), out);
+
+        unsigned char const* first = bytes.data();
+        unsigned char const* last = bytes.data() + bytes.size();
+
+        eggs::variants::schema_decoder<float, int, char> decoder;
+        REQUIRE(decoder.read_schema(first, last) == eggs::variants::decode_status::ok);
+        CHECK(decoder.remap(0) == 1u);
+        CHECK(decoder.remap(1) == 2u);
+
+        eggs::variant<float, int, char> v;
+        REQUIRE(decoder.try_decode(first, last, v) == eggs::variants::decode_status::ok);
+        REQUIRE(v.which() == 1u);
+        CHECK(*v.target<int>() == 7);
+    }
+
+    // duplicate ids
+    {
+        std::vector<unsigned char> schema;
+        auto out = std::back_inserter(schema);
+        out = eggs::variants::encode_schema<eggs::variant<int>>(out);
+        std::vector<unsigned char> const id(schema.begin() + 1, schema.end());
+        schema[0] = 2;
+        schema.insert(schema.end(), id.begin(), id.end());
+
+        eggs::variants::schema_decoder<int, char> decoder;
+        unsigned char const* first = schema.data();
+        CHECK(decoder.read_schema(first, first + schema.size())
+            == eggs::variants::decode_status::malformed);
+        CHECK(first == schema.data());
+        CHECK(decoder.remap(0) == 0u);
+    }
+}
@@ -0,0 +1,125 @@
+// Eggs.Variant
+//
+// Copyright Agustin K-ballo Berge, Fusion Fenix 2014-2018
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <eggs/variant.hpp>
+#include <eggs/variant/seqlock_variant.hpp>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+#include <eggs/variant/detail/config/prefix.hpp>
+
+#include "catch.hpp"
+
+struct Small
+{
+    int value;
+};
+
+struct Large
+{
+    long values[16];
+};
+
+struct Check
+{
+    bool operator()(Small const& s) const { return s.value >= 0; }
+    bool operator()(Large const& l) const
+    {
+        for (std::size_t i = 1; i < 16; ++i)
+        {
+            if (l.values[i] != l.values[0] + long(i))
+                return false;
+        }
+        return true;
+    }
+};
+
+static Large make_large(long first)
+{
+    Large l;
+    for (std::size_t i = 0; i < 16; ++i)
+        l.values[i] = first + long(i);
+    return l;
+}
+
+TEST_CASE("seqlock_variant<Ts...>::load()", "[seqlock_variant]")
+{
+    eggs::variants::seqlock_variant<Small, Large> sv;
+    CHECK(sv.load().which() == eggs::variant_npos);
+
+    Small const s = {42};
+    sv.store(s);
+
+    eggs::variant<Small, Large> const v = sv.load();
+    REQUIRE(v.which() == 0u);
+    CHECK(v.target<Small>()->value == 42);
+
+    sv.emplace<Large>(make_large(7));
+    REQUIRE(sv.load().which() == 1u);
+    CHECK(sv.load().target<Large>()->values[15] == 22);
+
+    sv.emplace<0>(Small{1});
+    CHECK(sv.load().which() == 0u);
+}
+
+TEST_CASE("seqlock_variant<Ts...>::apply(F&&)", "[seqlock_variant]")
+{
+    eggs::variants::seqlock_variant<Small, Large> sv(make_large(0));
+    CHECK(sv.apply(Check{}));
+    CHECK(sv.apply<int>(Check{}) == 1);
+
+#if EGGS_CXX98_HAS_EXCEPTIONS
+    eggs::variants::seqlock_variant<Small, Large> empty;
+    CHECK_THROWS_AS(empty.apply(Check{}), eggs::variants::bad_variant_access);
+#endif
+}
+
+TEST_CASE("seqlock_variant<Ts...> concurrent readers and writers", "[seqlock_variant]")
+{
+    eggs::variants::seqlock_variant<Small, Large> sv(make_large(0));
+
+    std::atomic<bool> done(false);
+    std::atomic<std::size_t> torn(0);
+
+    std::vector<std::thread> readers;
+    for (std::size_t t = 0; t < 3; ++t)
+    {
+        readers.emplace_back([&]
+        {
+            while (!done.load())
+            {
+                if (!sv.apply(Check{}))
+                    ++torn;
+            }
+        });
+    }
+
+    std::vector<std::thread> writers;
+    for (std::size_t t = 0; t < 2; ++t)
+    {
+        writers.emplace_back([&sv, t]
+        {
+            for (long i = 0; i < 5000; ++i)
+            {
+                if (i % 3 == 0)
+                    sv.emplace<Small>(Small{int(i)});
+                else
+                    sv.store(make_large(i * 100 + long(t)));
+            }
+        });
+    }
+
+    for (std::size_t t = 0; t < writers.size(); ++t)
+        writers[t].join();
+    done = true;
+    for (std::size_t t = 0; t < readers.size(); ++t)
+        readers[t].join();
+
+    CHECK(torn.load() == 0u);
+}
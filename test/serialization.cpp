@@ -0,0 +1,366 @@
+// Eggs.Variant
+//
+// Copyright Agustin K-ballo Berge, Fusion Fenix 2014-2018
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <eggs/variant.hpp>
+#include <eggs/variant/serialization.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <eggs/variant/detail/config/prefix.hpp>
+
+#include "catch.hpp"
+
+namespace eggs { namespace variants
+{
+    template <>
+    struct serialize<std::string>
+    {
+        template <typename OutputIt>
+        static OutputIt encode(std::string const& value, OutputIt out)
+        {
+            out = serialize<std::size_t>::encode(value.size(), out);
+            return std::copy(value.begin(), value.end(), out);
+        }
+
+        static decode_status decode(
+            unsigned char const*& first, unsigned char const* last,
+            std::string& value)
+        {
+            unsigned char const* it = first;
+            std::size_t size = 0;
+            decode_status status = serialize<std::size_t>::decode(it, last, size);
+            if (status != decode_status::ok)
+                return status;
+            if (static_cast<std::size_t>(last - it) < size)
+                return decode_status::incomplete;
+
+            value.assign(it, it + size);
+            first = it + size;
+            return decode_status::ok;
+        }
+    };
+}}
+
+struct Point
+{
+    int x, y;
+
+    Point(int x, int y) : x(x), y(y) {} // not default constructible
+};
+
+enum class Color : unsigned char { red, green, blue };
+
+TEST_CASE("encode(variant<Ts...> const&, OutputIt)", "[variant.serialization]")
+{
+    // trivially copyable
+    {
+        eggs::variant<char, int> const v(42);
+
+        std::vector<unsigned char> bytes;
+        eggs::variants::encode(v, std::back_inserter(bytes));
+
+        REQUIRE(bytes.size() == 1u + sizeof(int));
+        CHECK(bytes[0] == 2u);
+
+        unsigned char buffer[1 + sizeof(int)];
+        unsigned char* end = eggs::variants::encode(v, buffer);
+
+        CHECK(std::size_t(end - buffer) == sizeof(buffer));
+        CHECK(std::vector<unsigned char>(buffer, end) == bytes);
+    }
+
+    // empty
+    {
+        eggs::variant<char, int> const v;
+
+        std::vector<unsigned char> bytes;
+        eggs::variants::encode(v, std::back_inserter(bytes));
+
+        REQUIRE(bytes.size() == 1u);
+        CHECK(bytes[0] == 0u);
+    }
+}
+
+TEST_CASE("decode<variant<Ts...>>(unsigned char const*&, unsigned char const*)", "[variant.serialization]")
+{
+    using variant = eggs::variant<int, std::string, Point>;
+    using nested = eggs::variant<variant, double>;
+
+    std::vector<unsigned char> bytes;
+    auto out = std::back_inserter(bytes);
+    out = eggs::variants::encode(variant(42), out);
+    out = eggs::variants::encode(variant(std::string("hello")), out);
+    out = eggs::variants::encode(variant(Point(1, 2)), out);
+    out = eggs::variants::encode(variant(), out);
+    out = eggs::variants::encode(nested(variant(std::string("world"))), out);
+
+    unsigned char const* first = bytes.data();
+    unsigned char const* last = bytes.data() + bytes.size();
+
+    variant v0 = eggs::variants::decode<variant>(first, last);
+    REQUIRE(v0.which() == 0u);
+    CHECK(*v0.target<int>() == 42);
+
+    variant v1 = eggs::variants::decode<variant>(first, last);
+    REQUIRE(v1.which() == 1u);
+    CHECK(*v1.target<std::string>() == "hello");
+
+    variant v2 = eggs::variants::decode<variant>(first, last);
+    REQUIRE(v2.which() == 2u);
+    CHECK(v2.target<Point>()->x == 1);
+    CHECK(v2.target<Point>()->y == 2);
+
+    variant v3 = eggs::variants::decode<variant>(first, last);
+    CHECK(v3.which() == eggs::variant_npos);
+
+    nested v4 = eggs::variants::decode<nested>(first, last);
+    REQUIRE(v4.which() == 0u);
+    REQUIRE(v4.target<variant>()->which() == 1u);
+    CHECK(*v4.target<variant>()->target<std::string>() == "world");
+
+    CHECK(std::size_t(last - first) == 0u);
+
+#if EGGS_CXX98_HAS_EXCEPTIONS
+    // incomplete
+    {
+        unsigned char const* it = bytes.data();
+        unsigned char const* end = bytes.data() + 2;
+
+        bool exception_thrown = false;
+        try
+        {
+            eggs::variants::decode<variant>(it, end);
+        } catch (eggs::variants::bad_variant_decode const& e) {
+            exception_thrown = true;
+            CHECK(e.status() == eggs::variants::decode_status::incomplete);
+        }
+        CHECK(exception_thrown);
+        CHECK(std::size_t(it - bytes.data()) == 0u);
+    }
+#endif
+}
+
+TEST_CASE("try_decode(unsigned char const*&, unsigned char const*, variant<Ts...>&)", "[variant.serialization]")
+{
+    using variant = eggs::variant<int, std::string>;
+
+    // incomplete payload
+    {
+        std::vector<unsigned char> bytes;
+        eggs::variants::encode(variant(std::string("hello")), std::back_inserter(bytes));
+
+        variant v(42);
+        for (std::size_t n = 0; n < bytes.size(); ++n)
+        {
+            unsigned char const* first = bytes.data();
+            CHECK(eggs::variants::try_decode(first, bytes.data() + n, v)
+                == eggs::variants::decode_status::incomplete);
+            CHECK(std::size_t(first - bytes.data()) == 0u);
+            CHECK(v.which() == eggs::variant_npos);
+        }
+    }
+
+    // discriminator out of range
+    {
+        unsigned char const bytes[] = {3, 0, 0, 0, 0};
+
+        unsigned char const* first = bytes;
+        variant v;
+        CHECK(eggs::variants::try_decode(first, bytes + sizeof(bytes), v)
+            == eggs::variants::decode_status::malformed);
+        CHECK(std::size_t(first - bytes) == 0u);
+    }
+
+    // overlong discriminator
+    {
+        unsigned char const bytes[] = {
+            0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x01};
+
+        unsigned char const* first = bytes;
+        variant v;
+        CHECK(eggs::variants::try_decode(first, bytes + sizeof(bytes), v)
+            == eggs::variants::decode_status::malformed);
+    }
+
+    // string length out of range
+    {
+        std::vector<unsigned char> bytes;
+        eggs::variants::encode(variant(std::string("hello")), std::back_inserter(bytes));
+        bytes[1] = 0xff;
+
+        unsigned char const* first = bytes.data();
+        variant v;
+        CHECK(eggs::variants::try_decode(first, bytes.data() + bytes.size(), v)
+            != eggs::variants::decode_status::ok);
+        CHECK(v.which() == eggs::variant_npos);
+    }
+
+    // invalid bool
+    {
+        unsigned char const bytes[] = {1, 2};
+
+        unsigned char const* first = bytes;
+        eggs::variant<bool, Color> v;
+        CHECK(eggs::variants::try_decode(first, bytes + sizeof(bytes), v)
+            == eggs::variants::decode_status::malformed);
+        CHECK(v.which() == eggs::variant_npos);
+    }
+
+    // bool and enumerations
+    {
+        using flags = eggs::variant<bool, Color>;
+        std::vector<unsigned char> bytes;
+        auto out = std::back_inserter(bytes);
+        out = eggs::variants::encode(flags(true), out);
+        out = eggs::variants::encode(flags(Color::blue), out);
+        CHECK(bytes.size() == 3u + sizeof(Color));
+
+        unsigned char const* first = bytes.data();
+        unsigned char const* last = bytes.data() + bytes.size();
+        flags v;
+        REQUIRE(eggs::variants::try_decode(first, last, v)
+            == eggs::variants::decode_status::ok);
+        CHECK(v == flags(true));
+        REQUIRE(eggs::variants::try_decode(first, last, v)
+            == eggs::variants::decode_status::ok);
+        CHECK(v == flags(Color::blue));
+    }
+
+    // variant<>
+    {
+        unsigned char const bytes[] = {0};
+
+        unsigned char const* first = bytes;
+        eggs::variant<> v;
+        CHECK(eggs::variants::try_decode(first, bytes + 1, v)
+            == eggs::variants::decode_status::ok);
+        CHECK(std::size_t(first - bytes) == 1u);
+    }
+}
+
+struct Collect
+{
+    void operator()(int i) { ints.push_back(i); }
+    void operator()(std::string&& s) { strings.push_back(std::move(s)); }
+    void operator()(Point&& p) { ints.push_back(p.x * 10 + p.y); }
+
+    std::vector<int> ints;
+    std::vector<std::string> strings;
+};
+
+TEST_CASE("variant_decoder<Ts...>::feed(unsigned char const*, unsigned char const*, F&&)", "[variant.serialization]")
+{
+    using variant = eggs::variant<int, std::string>;
+
+    std::vector<unsigned char> bytes;
+    auto out = std::back_inserter(bytes);
+    out = eggs::variants::encode(variant(42), out);
+    out = eggs::variants::encode(variant(std::string(200, 'x')), out);
+    out = eggs::variants::encode(variant(), out);
+    out = eggs::variants::encode(variant(std::string("hello")), out);
+    out = eggs::variants::encode(variant(43), out);
+
+    for (std::size_t chunk = 1; chunk <= bytes.size(); ++chunk)
+    {
+        eggs::variants::variant_decoder<int, std::string> decoder;
+        std::vector<variant> vs;
+
+        for (std::size_t offset = 0; offset < bytes.size(); offset += chunk)
+        {
+            std::size_t const count = (std::min)(chunk, bytes.size() - offset);
+            CHECK(decoder.feed(
+                bytes.data() + offset, bytes.data() + offset + count,
+                [&vs](variant&& v) { vs.push_back(std::move(v)); })
+                == eggs::variants::decode_status::ok);
+        }
+
+        CHECK(decoder.pending() == 0u);
+        REQUIRE(vs.size() == 5u);
+        CHECK(vs[0] == 42);
+        CHECK(vs[1] == std::string(200, 'x'));
+        CHECK(vs[2].which() == eggs::variant_npos);
+        CHECK(vs[3] == std::string("hello"));
+        CHECK(vs[4] == 43);
+    }
+
+    // pending
+    {
+        eggs::variants::variant_decoder<int, std::string> decoder;
+        std::size_t records = 0;
+
+        CHECK(decoder.feed(bytes.data(), bytes.data() + 3,
+            [&records](variant&&) { ++records; })
+            == eggs::variants::decode_status::ok);
+        CHECK(records == 0u);
+        CHECK(decoder.pending() == 3u);
+
+        CHECK(decoder.feed(bytes.data() + 3, bytes.data() + 5,
+            [&records](variant&&) { ++records; })
+            == eggs::variants::decode_status::ok);
+        CHECK(records == 1u);
+        CHECK(decoder.pending() == 0u);
+    }
+
+    // malformed
+    {
+        unsigned char const malformed[] = {3, 0, 0, 0, 0};
+
+        eggs::variants::variant_decoder<int, std::string> decoder;
+        std::size_t records = 0;
+
+        CHECK(decoder.feed(malformed, malformed + sizeof(malformed),
+            [&records](variant&&) { ++records; })
+            == eggs::variants::decode_status::malformed);
+        CHECK(decoder.feed(bytes.data(), bytes.data() + bytes.size(),
+            [&records](variant&&) { ++records; })
+            == eggs::variants::decode_status::malformed);
+        CHECK(records == 0u);
+
+        decoder.reset();
+        CHECK(decoder.feed(bytes.data(), bytes.data() + bytes.size(),
+            [&records](variant&&) { ++records; })
+            == eggs::variants::decode_status::ok);
+        CHECK(records == 5u);
+    }
+}
+
+TEST_CASE("variant_decoder<Ts...>::feed_apply(unsigned char const*, unsigned char const*, F&&)", "[variant.serialization]")
+{
+    using variant = eggs::variant<int, std::string, Point>;
+
+    std::vector<unsigned char> bytes;
+    auto out = std::back_inserter(bytes);
+    out = eggs::variants::encode(variant(42), out);
+    out = eggs::variants::encode(variant(std::string("hello")), out);
+    out = eggs::variants::encode(variant(), out);
+    out = eggs::variants::encode(variant(Point(1, 2)), out);
+
+    for (std::size_t chunk = 1; chunk <= bytes.size(); ++chunk)
+    {
+        eggs::variants::variant_decoder<int, std::string, Point> decoder;
+        Collect collect;
+
+        for (std::size_t offset = 0; offset < bytes.size(); offset += chunk)
+        {
+            std::size_t const count = (std::min)(chunk, bytes.size() - offset);
+            CHECK(decoder.feed_apply(
+                bytes.data() + offset, bytes.data() + offset + count, collect)
+                == eggs::variants::decode_status::ok);
+        }
+
+        CHECK(decoder.pending() == 0u);
+        REQUIRE(collect.ints.size() == 2u);
+        CHECK(collect.ints[0] == 42);
+        CHECK(collect.ints[1] == 12);
+        REQUIRE(collect.strings.size() == 1u);
+        CHECK(collect.strings[0] == "hello");
+    }
+}
@@ -0,0 +1,152 @@
+// Eggs.Variant
+//
+// Copyright Agustin K-ballo Berge, Fusion Fenix 2014-2018
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <eggs/variant.hpp>
+#include <eggs/variant/spsc_variant_queue.hpp>
+#include <cstddef>
+#include <string>
+#include <thread>
+#include <utility>
+
+#include <eggs/variant/detail/config/prefix.hpp>
+
+#include "catch.hpp"
+
+struct Trade
+{
+    static std::size_t instances;
+    static std::size_t copies;
+
+    Trade(int price, int quantity) : price(price), quantity(quantity) { ++instances; }
+    Trade(Trade const& rhs) : price(rhs.price), quantity(rhs.quantity) { ++instances; ++copies; }
+    Trade(Trade&& rhs) : price(rhs.price), quantity(rhs.quantity) { ++instances; ++copies; }
+    ~Trade() { --instances; }
+
+    int price, quantity;
+};
+
+std::size_t Trade::instances = 0;
+std::size_t Trade::copies = 0;
+
+struct Quote
+{
+    int bid, ask;
+};
+
+struct Heartbeat {};
+
+struct Record
+{
+    void operator()(Trade& t) { total += t.price * t.quantity; }
+    void operator()(Quote& q) { total += q.ask - q.bid; }
+    void operator()(std::string& s) { total += int(s.size()); }
+    void operator()(Heartbeat&) { ++beats; }
+
+    int total;
+    int beats;
+};
+
+TEST_CASE("spsc_variant_queue<Ts...>::try_emplace(Args&&...)", "[spsc_variant_queue]")
+{
+    Trade::instances = 0;
+    Trade::copies = 0;
+    {
+        eggs::variants::spsc_variant_queue<Trade, Quote, Heartbeat> q(3);
+        CHECK(q.capacity() == 4u);
+        CHECK(q.empty());
+
+        CHECK(q.try_emplace<Trade>(10, 2));
+        CHECK(q.try_emplace<1>(Quote{1, 4}));
+        CHECK(q.try_emplace<Heartbeat>());
+        CHECK(q.try_emplace<Trade>(1, 1));
+        CHECK_FALSE(q.try_emplace<Heartbeat>());
+        CHECK_FALSE(q.empty());
+        CHECK(Trade::instances == 2u);
+
+        Record r = {0, 0};
+        CHECK(q.try_consume(r));
+        CHECK(r.total == 20);
+        CHECK(Trade::instances == 1u);
+
+        CHECK(q.try_consume(r));
+        CHECK(r.total == 23);
+        CHECK(q.try_consume(r));
+        CHECK(r.beats == 1);
+
+        // wraps around
+        CHECK(q.try_emplace<Quote>(Quote{0, 1}));
+        CHECK(q.try_consume(r));
+        CHECK(r.total == 24);
+        CHECK(q.try_consume(r));
+        CHECK(r.total == 25);
+        CHECK_FALSE(q.try_consume(r));
+        CHECK(q.empty());
+
+        // constructed in place, never copied nor moved
+        CHECK(Trade::copies == 0u);
+
+        // destroys remaining elements
+        CHECK(q.try_emplace<Trade>(1, 1));
+        CHECK(Trade::instances == 1u);
+    }
+    CHECK(Trade::instances == 0u);
+}
+
+TEST_CASE("spsc_variant_queue<Ts...>::try_consume(F&&)", "[spsc_variant_queue]")
+{
+    eggs::variants::spsc_variant_queue<int, std::string> q(8);
+
+    int const count = 100000;
+    std::thread producer([&q, count]
+    {
+        for (int i = 0; i < count; ++i)
+        {
+            if (i % 2 == 0)
+            {
+                while (!q.try_emplace<int>(i))
+                    std::this_thread::yield();
+            } else {
+                while (!q.try_emplace<std::string>(std::size_t(i % 7), 'x'))
+                    std::this_thread::yield();
+            }
+        }
+    });
+
+    long long ints = 0;
+    std::size_t chars = 0;
+    int consumed = 0;
+    struct Sum
+    {
+        void operator()(int& i) const { *ints += i; }
+        void operator()(std::string& s) const { *chars += s.size(); }
+
+        long long* ints;
+        std::size_t* chars;
+    } const sum = {&ints, &chars};
+
+    while (consumed < count)
+    {
+        if (q.try_consume(sum))
+            ++consumed;
+        else
+            std::this_thread::yield();
+    }
+    producer.join();
+
+    long long expected_ints = 0;
+    std::size_t expected_chars = 0;
+    for (int i = 0; i < count; ++i)
+    {
+        if (i % 2 == 0)
+            expected_ints += i;
+        else
+            expected_chars += std::size_t(i % 7);
+    }
+    CHECK(ints == expected_ints);
+    CHECK(chars == expected_chars);
+    CHECK(q.empty());
+}
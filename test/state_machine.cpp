@@ -0,0 +1,120 @@
+// Eggs.Variant
+//
+// Copyright Agustin K-ballo Berge, Fusion Fenix 2014-2018
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <eggs/variant.hpp>
+#include <eggs/variant/state_machine.hpp>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include <eggs/variant/detail/config/prefix.hpp>
+
+#include "catch.hpp"
+
+namespace
+{
+    struct Closed {};
+    struct Open
+    {
+        explicit Open(std::string peer) : peer(peer), received(0) {}
+
+        Open(Open const&) { ++copies; }
+        Open(Open&& rhs) : peer(std::move(rhs.peer)), received(rhs.received) { ++moves; }
+
+        std::string peer;
+        std::size_t received;
+
+        static int copies;
+        static int moves;
+    };
+    int Open::copies = 0;
+    int Open::moves = 0;
+
+    struct Connect { std::string peer; };
+    struct Data {};
+    struct Close {};
+
+    struct Protocol
+    {
+        eggs::variants::state_transition<Open, std::string const&>
+        operator()(Closed&, Connect const& e) const
+        {
+            return eggs::variants::transition_to<Open>(e.peer);
+        }
+
+        void operator()(Open& s, Data const&) const
+        {
+            ++s.received;
+        }
+
+        Closed operator()(Open&, Close const&) const
+        {
+            return Closed{};
+        }
+    };
+}
+
+using machine = eggs::variants::state_machine<
+    eggs::variant<Closed, Open>, eggs::variant<Connect, Data, Close>>;
+
+TEST_CASE("state_machine<variant<Ss...>, variant<Es...>>::dispatch(F&&, variant<Es...> const&)", "[state_machine]")
+{
+    machine sm(eggs::variants::in_place<Closed>);
+    Protocol const protocol{};
+
+    REQUIRE(sm.state().which() == 0u);
+    CHECK(sm.transition_count() == 0u);
+
+    CHECK_FALSE(sm.dispatch(protocol, machine::event_type(Data{})));
+    CHECK(sm.state().which() == 0u);
+
+    Open::copies = 0;
+    Open::moves = 0;
+    CHECK(sm.dispatch(protocol, machine::event_type(Connect{"peer"})));
+    REQUIRE(sm.state().which() == 1u);
+    CHECK(sm.state().target<Open>()->peer == "peer");
+    CHECK(Open::copies == 0);
+    CHECK(Open::moves == 0);
+
+    CHECK(sm.dispatch(protocol, machine::event_type(Data{})));
+    CHECK(sm.dispatch(protocol, machine::event_type(Data{})));
+    CHECK(sm.state().target<Open>()->received == 2u);
+
+    CHECK_FALSE(sm.dispatch(protocol, machine::event_type(Connect{"other"})));
+    CHECK_FALSE(sm.dispatch(protocol, machine::event_type()));
+
+    CHECK(sm.dispatch(protocol, machine::event_type(Close{})));
+    CHECK(sm.state().which() == 0u);
+
+    CHECK(sm.transition_count() == 2u);
+    CHECK(sm.transition_count(0, 1) == 1u);
+    CHECK(sm.transition_count(1, 0) == 1u);
+    CHECK(sm.transition_count(1, 1) == 0u);
+    CHECK(sm.transition_count(2, 0) == 0u);
+}
+
+TEST_CASE("state_machine<variant<Ss...>, variant<Es...>>::dispatch(F&&, InputIt, InputIt)", "[state_machine]")
+{
+    machine sm(eggs::variants::in_place<Closed>);
+
+    std::vector<machine::event_type> events;
+    events.push_back(Connect{"a"});
+    events.push_back(Data{});
+    events.push_back(Close{});
+    events.push_back(Close{});
+    events.push_back(Connect{"b"});
+
+    CHECK(sm.dispatch(Protocol{}, events.begin(), events.end()) == 4u);
+    REQUIRE(sm.state().which() == 1u);
+    CHECK(sm.state().target<Open>()->peer == "b");
+    CHECK(sm.transition_count(0, 1) == 2u);
+    CHECK(sm.transition_count(1, 0) == 1u);
+
+    sm.reset<Closed>();
+    CHECK(sm.state().which() == 0u);
+    CHECK(sm.transition_count() == 3u);
+}
@@ -0,0 +1,88 @@
+// Eggs.Variant
+//
+// Copyright Agustin K-ballo Berge, Fusion Fenix 2014-2018
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <eggs/variant.hpp>
+#include <eggs/variant/task_variant.hpp>
+#include <string>
+#include <type_traits>
+
+#include <eggs/variant/detail/config/prefix.hpp>
+
+#include "catch.hpp"
+
+namespace
+{
+    struct Increment
+    {
+        int* counter;
+        void operator()() { ++*counter; }
+    };
+
+    // larger than the small buffer of a typical type-erased function
+    struct Append
+    {
+        std::string* out;
+        char payload[64];
+        void operator()() { out->append(payload); }
+    };
+}
+
+using task = eggs::variants::task_variant<Increment, Append>;
+
+TEST_CASE("task_variant<Fs...>::task_variant()", "[task_variant]")
+{
+    task t;
+
+    CHECK_FALSE(bool(t));
+    CHECK(t.which() == task::npos);
+
+#if EGGS_CXX98_HAS_EXCEPTIONS
+    CHECK_THROWS_AS(t(), eggs::variants::bad_variant_access);
+#endif
+}
+
+TEST_CASE("task_variant<Fs...>::task_variant(F&&)", "[task_variant]")
+{
+    int counter = 0;
+    std::string out;
+    Append append = {&out, {}};
+    append.payload[0] = 'x';
+
+    // the callable is stored inline, as the active member of a variant
+    static_assert(sizeof(task) == sizeof(eggs::variant<Increment, Append>), "");
+    static_assert(std::is_nothrow_move_constructible<task>::value, "");
+
+    task t1 = Increment{&counter};
+    task t2 = append;
+    task t3(eggs::variants::in_place<Increment>, Increment{&counter});
+
+    CHECK(t1.which() == 0u);
+    CHECK(t2.which() == 1u);
+    CHECK(t3.which() == 0u);
+
+    t1();
+    t1();
+    t2();
+    t3();
+    CHECK(counter == 3);
+    CHECK(out == "x");
+}
+
+TEST_CASE("task_variant<Fs...>::reset()", "[task_variant]")
+{
+    int counter = 0;
+    task t1 = Increment{&counter};
+    task t2 = t1;
+
+    t1.reset();
+    CHECK_FALSE(bool(t1));
+
+    t1 = std::move(t2);
+    REQUIRE(bool(t1));
+    t1();
+    CHECK(counter == 1);
+}
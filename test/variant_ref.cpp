@@ -0,0 +1,136 @@
+// Eggs.Variant
+//
+// Copyright Agustin K-ballo Berge, Fusion Fenix 2014-2018
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <eggs/variant.hpp>
+#include <eggs/variant/boxed.hpp>
+#include <eggs/variant/variant_ref.hpp>
+#include <functional>
+#include <string>
+#include <type_traits>
+
+#include <eggs/variant/detail/config/prefix.hpp>
+
+#include "catch.hpp"
+
+using Ref = eggs::variants::variant_ref<int, std::string>;
+using ConstRef = eggs::variants::variant_ref<int const, std::string const>;
+
+struct Describe
+{
+    std::string operator()(int& i) const { return "int " + std::to_string(i); }
+    std::string operator()(std::string& s) const { return "string " + s; }
+};
+
+struct Grow
+{
+    void operator()(int& i) const { i += 1; }
+    void operator()(std::string& s) const { s += "!"; }
+};
+
+TEST_CASE("variant_ref<Ts...>", "[variant_ref]")
+{
+    static_assert(std::is_trivially_copyable<Ref>::value, "");
+    static_assert(!std::is_constructible<Ref, double&>::value, "");
+    static_assert(!std::is_constructible<Ref, int const&>::value, "");
+    static_assert(std::is_constructible<ConstRef, int&>::value, "");
+
+    Ref e;
+    CHECK_FALSE(bool(e));
+    CHECK(e.which() == Ref::npos);
+    CHECK(e.target() == nullptr);
+    CHECK_THROWS_AS(e.apply<std::string>(Describe{}), eggs::variants::bad_variant_access);
+
+    int i = 42;
+    std::string s = "text";
+
+    Ref ri = i;
+    REQUIRE(ri.which() == 0u);
+    CHECK(ri.target() == &i);
+    CHECK(ri.target<int>() == &i);
+    CHECK(ri.target<std::string>() == nullptr);
+    CHECK(&eggs::variants::get<0>(ri) == &i);
+    CHECK(&eggs::variants::get<int>(ri) == &i);
+    CHECK(eggs::variants::get_if<int>(&ri) == &i);
+    CHECK(eggs::variants::get_if<1>(&ri) == nullptr);
+    CHECK_THROWS_AS(eggs::variants::get<std::string>(ri), eggs::variants::bad_variant_access);
+    CHECK(ri.apply<std::string>(Describe{}) == "int 42");
+    CHECK(ri.apply(Describe{}) == "int 42");
+
+    // writes go through to the object referred to
+    ri.apply<void>(Grow{});
+    CHECK(i == 43);
+
+    Ref rs = s;
+    REQUIRE(rs.which() == 1u);
+    CHECK(rs.apply<std::string>(Describe{}) == "string text");
+
+    // assignment rebinds
+    Ref r = ri;
+    r = rs;
+    CHECK(r.target() == &s);
+    CHECK(i == 43);
+
+    ConstRef cr = s;
+    CHECK(cr.which() == 1u);
+    CHECK(cr.target<std::string const>() == &s);
+}
+
+TEST_CASE("variant_ref<Ts...> to a variant", "[variant_ref]")
+{
+    using Variant = eggs::variants::variant<int, std::string>;
+
+    Variant v(std::string("text"));
+    Ref r = v;
+    REQUIRE(r.which() == 1u);
+    CHECK(r.target() == v.target());
+
+    r.apply<void>(Grow{});
+    CHECK(eggs::variants::get<std::string>(v) == "text!");
+
+    Variant const& cv = v;
+    ConstRef cr = cv;
+    CHECK(cr.which() == 1u);
+    CHECK(cr.target() == v.target());
+    static_assert(!std::is_constructible<Ref, Variant const&>::value, "");
+
+    Variant ev;
+    Ref er = ev;
+    CHECK_FALSE(bool(er));
+
+    // boxed alternatives are referred to as their value
+    using Boxed = eggs::variants::variant<int, eggs::variants::boxed<std::string>>;
+    Boxed b(std::string("boxed"));
+    Ref rb = b;
+    REQUIRE(rb.which() == 1u);
+    CHECK(&eggs::variants::get<std::string>(rb) == &eggs::variants::get<1>(b));
+}
+
+TEST_CASE("variant_ref<Ts...> relational operators", "[variant_ref]")
+{
+    int i1 = 1, i2 = 2, j1 = 1;
+    std::string s = "a";
+
+    Ref r1 = i1, r2 = i2, rj = j1, rs = s, e;
+
+    // compares the values referred to, not the addresses
+    CHECK(r1 == rj);
+    CHECK(r1 != r2);
+    CHECK(r1 != rs);
+    CHECK(e == Ref());
+    CHECK(e != r1);
+
+    CHECK(r1 < r2);
+    CHECK(r2 > r1);
+    CHECK(r1 <= rj);
+    CHECK(r1 >= rj);
+    CHECK(r2 < rs);
+    CHECK(e < r1);
+    CHECK_FALSE(r1 < e);
+
+    CHECK(std::hash<Ref>()(r1) == std::hash<int>()(1));
+    CHECK(std::hash<Ref>()(rs) == std::hash<std::string>()("a"));
+}
@@ -0,0 +1,146 @@
+// Eggs.Variant
+//
+// Copyright Agustin K-ballo Berge, Fusion Fenix 2014-2018
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <eggs/variant.hpp>
+#include <eggs/variant/versioned_variant.hpp>
+#include <atomic>
+#include <cstddef>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <eggs/variant/detail/config/prefix.hpp>
+
+#include "catch.hpp"
+
+struct StaticRoutes
+{
+    std::map<std::string, std::string> routes;
+};
+
+struct Weighted
+{
+    std::vector<std::string> backends;
+};
+
+using routing = eggs::variant<StaticRoutes, Weighted>;
+
+struct Size
+{
+    std::size_t operator()(StaticRoutes const& r) const { return r.routes.size(); }
+    std::size_t operator()(Weighted const& w) const { return w.backends.size(); }
+};
+
+// every backend of a published value has the same name
+struct Consistent
+{
+    bool operator()(StaticRoutes const&) const { return true; }
+    bool operator()(Weighted const& w) const
+    {
+        for (std::size_t i = 1; i < w.backends.size(); ++i)
+        {
+            if (w.backends[i] != w.backends[0])
+                return false;
+        }
+        return true;
+    }
+};
+
+static Weighted make_weighted(std::size_t count, std::string const& name)
+{
+    Weighted w;
+    w.backends.assign(count, name);
+    return w;
+}
+
+TEST_CASE("versioned_variant<Ts...>::store(variant<Ts...>)", "[versioned_variant]")
+{
+    eggs::variants::versioned_variant<StaticRoutes, Weighted> vv;
+    CHECK(vv.load().which() == eggs::variant_npos);
+    CHECK(vv.version() == 0u);
+
+    StaticRoutes r;
+    r.routes["/"] = "index";
+    vv.store(r);
+    CHECK(vv.version() == 1u);
+    CHECK(vv.apply(Size{}) == 1u);
+
+    vv.emplace<Weighted>(make_weighted(3, "a"));
+    CHECK(vv.version() == 2u);
+    CHECK(vv.apply(Size{}) == 3u);
+    CHECK(vv.apply<int>(Size{}) == 3);
+
+    routing const v = vv.load();
+    REQUIRE(v.which() == 1u);
+    CHECK(v.target<Weighted>()->backends[2] == "a");
+
+#if EGGS_CXX98_HAS_EXCEPTIONS
+    eggs::variants::versioned_variant<StaticRoutes, Weighted> empty;
+    CHECK_THROWS_AS(empty.apply(Size{}), eggs::variants::bad_variant_access);
+#endif
+}
+
+TEST_CASE("versioned_variant<Ts...>::update(F&&)", "[versioned_variant]")
+{
+    eggs::variants::versioned_variant<StaticRoutes, Weighted> vv(
+        routing(make_weighted(1, "a")));
+
+    vv.update([](routing const& v) -> routing
+    {
+        Weighted w = *v.target<Weighted>();
+        w.backends.push_back("a");
+        return w;
+    });
+
+    CHECK(vv.version() == 1u);
+    CHECK(vv.apply(Size{}) == 2u);
+}
+
+TEST_CASE("versioned_variant<Ts...> concurrent readers and writers", "[versioned_variant]")
+{
+    eggs::variants::versioned_variant<StaticRoutes, Weighted> vv(
+        routing(make_weighted(8, "initial")));
+
+    std::atomic<bool> done(false);
+    std::atomic<std::size_t> inconsistent(0);
+
+    std::vector<std::thread> readers;
+    for (std::size_t t = 0; t < 3; ++t)
+    {
+        readers.emplace_back([&]
+        {
+            while (!done.load())
+            {
+                if (!vv.apply(Consistent{}))
+                    ++inconsistent;
+            }
+        });
+    }
+
+    std::vector<std::thread> writers;
+    for (std::size_t t = 0; t < 2; ++t)
+    {
+        writers.emplace_back([&vv, t]
+        {
+            for (std::size_t i = 0; i < 500; ++i)
+            {
+                vv.store(routing(make_weighted(
+                    8 + i % 4, std::to_string(t * 1000 + i))));
+            }
+        });
+    }
+
+    for (std::size_t t = 0; t < writers.size(); ++t)
+        writers[t].join();
+    done = true;
+    for (std::size_t t = 0; t < readers.size(); ++t)
+        readers[t].join();
+
+    CHECK(inconsistent.load() == 0u);
+    CHECK(vv.version() == 1000u);
+}
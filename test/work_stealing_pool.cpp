@@ -0,0 +1,81 @@
+// Eggs.Variant
+//
+// Copyright Agustin K-ballo Berge, Fusion Fenix 2014-2018
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <eggs/variant.hpp>
+#include <eggs/variant/task_variant.hpp>
+#include <eggs/variant/work_stealing_pool.hpp>
+#include <atomic>
+#include <cstddef>
+
+#include <eggs/variant/detail/config/prefix.hpp>
+
+#include "catch.hpp"
+
+namespace
+{
+    struct Add
+    {
+        std::atomic<int>* sum;
+        int value;
+        void operator()() const { sum->fetch_add(value); }
+    };
+
+    struct Spawn;
+    using task = eggs::variants::task_variant<Add, Spawn>;
+    using pool = eggs::variants::work_stealing_pool<task>;
+
+    struct Spawn
+    {
+        pool* owner;
+        std::atomic<int>* sum;
+        int depth;
+        void operator()() const
+        {
+            sum->fetch_add(1);
+            if (depth > 0)
+            {
+                owner->submit(Spawn{owner, sum, depth - 1});
+                owner->submit(Spawn{owner, sum, depth - 1});
+            }
+        }
+    };
+}
+
+TEST_CASE("work_stealing_pool<Task>::submit(Task)", "[work_stealing_pool]")
+{
+    std::atomic<int> sum(0);
+    pool p(4);
+    CHECK(p.size() == 4u);
+
+    for (int i = 1; i <= 1000; ++i)
+        p.submit(Add{&sum, i});
+    p.wait();
+    CHECK(sum.load() == 500500);
+
+    // tasks submitted by tasks are queued on their worker and stolen by
+    // the others
+    sum = 0;
+    p.submit(Spawn{&p, &sum, 10});
+    p.wait();
+    CHECK(sum.load() == (1 << 11) - 1);
+}
+
+TEST_CASE("work_stealing_pool<Task>::~work_stealing_pool()", "[work_stealing_pool]")
+{
+    std::atomic<int> sum(0);
+    {
+        pool p(2);
+        for (int i = 0; i < 100; ++i)
+            p.submit(Add{&sum, 1});
+    }
+    CHECK(sum.load() == 100);
+
+    {
+        pool p(0);
+        CHECK(p.size() == 1u);
+    }
+}